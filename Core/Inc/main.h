@@ -53,6 +53,7 @@ extern "C" {
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+void PendSV_Callback(void);
 
 /* USER CODE END EFP */
 
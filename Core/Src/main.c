@@ -22,6 +22,19 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "event_handler.hpp"
+#if defined(TKRANDOM_GATE_BENCH)
+#include "gate_replay.hpp"
+#endif
+#if defined(TKRANDOM_MICRO_BENCH)
+#include "micro_bench.hpp"
+#endif
+#include "coroutine.hpp"
+#include "cv_inputs.hpp"
+#include "power_manager.hpp"
+#include "settings_journal.hpp"
+#include "settings_manager.hpp"
+#include "supervisor.hpp"
+#include "trace_log.hpp"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -42,20 +55,71 @@
 RNG_HandleTypeDef hrng;
 
 SPI_HandleTypeDef hspi1;
+DMA_HandleTypeDef hdma_spi1_tx;
 
 TIM_HandleTypeDef htim6;
+TIM_HandleTypeDef htim15;
+TIM_HandleTypeDef htim16;
 
 /* USER CODE BEGIN PV */
+// static composition root: every object is constant-initialized at link time,
+// constructors only wire references and do not touch any peripheral
+constinit tkrandom::PcbStatusLed pcb_status_led;
+//! transmitter is global in order to be called by SPI DMA callbacks
+constinit tkrandom::Transmitter transmitter(&hspi1);
+constinit tkrandom::Generator generator(&hrng);
+constinit tkrandom::LedRefresher led_refresher(transmitter);
+//! CV inputs are global in order to be smoothed by the 1 kHz timer
+constinit tkrandom::CvInputs cv_inputs;
+constinit tkrandom::RngHandler rng_handler(generator, transmitter,
+                                           led_refresher, cv_inputs);
+//! noise handler is global in order to be called by the sample timer
+constinit tkrandom::NoiseHandler noise_handler(generator, transmitter, &htim15);
+constinit tkrandom::Animation animation(led_refresher);
+constinit tkrandom::SwitchDebouncer switch_debouncer;
+constinit tkrandom::Scheduler scheduler;
+//! supervisor is global in order to be called by Error_Handler() at any time
+constinit tkrandom::Supervisor supervisor(transmitter, generator,
+                                          pcb_status_led);
 //! event handler is global in order to be called by interrupt routines
-tkrandom::EventHandler* event_handler = nullptr;
+constinit tkrandom::EventHandler event_handler(supervisor,
+                                               rng_handler,
+                                               animation,
+                                               noise_handler,
+                                               switch_debouncer,
+                                               scheduler,
+                                               &htim16);
+//! power manager switches between the clock profiles at runtime
+constinit tkrandom::PowerManager power_manager(transmitter, &htim6, &htim15,
+                                               &htim16);
+//! settings journal is global in order to be called by the flash interrupt
+constinit tkrandom::SettingsJournal settings_journal;
+//! settings manager is global in order to receive commands by the debugger
+constinit tkrandom::SettingsManager settings_manager(settings_journal,
+                                                    event_handler, rng_handler,
+                                                    generator, power_manager,
+                                                    noise_handler);
+//! coroutine executor is global in order to be signaled by interrupt routines
+constinit tkrandom::CoroutineExecutor coroutine_executor(generator);
+#if defined(TKRANDOM_GATE_BENCH)
+//! replays the reference gate scenarios, results are read by the debugger
+constinit tkrandom::GateReplay gate_replay(event_handler);
+#endif
+#if defined(TKRANDOM_MICRO_BENCH)
+//! JSON results of the microbenchmarks, read by the debugger
+char micro_bench_json[1024];
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_RNG_Init(void);
 static void MX_SPI1_Init(void);
 static void MX_TIM6_Init(void);
+static void MX_TIM15_Init(void);
+static void MX_TIM16_Init(void);
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -72,6 +136,7 @@ static void MX_TIM6_Init(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+  tkrandom::TraceLog::Init();  // validates the retained ring before any log
 
   /* USER CODE END 1 */
 
@@ -93,53 +158,55 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_RNG_Init();
   MX_SPI1_Init();
   MX_TIM6_Init();
+  MX_TIM15_Init();
+  MX_TIM16_Init();
   /* USER CODE BEGIN 2 */
-  tkrandom::PcbStatusLed* const pcb_status_led =
-      new tkrandom::PcbStatusLed(GPIOB, GPIO_PIN_0);
-  tkrandom::Transmitter* const transmitter =
-      new tkrandom::Transmitter(&hspi1, GPIOA, GPIO_PIN_4, GPIOA, GPIO_PIN_6);
-  tkrandom::Generator* const generator =
-      new tkrandom::Generator(&hrng);
-  tkrandom::RngHandler* const rng_handler =
-      new tkrandom::RngHandler(*generator, *transmitter);
-  tkrandom::DistributionPins* const distribution_pins =
-      new tkrandom::DistributionPins();
-  if ((pcb_status_led == nullptr) ||
-      (generator == nullptr) ||
-      (rng_handler == nullptr) ||
-      (transmitter == nullptr) ||
-      (distribution_pins == nullptr)) {
-    return -1;
-  }
-  distribution_pins->gpio_port_distribution_1 = GPIOB;
-  distribution_pins->pin_distribution_1 = GPIO_PIN_4;
-  distribution_pins->gpio_port_distribution_2 = GPIOB;
-  distribution_pins->pin_distribution_2 = GPIO_PIN_5;
-  distribution_pins->gpio_port_distribution_3 = GPIOB;
-  distribution_pins->pin_distribution_3 = GPIO_PIN_6;
-  distribution_pins->gpio_port_distribution_4 = GPIOB;
-  distribution_pins->pin_distribution_4 = GPIO_PIN_7;
-  tkrandom::Animation* const animation = new tkrandom::Animation(*transmitter);
-  event_handler = new tkrandom::EventHandler(*pcb_status_led,
-                                             *rng_handler,
-                                             *animation,
-                                             *distribution_pins);
-  if ((event_handler != nullptr) && (animation != nullptr)) {
-    event_handler->Init();
+#if defined(TKRANDOM_MICRO_BENCH)
+  // ahead of the timers and the DMA queue, DWT cycles per call
+  tkrandom::CycleCounter::Enable();
+  tkrandom::MicroBench micro_bench(transmitter, generator, rng_handler,
+                                   &tkrandom::CycleCounter::Now,
+                                   HAL_RCC_GetHCLKFreq());
+  micro_bench.Run(1000U);
+  micro_bench.WriteJson(micro_bench_json, sizeof(micro_bench_json));
+#endif
+  // the seed selects the random source ahead of the first buffer fill
+  settings_journal.Init();
+  settings_manager.ApplySeed();
+  event_handler.Init();
+  settings_manager.ApplySettings();
+  if (coroutine_executor.Spawn(pcb_status_led.Run(coroutine_executor)) !=
+      tkrandom::CoroutineStatus::kSuccess) {
+    Error_Handler();
   }
-  else {
-    return -1;
+#if defined(TKRANDOM_CV_INPUTS)
+  // hardware with CV jacks on PA0 .. PA3, the parameters stay neutral without
+  if (cv_inputs.Start() != tkrandom::CvInputsStatus::kSuccess) {
+    Error_Handler();
   }
+#endif
+#if defined(TKRANDOM_GATE_BENCH)
+  gate_replay.Start(2000U, 1000U, HAL_RCC_GetHCLKFreq());
+#endif
+  // the IWDG runs from here on, fed while the main loop passes
+  supervisor.Init();
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    event_handler->Run();
+    supervisor.Process();
+    event_handler.Run();
+    coroutine_executor.RunReady();
+    settings_manager.Process();
+#if defined(TKRANDOM_GATE_BENCH)
+    gate_replay.Process();
+#endif
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -273,9 +340,9 @@ static void MX_TIM6_Init(void)
 
   /* USER CODE END TIM6_Init 1 */
   htim6.Instance = TIM6;
-  htim6.Init.Prescaler = 500;
+  htim6.Init.Prescaler = 47;
   htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim6.Init.Period = 6000;
+  htim6.Init.Period = 999;
   htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
   if (HAL_TIM_Base_Init(&htim6) != HAL_OK)
   {
@@ -289,13 +356,107 @@ static void MX_TIM6_Init(void)
   }
   /* USER CODE BEGIN TIM6_Init 2 */
   HAL_TIM_GenerateEvent(&htim6, TIM_EVENTSOURCE_UPDATE);
-  HAL_NVIC_SetPriority(TIM6_IRQn, 0, 0);
+  HAL_NVIC_SetPriority(TIM6_IRQn, 4, 0);
   HAL_NVIC_EnableIRQ(TIM6_IRQn);
   HAL_TIM_Base_Start_IT(&htim6);
   /* USER CODE END TIM6_Init 2 */
 
 }
 
+/**
+  * @brief TIM15 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_TIM15_Init(void)
+{
+
+  /* USER CODE BEGIN TIM15_Init 0 */
+
+  /* USER CODE END TIM15_Init 0 */
+
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+  /* USER CODE BEGIN TIM15_Init 1 */
+  // sample timer of the noise output: 48 MHz / 1000 = 48 kHz
+  /* USER CODE END TIM15_Init 1 */
+  htim15.Instance = TIM15;
+  htim15.Init.Prescaler = 0;
+  htim15.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim15.Init.Period = 999;
+  htim15.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim15.Init.RepetitionCounter = 0;
+  htim15.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(&htim15) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim15, &sClockSourceConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim15, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM15_Init 2 */
+  // started by NoiseHandler::Start()
+  /* USER CODE END TIM15_Init 2 */
+
+}
+
+/**
+  * @brief TIM16 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_TIM16_Init(void)
+{
+
+  /* USER CODE BEGIN TIM16_Init 0 */
+
+  /* USER CODE END TIM16_Init 0 */
+
+  /* USER CODE BEGIN TIM16_Init 1 */
+  // track timer: 48 MHz / 48 = 1 MHz counter clock, 1 MHz / 500 = 2 kHz
+  /* USER CODE END TIM16_Init 1 */
+  htim16.Instance = TIM16;
+  htim16.Init.Prescaler = 47;
+  htim16.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim16.Init.Period = 499;
+  htim16.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim16.Init.RepetitionCounter = 0;
+  htim16.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(&htim16) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM16_Init 2 */
+  // started by EventHandler while a gate is tracking
+  /* USER CODE END TIM16_Init 2 */
+
+}
+
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel3_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 2, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -338,19 +499,19 @@ static void MX_GPIO_Init(void)
 
   /*Configure GPIO pin : PB1 */
   GPIO_InitStruct.Pin = GPIO_PIN_1;
-  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
   /*Configure GPIO pin : PA10 */
   GPIO_InitStruct.Pin = GPIO_PIN_10;
-  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
   /*Configure GPIO pins : PB4 PB5 PB6 PB7 */
   GPIO_InitStruct.Pin = GPIO_PIN_4|GPIO_PIN_5|GPIO_PIN_6|GPIO_PIN_7;
-  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
   GPIO_InitStruct.Pull = GPIO_PULLDOWN;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
@@ -358,38 +519,80 @@ static void MX_GPIO_Init(void)
   HAL_NVIC_SetPriority(EXTI1_IRQn, 0, 0);
   HAL_NVIC_EnableIRQ(EXTI1_IRQn);
 
-  HAL_NVIC_SetPriority(EXTI4_IRQn, 0, 0);
-  HAL_NVIC_EnableIRQ(EXTI4_IRQn);
-
-  HAL_NVIC_SetPriority(EXTI9_5_IRQn, 0, 0);
-  HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
-
   HAL_NVIC_SetPriority(EXTI15_10_IRQn, 0, 0);
   HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
 
 }
 
 /* USER CODE BEGIN 4 */
+//! gate-to-DAC work, lowest interrupt priority, preempts the main loop
+void PendSV_Callback(void) {
+  event_handler.ProcessGates();
+}
+
+void HAL_FLASH_EndOfOperationCallback(uint32_t return_value) {
+  (void)return_value;
+  settings_journal.ProcessOperationComplete();
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t return_value) {
+  (void)return_value;
+  tkrandom::TraceLog::Log(tkrandom::TraceEvent::kFlashError,
+                          HAL_FLASH_GetError());
+  settings_journal.ProcessOperationError();
+}
+
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
-  event_handler->SignalEvent(tkrandom::Event::kTimerElapsed);
+  if (htim->Instance == TIM6) {
+    event_handler.SignalEvent(tkrandom::Event::kTimerElapsed);
+    coroutine_executor.ProcessTick();
+    cv_inputs.ProcessTick();
+    supervisor.ProcessTick();
+  }
+  // sample timer of the noise output
+  if (htim->Instance == TIM15) {
+    noise_handler.ProcessSampleTick();
+  }
+  // track timer of the track-and-hold mode
+  if (htim->Instance == TIM16) {
+    event_handler.SignalEvent(tkrandom::Event::kTrackTick);
+  }
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+  if (hspi->Instance == SPI1) {
+    transmitter.ProcessTransferComplete();
+    coroutine_executor.Signal(tkrandom::CoroutineEvent::kTransferComplete);
+  }
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
+  if (hspi->Instance == SPI1) {
+    transmitter.ProcessTransferError();
+    supervisor.ReportFault(tkrandom::Fault::kTransfer);
+  }
 }
 
 void HAL_GPIO_EXTI_Callback(uint16_t gpio_pin) {
-  // EXTI line for IN_1
-  if (gpio_pin == GPIO_PIN_1) {
-    event_handler->SignalEvent(tkrandom::Event::kGate1Triggered);
+  // EXTI line for IN_1, inverted input stage: low pin level is an open gate
+  if (gpio_pin == tkrandom::board::Gate1::kMask) {
+    if (!tkrandom::board::Gate1::IsSet()) {
+      event_handler.SignalEvent(tkrandom::Event::kGate1Triggered);
+      coroutine_executor.Signal(tkrandom::CoroutineEvent::kGate1Opened);
+    }
+    else {
+      event_handler.SignalEvent(tkrandom::Event::kGate1Released);
+    }
   }
   // EXTI line for IN_2
-  if (gpio_pin == GPIO_PIN_10) {
-    event_handler->SignalEvent(tkrandom::Event::kGate2Triggered);
-  }
-  // EXTI lines for distribution switches (PB4, PB5, PB6, PB7)
-  // hint: only one collective EXTI line for pin 5, 6 and 7
-  if ((gpio_pin == GPIO_PIN_4) ||
-      (gpio_pin == GPIO_PIN_5) ||
-      (gpio_pin == GPIO_PIN_6) ||
-      (gpio_pin == GPIO_PIN_7)) {
-    event_handler->SignalEvent(tkrandom::Event::kDistributionChanged);
+  if (gpio_pin == tkrandom::board::Gate2::kMask) {
+    if (!tkrandom::board::Gate2::IsSet()) {
+      event_handler.SignalEvent(tkrandom::Event::kGate2Triggered);
+      coroutine_executor.Signal(tkrandom::CoroutineEvent::kGate2Opened);
+    }
+    else {
+      event_handler.SignalEvent(tkrandom::Event::kGate2Released);
+    }
   }
 }
 /* USER CODE END 4 */
@@ -402,7 +605,11 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
-  event_handler->SignalEvent(tkrandom::Event::kErrorOccurred);
+  // constant-initialized, safe before main() reaches the main loop as well.
+  // A peripheral that did not start is not recovered, the IWDG resets the MCU
+  // after supervisor.Init(), later faults of the HAL are recovered.
+  supervisor.ReportFault(supervisor.IsStarted() ? tkrandom::Fault::kGeneral
+                                                : tkrandom::Fault::kFatal);
   /* USER CODE END Error_Handler_Debug */
 }
 
@@ -81,6 +81,47 @@ LoopCopyDataInit:
   cmp r4, r1
   bcc CopyDataInit
   
+/* Copy the vector table from flash to RAM2 */
+  ldr r0, =_sram2_vector
+  ldr r1, =_eram2_vector
+  ldr r2, =g_pfnVectors
+  movs r3, #0
+  b LoopCopyVectorInit
+
+CopyVectorInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyVectorInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyVectorInit
+
+/* Copy the time-critical code from flash to RAM2 */
+  ldr r0, =_sram2_text
+  ldr r1, =_eram2_text
+  ldr r2, =_siram2_text
+  movs r3, #0
+  b LoopCopyRam2TextInit
+
+CopyRam2TextInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyRam2TextInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyRam2TextInit
+
+/* Relocate the vector table to RAM2 (SCB->VTOR) */
+  ldr r0, =0xE000ED08
+  ldr r1, =_sram2_vector
+  str r1, [r0]
+  dsb
+  isb
+
 /* Zero fill the bss segment. */
   ldr r2, =_sbss
   ldr r4, =_ebss
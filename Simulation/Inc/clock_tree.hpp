@@ -0,0 +1,99 @@
+//! \brief     Class declaration of the simulated clock tree and regulator.
+//! \details   MSI, PLL, system clock switch, flash latency and voltage scaling
+//!            of the STM32L412 as far as the firmware configures them.
+//! \file      clock_tree.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef CLOCK_TREE_HPP_
+#define CLOCK_TREE_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+
+namespace tkrandom {
+namespace sim {
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! ClockTree class declaration
+//! \details static only like Mcu. The HAL RCC and PWR functions are checked
+//!          against the limits of the reference manual instead of being
+//!          trusted, so that a configuration the real MCU would not run with
+//!          fails here: PLL input 4 .. 16 MHz, VCO 64 .. 344 MHz, PLLR output
+//!          and HCLK up to 80 MHz in voltage scale 1 and 26 MHz in scale 2,
+//!          flash wait states as in the reference manual. Only the undivided
+//!          AHB and APB clocks that the firmware uses are modeled.
+class ClockTree {
+ public:
+  //! no instances, all members are static
+  ClockTree(void) = delete;
+
+  //! resets to the state left by SystemClock_Config() in main.c
+  //! \details 48 MHz MSI as system clock, voltage scale 1, 2 wait states
+  static void Init(void);
+
+  //! getter for the AHB clock, equal to both APB clocks
+  //! \return HCLK frequency in Hz
+  static uint32_t GetHclk(void);
+
+  //! getter for the MSI clock, also the kernel clock of the RNG
+  //! \return MSI frequency in Hz
+  static uint32_t GetMsiClock(void);
+
+  //! HAL_PWREx_ControlVoltageScaling()
+  static HAL_StatusTypeDef SetVoltageScaling(const uint32_t voltage_scaling);
+
+  //! HAL_RCC_OscConfig(), MSI and PLL only
+  static HAL_StatusTypeDef ConfigureOscillators(
+      const RCC_OscInitTypeDef* const osc_init);
+
+  //! HAL_RCC_ClockConfig(), undivided bus clocks only
+  static HAL_StatusTypeDef ConfigureClocks(
+      const RCC_ClkInitTypeDef* const clk_init, const uint32_t flash_latency);
+
+ private:
+  //! frequency of the PLLR output, 0 if the PLL is off
+  static uint32_t GetPllClock(void);
+
+  //! highest system clock of the voltage scale
+  static uint32_t GetMaxClock(void);
+
+  //! fewest flash wait states for a clock in the current voltage scale
+  static uint32_t GetMinLatency(const uint32_t clock);
+
+  //! MSI frequencies of the ranges 0 .. 11 in Hz
+  static const uint32_t kMsiClocks_[12];
+
+  //! MSI range index 0 .. 11
+  static uint32_t msi_range_;
+
+  //! PLL enabled
+  static bool is_pll_on_;
+
+  //! PLL input divider
+  static uint32_t pll_m_;
+
+  //! PLL VCO multiplier
+  static uint32_t pll_n_;
+
+  //! PLLR output divider
+  static uint32_t pll_r_;
+
+  //! RCC_SYSCLKSOURCE_x of the system clock switch
+  static uint32_t sysclk_source_;
+
+  //! flash wait states
+  static uint32_t flash_latency_;
+
+  //! PWR_REGULATOR_VOLTAGE_SCALEx
+  static uint32_t voltage_scaling_;
+};
+
+}  // namespace sim
+}  // namespace tkrandom
+
+#endif  // CLOCK_TREE_HPP_
@@ -0,0 +1,69 @@
+//! \brief     Composition root of the firmware on the simulated MCU.
+//! \details   Mirrors the objects, peripheral initialization and callbacks of
+//!            Core/Src/main.c.
+//! \file      firmware.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef FIRMWARE_HPP_
+#define FIRMWARE_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "event_handler.hpp"
+#include "mcu.hpp"
+#include "power_manager.hpp"
+#include "settings_manager.hpp"
+
+// GLOBAL VARIABLES ------------------------------------------------------------
+//! HAL handles as generated by CubeMX in main.c
+extern RNG_HandleTypeDef hrng;
+extern SPI_HandleTypeDef hspi1;
+extern TIM_HandleTypeDef htim6;
+extern TIM_HandleTypeDef htim15;
+extern TIM_HandleTypeDef htim16;
+
+namespace tkrandom {
+namespace sim {
+
+//! firmware objects, wired like the static composition root in main.c
+extern PcbStatusLed pcb_status_led;
+extern Transmitter transmitter;
+extern Generator generator;
+extern LedRefresher led_refresher;
+extern CvInputs cv_inputs;
+extern RngHandler rng_handler;
+extern NoiseHandler noise_handler;
+extern Animation animation;
+extern SwitchDebouncer switch_debouncer;
+extern Scheduler scheduler;
+extern Supervisor supervisor;
+extern EventHandler event_handler;
+extern PowerManager power_manager;
+extern SettingsJournal settings_journal;
+extern SettingsManager settings_manager;
+extern CoroutineExecutor coroutine_executor;
+
+// FUNCTION DECLARATIONS -------------------------------------------------------
+//! powers up: resets the MCU, reconstructs the firmware objects and runs
+//! main() up to the main loop
+//! \details the settings journal in the simulated flash survives, so settings
+//!          written before are applied again
+//! \param[in] random_seed seed of the deterministic mode, overrides the seed
+//!            read from the settings journal unless it is 0
+void InitFirmware(const uint16_t random_seed = 0U);
+
+//! runs the main loop until a cycle is reached
+//! \param[in] limit core cycle at which the loop returns
+void RunFirmware(const uint64_t limit);
+
+//! cycles of one main loop pass besides the charged HAL calls
+const uint32_t kMainLoopCycles = 40U;
+
+}  // namespace sim
+}  // namespace tkrandom
+
+#endif  // FIRMWARE_HPP_
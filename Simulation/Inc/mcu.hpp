@@ -0,0 +1,419 @@
+//! \brief     Class declaration of the simulated STM32L412 core and peripherals.
+//! \details   Cycle clock, NVIC with the priority tiers of the firmware,
+//!            timers, EXTI, SPI with DMA, RNG, the GPIO ports and the flash
+//!            pages of the settings journal.
+//! \file      mcu.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef MCU_HPP_
+#define MCU_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <deque>
+
+#include "stm32l4xx_hal.h"
+#include "rng_source.hpp"
+#include "virtual_dac.hpp"
+
+//! gate work of the firmware, called when the simulated PendSV is taken
+void PendSV_Callback(void);
+
+namespace tkrandom {
+namespace sim {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! CPU cycles charged by the simulated hardware and HAL calls
+//! \details the firmware itself runs at host speed, so simulated time only
+//!          advances by these costs and by Mcu::Charge() calls of the driver
+struct CostModel {
+  uint32_t interrupt_entry = 12U;   //!< exception entry with stacking
+  uint32_t interrupt_exit = 10U;    //!< exception return
+  uint32_t hal_call = 120U;         //!< overhead of a blocking HAL driver call
+  uint32_t dma_start = 180U;        //!< HAL_SPI_Transmit_DMA() set-up
+  uint32_t register_access = 2U;    //!< peripheral register access
+  uint32_t rng_word = 42U;          //!< RNG clocks until the next word is ready
+  uint32_t flash_program = 3936U;   //!< double word programming, 82 us
+  uint32_t flash_erase = 1056000U;  //!< page erase, 22 ms
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! Mcu class declaration
+//! \details static only since it models the one MCU the firmware runs on.
+//!          Interrupts are taken at the points where simulated time advances,
+//!          with the preemption priorities of InterruptTiers and the masks
+//!          set by PRIMASK and BASEPRI.
+class Mcu {
+ public:
+  //! no instances, all members are static
+  Mcu(void) = delete;
+
+  //! core clock in Hz of the standard profile
+  //! \details simulated time is counted in cycles of this clock in every
+  //!          profile, timers and SPI follow the HCLK of ClockTree, the cost
+  //!          model does not
+  static const uint32_t kCoreClock = 48000000U;
+
+  //! maps the GPIO ports to their device addresses, resets all state
+  //! \details gate inputs idle high (closed gates), all other pins low. The
+  //!          journal pages keep their content like the flash of a real MCU
+  //!          over a power cycle, a running flash operation is lost.
+  static void Init(void);
+
+  //! erases the journal pages, like a new device
+  static void EraseFlash(void);
+
+  //! lets flash operations fail with PROGERR
+  //! \details a failed erase leaves the page unchanged, a failed program
+  //!          leaves a torn double word with the lower word only
+  //! \param[in] period every period-th operation fails, 0 for none
+  static void SetFlashFailures(const uint32_t period);
+
+  //! getter for the simulated time
+  //! \return core cycles since Init()
+  static uint64_t GetCycles(void);
+
+  //! converts microseconds to core cycles
+  //! \param[in] microseconds time in us
+  //! \return core cycles
+  static uint64_t ToCycles(const uint64_t microseconds);
+
+  //! executes the running context for a number of cycles
+  //! \details interrupts that become due and are not masked preempt it
+  //! \param[in] cycles cycles the running context needs
+  static void Charge(const uint32_t cycles);
+
+  //! sleeps until the next event, like WFI in thread mode
+  //! \param[in] limit cycle at which the sleep ends at the latest
+  static void WaitForInterrupt(const uint64_t limit);
+
+  //! schedules a level change of an input pin
+  //! \details edges of EXTI pins set the pending flag of their line, several
+  //!          edges before the interrupt is taken merge into one
+  //! \param[in] cycle core cycle of the edge, earlier than now means now
+  //! \param[in] port GPIO port of the pin
+  //! \param[in] pin GPIO_PIN_x mask of the pin
+  //! \param[in] is_high new pin level
+  static void ScheduleInput(const uint64_t cycle, GPIO_TypeDef* const port,
+                            const uint16_t pin, const bool is_high);
+
+  //! enables the EXTI lines of pins, both edges
+  //! \param[in] pins ORed GPIO_PIN_x masks
+  static void EnableExti(const uint16_t pins);
+
+  //! getter for the update events of a timer since Init()
+  //! \param[in] instance timer register block, e.g. TIM6
+  //! \return number of update interrupts taken
+  static uint64_t GetTimerUpdates(const TIM_TypeDef* const instance);
+
+  //! getter for the virtual DAC on SPI1
+  //! \return DAC reference
+  static VirtualDac& GetDac(void);
+
+  //! stops the SPI from shifting, like a stuck peripheral
+  //! \details bytes written to the TX FIFO stay there with BSY set until
+  //!          HAL_SPI_Abort() resets the SPI
+  //! \param[in] is_stalled true to stop the SPI
+  static void SetSpiStall(const bool is_stalled);
+
+  //! getter for the entropy source of the RNG
+  //! \return RNG source reference
+  static RngSource& GetRngSource(void);
+
+  //! getter for the cost model, may be changed at any time
+  //! \return cost model reference
+  static CostModel& GetCostModel(void);
+
+  // backend of the stand-in HAL, see sim_hal.cpp
+
+  //! RNG_SR read
+  static uint32_t ReadRngStatus(void);
+
+  //! RNG_DR read, starts the next word
+  static uint32_t ReadRngData(void);
+
+  //! HAL_RNG_GenerateRandomNumber(), waits for the next word
+  static HAL_StatusTypeDef GenerateRandomNumber(uint32_t* const word);
+
+  //! HAL_RNG_Init(), clears a simulated seed error
+  static void ResetRng(void);
+
+  //! SPI_SR read, the TX FIFO bytes due by now are shifted into the DAC
+  //! \details a read after an SPI_DR read clears OVR
+  static uint32_t ReadSpiStatus(void);
+
+  //! SPI_DR read of RX FIFO bytes, empty bytes read as 0
+  //! \param[in] size access width in bytes, 1 or 2
+  static uint32_t ReadSpiData(const uint32_t size);
+
+  //! SPI_DR write of TX FIFO bytes, lower byte first, with data packing
+  //! \param[in] value written value
+  //! \param[in] size access width in bytes, 1 or 2
+  static void WriteSpiData(const uint32_t value, const uint32_t size);
+
+  //! DWT_CYCCNT read
+  static uint32_t ReadCycleCounter(void);
+
+  //! DWT_CYCCNT write
+  static void WriteCycleCounter(const uint32_t value);
+
+  //! SCB_ICSR read, PENDSVSET only
+  static uint32_t ReadInterruptControl(void);
+
+  //! SCB_ICSR write, PENDSVSET only
+  static void WriteInterruptControl(const uint32_t value);
+
+  //! GPIOx_BSRR write
+  static void WriteGpio(GPIO_TypeDef* const port, const uint32_t set_reset);
+
+  //! HAL_SPI_Transmit()
+  static HAL_StatusTypeDef TransmitSpi(SPI_HandleTypeDef* const handle,
+                                       const uint8_t* const data,
+                                       const uint16_t size);
+
+  //! HAL_SPI_Transmit_DMA(), completes by HAL_SPI_TxCpltCallback()
+  static HAL_StatusTypeDef StartSpiDma(SPI_HandleTypeDef* const handle,
+                                       const uint8_t* const data,
+                                       const uint16_t size);
+
+  //! HAL_SPI_Abort(), drops a running DMA frame without callback
+  static void AbortSpi(void);
+
+  //! HAL_TIM_Base_Start_IT()
+  static HAL_StatusTypeDef StartTimer(TIM_HandleTypeDef* const handle);
+
+  //! HAL_TIM_Base_Stop_IT()
+  static void StopTimer(TIM_HandleTypeDef* const handle);
+
+  //! HAL_FLASH_Unlock() and HAL_FLASH_Lock()
+  static void SetFlashLock(const bool is_locked);
+
+  //! HAL_FLASH_Program_IT(), completes by HAL_FLASH_EndOfOperationCallback()
+  static HAL_StatusTypeDef StartFlashProgram(const uint32_t address,
+                                             const uint64_t data);
+
+  //! HAL_FLASHEx_Erase_IT(), completes by HAL_FLASH_EndOfOperationCallback()
+  static HAL_StatusTypeDef StartFlashErase(const uint32_t page,
+                                           const uint32_t count);
+
+  //! HAL_FLASH_GetError()
+  static uint32_t GetFlashError(void);
+
+  //! PRIMASK access
+  static uint32_t GetPrimask(void);
+  static void SetPrimask(const uint32_t primask);
+
+  //! BASEPRI access, see __set_BASEPRI_MAX() for is_max
+  static uint32_t GetBasepri(void);
+  static void SetBasepri(const uint32_t basepri, const bool is_max);
+
+ private:
+  //! enum type for the simulated interrupt sources
+  enum class Source : uint8_t {
+    kNone,
+    kExti,
+    kSpiDma,
+    kTimer,
+    kFlash,
+    kPendSv
+  };
+
+  //! enum type for the running flash operation
+  enum class FlashOperation : uint8_t {
+    kNone,
+    kProgram,
+    kErase
+  };
+
+  //! running timer with update interrupt
+  struct Timer {
+    TIM_HandleTypeDef* handle;  //!< HAL handle, nullptr if the slot is free
+    uint32_t priority;          //!< preemption priority of the interrupt
+    uint64_t next_cycle;        //!< cycle of the next update event
+  };
+
+  //! update interrupts of a timer
+  struct TimerUpdates {
+    const TIM_TypeDef* instance;  //!< register block, nullptr if unused
+    uint64_t count;               //!< update interrupts taken
+  };
+
+  //! byte in the TX FIFO of the SPI
+  struct SpiByte {
+    uint64_t cycle;  //!< cycle at which the byte has been shifted out
+    uint8_t data;    //!< byte value
+  };
+
+  //! scheduled input edge
+  struct InputEdge {
+    uint64_t cycle;       //!< cycle of the edge
+    GPIO_TypeDef* port;   //!< GPIO port
+    uint16_t pin;         //!< GPIO_PIN_x mask
+    bool is_high;         //!< new level
+  };
+
+  //! advances the clock without taking interrupts
+  static void Advance(const uint64_t cycles);
+
+  //! applies due inputs and takes all due and unmasked interrupts
+  static void Poll(void);
+
+  //! getter for the cycle of the next input edge or unmasked interrupt
+  static uint64_t GetNextEventCycle(void);
+
+  //! checks the masks and the running priority
+  static bool IsEnabled(const uint32_t priority);
+
+  //! applies the input edges that are due
+  static void ApplyInputs(void);
+
+  //! shifts the TX FIFO bytes due by now into the DAC
+  static void ShiftSpi(void);
+
+  //! fills the RX FIFO with the bytes received in 2-line mode
+  //! \param[in] count received bytes, OVR is set when the FIFO is full
+  static void ReceiveSpi(const uint32_t count);
+
+  //! finishes the running flash operation, called by its interrupt
+  static void CompleteFlashOperation(void);
+
+  //! runs one interrupt handler
+  static void Dispatch(const Source source, const uint32_t priority,
+                       Timer* const timer);
+
+  //! counts an update interrupt of a timer
+  static void CountTimerUpdate(const TIM_TypeDef* const instance);
+
+  //! duration of a frame on the bus
+  static uint64_t GetFrameCycles(const SPI_TypeDef* const instance,
+                                 const uint16_t size);
+
+  //! period of a timer in core cycles, from PSC and ARR
+  static uint64_t GetTimerPeriod(const TIM_HandleTypeDef* const handle);
+
+  //! converts cycles of HCLK to cycles of kCoreClock
+  static uint64_t ToReferenceCycles(const uint64_t bus_cycles);
+
+  //! cycles of kCoreClock until the next RNG word, the RNG runs on MSI
+  static uint64_t GetRngWordCycles(void);
+
+  //! bytes of each SPI FIFO
+  static const uint32_t kSpiFifoSize_ = 4U;
+
+  //! number of timer slots
+  static const uint32_t kTimerCount_ = 4U;
+
+  //! running priority of the thread mode
+  static const uint32_t kThreadPriority_ = 256U;
+
+  //! bytes of the mapped GPIO area
+  static const uint32_t kGpioMapSize_ = 0x1000U;
+
+  //! first byte of the mapped flash, the two journal pages
+  static const uint32_t kFlashMapBase_ = FLASH_BASE + (30U * FLASH_PAGE_SIZE);
+
+  //! bytes of the mapped flash
+  static const uint32_t kFlashMapSize_ = 2U * FLASH_PAGE_SIZE;
+
+  //! simulated time in core cycles
+  static uint64_t cycles_;
+
+  //! cycle at which DWT_CYCCNT was 0
+  static uint64_t cycle_counter_origin_;
+
+  //! priority of the running context, kThreadPriority_ in thread mode
+  static uint32_t running_priority_;
+
+  //! PRIMASK
+  static bool is_primask_set_;
+
+  //! BASEPRI
+  static uint32_t basepri_;
+
+  //! pending PendSV
+  static bool is_pendsv_pending_;
+
+  //! EXTI lines with interrupt
+  static uint16_t exti_mask_;
+
+  //! pending EXTI lines
+  static uint16_t exti_pending_;
+
+  //! scheduled input edges, sorted by cycle
+  static std::deque<InputEdge> inputs_;
+
+  //! timer slots
+  static Timer timers_[kTimerCount_];
+
+  //! update interrupts per timer
+  static TimerUpdates timer_updates_[kTimerCount_];
+
+  //! SPI handle of the running DMA frame, nullptr if idle
+  static SPI_HandleTypeDef* dma_handle_;
+
+  //! completion cycle of the running DMA frame
+  static uint64_t dma_complete_cycle_;
+
+  //! TX FIFO of the register frames
+  static std::deque<SpiByte> spi_tx_;
+
+  //! bytes in the RX FIFO
+  static uint32_t spi_rx_level_;
+
+  //! RX FIFO overrun, SPI_SR_OVR
+  static bool is_spi_overrun_;
+
+  //! last SPI access was an SPI_DR read, the next SPI_SR read clears OVR
+  static bool is_spi_data_read_;
+
+  //! SPI does not shift, see SetSpiStall()
+  static bool is_spi_stalled_;
+
+  //! flash control register locked
+  static bool is_flash_locked_;
+
+  //! running flash operation
+  static FlashOperation flash_operation_;
+
+  //! address of the programmed double word or of the first erased page
+  static uint32_t flash_address_;
+
+  //! programmed double word
+  static uint64_t flash_data_;
+
+  //! bytes erased by the running operation
+  static uint32_t flash_erase_size_;
+
+  //! completion cycle of the running flash operation
+  static uint64_t flash_complete_cycle_;
+
+  //! error flags of the last flash operations, HAL_FLASH_GetError()
+  static uint32_t flash_error_;
+
+  //! every flash_failure_period_-th operation fails, 0 for none
+  static uint32_t flash_failure_period_;
+
+  //! flash operations completed since SetFlashFailures()
+  static uint32_t flash_operations_;
+
+  //! cycle from which the RNG has the next word
+  static uint64_t rng_ready_cycle_;
+
+  //! DAC on SPI1
+  static VirtualDac dac_;
+
+  //! entropy source of the RNG
+  static RngSource rng_source_;
+
+  //! cycle costs
+  static CostModel cost_model_;
+};
+
+}  // namespace sim
+}  // namespace tkrandom
+
+#endif  // MCU_HPP_
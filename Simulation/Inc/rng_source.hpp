@@ -0,0 +1,86 @@
+//! \brief     Class declaration of the entropy source of the simulated RNG.
+//! \details   Delivers 32-bit words from a seeded SplitMix64 generator or
+//!            from a file, e.g. a capture of the hardware RNG.
+//! \file      rng_source.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef RNG_SOURCE_HPP_
+#define RNG_SOURCE_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+
+namespace tkrandom {
+namespace sim {
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! RngSource class declaration
+//! \details file words are read little endian, the file is rewound at its
+//!          end, so short captures are repeated
+class RngSource {
+ public:
+  //! constructor, PRNG mode with seed 0
+  constexpr RngSource(void)
+      : state_(0U),
+        file_(nullptr),
+        has_spare_(false),
+        spare_(0U),
+        has_fault_(false) {}
+
+  //! destructor, closes the file
+  ~RngSource(void);
+
+  //! no copy constructor allowed since there is only one instance
+  RngSource(const RngSource&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  RngSource& operator=(RngSource const&) = delete;
+
+  //! switches to PRNG mode and restarts the sequence
+  //! \param[in] seed seed of the SplitMix64 generator
+  void Seed(const uint64_t seed);
+
+  //! switches to file mode
+  //! \param[in] path file with raw 32-bit words
+  //! \return true if the file could be opened and holds at least one word
+  bool Open(const char* const path);
+
+  //! getter for the next word
+  //! \return 32-bit random word
+  uint32_t Next(void);
+
+  //! simulates a seed error of the RNG until cleared
+  //! \param[in] has_fault true to report SECS and fail HAL calls
+  void SetFault(const bool has_fault);
+
+  //! getter for the simulated seed error
+  //! \return true while a fault is set
+  bool HasFault(void) const;
+
+ private:
+  //! SplitMix64 state
+  uint64_t state_;
+
+  //! open file in file mode, nullptr in PRNG mode
+  std::FILE* file_;
+
+  //! true if spare_ holds the upper half of the last 64-bit output
+  bool has_spare_;
+
+  //! upper half of the last 64-bit output
+  uint32_t spare_;
+
+  //! simulated seed error
+  bool has_fault_;
+};
+
+}  // namespace sim
+}  // namespace tkrandom
+
+#endif  // RNG_SOURCE_HPP_
@@ -0,0 +1,213 @@
+//! \brief     Class declarations of the statistical test battery.
+//! \details   Streaming tests of 16-bit random samples against the exact
+//!            distribution of the Generator paths, in constant memory.
+//! \file      statistics.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef STATISTICS_HPP_
+#define STATISTICS_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+namespace tkrandom {
+namespace sim {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the sample distributions of the Generator
+enum class SampleModelKind : uint8_t {
+  kUniform,         //!< 16-bit uniform
+  kNormalSum,       //!< (a + b + c + d) / 4, GetNormalRandomNumber()
+  kNormalPairwise   //!< halving adds ((a + b) / 2 + (c + d) / 2) / 2, Fill()
+};
+
+//! result of one test
+struct TestResult {
+  const char* name;     //!< name of the test
+  double statistic;     //!< chi-square, D or z
+  double p_value;       //!< probability of a statistic at least as extreme
+  bool is_applicable;   //!< false if the test does not apply or lacks samples
+};
+
+// CLASS DECLARATIONS ----------------------------------------------------------
+//! SampleModel class declaration
+//! \details exact probabilities of all 65536 values, derived from the counts
+//!          of sums of uniform 16-bit numbers
+class SampleModel {
+ public:
+  //! number of sample values
+  static const uint32_t kValueCount = 65536U;
+
+  //! constructor
+  //! \param[in] kind distribution of the samples
+  explicit SampleModel(const SampleModelKind kind);
+
+  //! destructor
+  ~SampleModel(void) = default;
+
+  //! getter for the probability of a value
+  //! \param[in] value sample value
+  //! \return P(X = value)
+  double GetProbability(const uint32_t value) const;
+
+  //! getter for the distribution function
+  //! \param[in] value sample value
+  //! \return P(X <= value)
+  double GetCdf(const uint32_t value) const;
+
+  //! getter for the smallest value with a cumulated probability of at least p
+  //! \param[in] probability 0.0 .. 1.0
+  //! \return sample value
+  uint32_t GetQuantile(const double probability) const;
+
+  //! getter for the distribution
+  //! \return distribution of the samples
+  SampleModelKind GetKind(void) const;
+
+ private:
+  //! distribution of the samples
+  SampleModelKind kind_;
+
+  //! P(X = value)
+  std::vector<double> probabilities_;
+
+  //! P(X <= value)
+  std::vector<double> cdf_;
+};
+
+//! TestBattery class declaration
+//! \details Add() updates all tests per sample, memory does not grow with the
+//!          number of samples. Birthday spacings need uniform samples.
+class TestBattery {
+ public:
+  //! number of tests in Evaluate()
+  static const uint32_t kTestCount = 6U;
+
+  //! p-values below fail a test
+  static constexpr double kAlpha = 1e-4;
+
+  //! constructor
+  //! \param[in] model distribution the samples are tested against
+  explicit TestBattery(const SampleModel& model);
+
+  //! destructor
+  ~TestBattery(void) = default;
+
+  //! no copy constructor allowed since the histograms are large
+  TestBattery(const TestBattery&) = delete;
+
+  //! no assignment operator allowed since the histograms are large
+  TestBattery& operator=(TestBattery const&) = delete;
+
+  //! adds one sample to all tests
+  //! \param[in] sample 16-bit sample in stream order
+  void Add(const uint16_t sample);
+
+  //! getter for the number of samples
+  //! \return samples added so far
+  uint64_t GetCount(void) const;
+
+  //! evaluates all tests
+  //! \param[out] results kTestCount results
+  void Evaluate(TestResult* const results) const;
+
+ private:
+  //! chi-square of the 256 histogram classes of the upper byte
+  TestResult EvaluateChiSquare(void) const;
+
+  //! Kolmogorov-Smirnov distance of the empirical to the model CDF
+  TestResult EvaluateKolmogorovSmirnov(void) const;
+
+  //! runs above and below the median
+  TestResult EvaluateRuns(void) const;
+
+  //! lag-1 serial correlation
+  TestResult EvaluateSerialCorrelation(void) const;
+
+  //! duplicate birthday spacings against Poisson(kBirthdayLambda_)
+  TestResult EvaluateBirthdaySpacings(void) const;
+
+  //! geometric gap lengths between hits of the central quintile
+  TestResult EvaluateGaps(void) const;
+
+  //! evaluates a finished block of birthdays
+  void CountBirthdaySpacings(void);
+
+  //! birthdays per block, 32-bit days of two samples each
+  static const uint32_t kBirthdays_ = 4096U;
+
+  //! expected duplicate spacings per block: m^3 / (4 * 2^32)
+  static constexpr double kBirthdayLambda_ = 4.0;
+
+  //! classes of duplicate spacings, the last one is the tail
+  static const uint32_t kBirthdayClasses_ = 16U;
+
+  //! classes of gap lengths, the last one is the tail
+  static const uint32_t kGapClasses_ = 32U;
+
+  //! distribution the samples are tested against
+  const SampleModel& model_;
+
+  //! true if birthday spacings apply
+  const bool is_uniform_;
+
+  //! number of samples
+  uint64_t count_;
+
+  //! histogram of all values
+  std::vector<uint64_t> histogram_;
+
+  //! values above run_threshold_ are the second class of the runs test
+  uint32_t run_threshold_;
+
+  //! number of runs
+  uint64_t runs_;
+
+  //! class of the previous sample
+  bool was_above_;
+
+  //! sum, sum of squares and sum of lag-1 products
+  unsigned __int128 sum_;
+  unsigned __int128 sum_squares_;
+  unsigned __int128 sum_products_;
+
+  //! first and previous sample, close the lag-1 products circularly
+  uint16_t first_;
+  uint16_t previous_;
+
+  //! birthdays of the running block
+  std::vector<uint32_t> birthdays_;
+
+  //! spacings of the running block
+  std::vector<uint32_t> spacings_;
+
+  //! birthdays in the running block
+  uint32_t birthday_count_;
+
+  //! true if the lower half of the next birthday is pending
+  bool has_birthday_half_;
+
+  //! histogram of duplicate spacings per block
+  uint64_t birthday_classes_[kBirthdayClasses_];
+
+  //! closed gap interval of the gap test
+  uint32_t gap_low_;
+  uint32_t gap_high_;
+
+  //! samples since the last hit, -1 before the first hit
+  int64_t gap_length_;
+
+  //! histogram of gap lengths
+  uint64_t gap_classes_[kGapClasses_];
+};
+
+}  // namespace sim
+}  // namespace tkrandom
+
+#endif  // STATISTICS_HPP_
@@ -0,0 +1,479 @@
+//! \brief     Stand-in for the STM32L4 HAL and CMSIS headers on the host.
+//! \details   Declares the subset of types, registers, macros and functions
+//!            that UserCode uses. Registers with side effects are proxies that
+//!            forward to the simulated MCU, see mcu.hpp and sim_hal.cpp.
+//! \file      stm32l4xx_hal.h
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef STM32L4XX_HAL_H_
+#define STM32L4XX_HAL_H_
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+// HAL TYPES -------------------------------------------------------------------
+#define __IO volatile
+
+typedef enum {
+  HAL_OK = 0x00U,
+  HAL_ERROR = 0x01U,
+  HAL_BUSY = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+// REGISTER PROXIES ------------------------------------------------------------
+//! read-only register whose value is produced by the simulated MCU
+//! \tparam Read hook returning the current register content
+template <uint32_t (*Read)(void)>
+struct SimReadRegister {
+  operator uint32_t() const { return Read(); }
+};
+
+//! register whose reads and writes are forwarded to the simulated MCU
+//! \tparam Read hook returning the current register content
+//! \tparam Write hook taking the written value
+template <uint32_t (*Read)(void), void (*Write)(uint32_t)>
+struct SimRegister {
+  operator uint32_t() const { return Read(); }
+  SimRegister& operator=(const uint32_t value) {
+    Write(value);
+    return *this;
+  }
+};
+
+//! write-only set/reset register of a GPIO port, updates ODR of its port
+struct SimGpioSetResetRegister {
+  uint32_t reserved;
+  SimGpioSetResetRegister& operator=(const uint32_t value);
+};
+
+//! data register of the SPI, accessed by ReadRegister() and WriteRegister()
+//! of register_access.hpp, whose overloads below forward the access width
+struct SimSpiDataRegister {
+  uint32_t reserved;
+};
+
+//! hooks of the register proxies, implemented in sim_hal.cpp
+uint32_t SimReadRngStatus(void);
+uint32_t SimReadRngData(void);
+uint32_t SimReadSpiStatus(void);
+uint32_t SimReadSpiData(uint32_t size);
+void SimWriteSpiData(uint32_t value, uint32_t size);
+uint32_t SimReadCycleCounter(void);
+void SimWriteCycleCounter(uint32_t value);
+uint32_t SimReadInterruptControl(void);
+void SimWriteInterruptControl(uint32_t value);
+
+// CORE PERIPHERALS ------------------------------------------------------------
+#define __NVIC_PRIO_BITS 4U
+
+typedef struct {
+  __IO uint32_t CTRL;
+  SimRegister<SimReadCycleCounter, SimWriteCycleCounter> CYCCNT;
+} DWT_Type;
+
+typedef struct {
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+  SimRegister<SimReadInterruptControl, SimWriteInterruptControl> ICSR;
+  __IO uint32_t CFSR;
+  __IO uint32_t HFSR;
+  __IO uint32_t MMFAR;
+  __IO uint32_t BFAR;
+} SCB_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0U)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24U)
+#define SCB_ICSR_PENDSVSET_Msk (1UL << 28U)
+
+// DEVICE PERIPHERALS ----------------------------------------------------------
+typedef struct {
+  __IO uint32_t MODER;
+  __IO uint32_t OTYPER;
+  __IO uint32_t OSPEEDR;
+  __IO uint32_t PUPDR;
+  __IO uint32_t IDR;
+  __IO uint32_t ODR;
+  SimGpioSetResetRegister BSRR;
+  __IO uint32_t LCKR;
+  __IO uint32_t AFR[2];
+  __IO uint32_t BRR;
+} GPIO_TypeDef;
+
+typedef struct {
+  __IO uint32_t CR;
+  SimReadRegister<SimReadRngStatus> SR;
+  SimReadRegister<SimReadRngData> DR;
+} RNG_TypeDef;
+
+typedef struct {
+  __IO uint32_t CR1;
+  __IO uint32_t CR2;
+  SimReadRegister<SimReadSpiStatus> SR;
+  SimSpiDataRegister DR;
+} SPI_TypeDef;
+
+//! SPI FIFO access of the width of T, found by argument-dependent lookup
+template <typename T>
+inline __attribute__((always_inline)) void WriteRegister(
+    SimSpiDataRegister& reg, const T value) {
+  static_cast<void>(reg);
+  SimWriteSpiData(value, sizeof(T));
+}
+
+template <typename T>
+inline __attribute__((always_inline)) T ReadRegister(
+    SimSpiDataRegister& reg) {
+  static_cast<void>(reg);
+  return static_cast<T>(SimReadSpiData(sizeof(T)));
+}
+
+typedef struct {
+  __IO uint32_t CR1;
+  __IO uint32_t CR2;
+  __IO uint32_t DIER;
+  __IO uint32_t SR;
+  __IO uint32_t CNT;
+  __IO uint32_t PSC;
+  __IO uint32_t ARR;
+} TIM_TypeDef;
+
+typedef struct {
+  __IO uint32_t CSR;
+} RCC_TypeDef;
+
+typedef struct {
+  __IO uint32_t ISR;
+  __IO uint32_t CR;
+  __IO uint32_t CFGR;
+  __IO uint32_t CFGR2;
+  __IO uint32_t SMPR1;
+  __IO uint32_t SQR1;
+  __IO uint32_t DR;
+} ADC_TypeDef;
+
+typedef struct {
+  __IO uint32_t CCR;
+} ADC_Common_TypeDef;
+
+typedef struct {
+  __IO uint32_t CCR;
+  __IO uint32_t CNDTR;
+  __IO uint32_t CPAR;
+  __IO uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+  __IO uint32_t CSELR;
+} DMA_Request_TypeDef;
+
+typedef struct {
+  __IO uint32_t SR;
+  __IO uint32_t ECCR;  //!< ADDR_ECC only, ECCD is part of SR
+} FLASH_TypeDef;
+
+typedef struct {
+  __IO uint32_t KR;
+  __IO uint32_t PR;
+  __IO uint32_t RLR;
+  __IO uint32_t SR;
+  __IO uint32_t WINR;
+} IWDG_TypeDef;
+
+//! GPIO register blocks are mapped to their device addresses by the simulated
+//! MCU, since board.hpp takes the base address as template argument
+#define GPIOA_BASE 0x48000000UL
+#define GPIOB_BASE 0x48000400UL
+#define GPIOA (reinterpret_cast<GPIO_TypeDef*>(GPIOA_BASE))
+#define GPIOB (reinterpret_cast<GPIO_TypeDef*>(GPIOB_BASE))
+
+//! all other peripherals are compared by address only
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+extern SCB_Type sim_scb;
+extern RCC_TypeDef sim_rcc;
+extern IWDG_TypeDef sim_iwdg;
+extern FLASH_TypeDef sim_flash;
+extern ADC_TypeDef sim_adc1;
+extern ADC_Common_TypeDef sim_adc12_common;
+extern DMA_Channel_TypeDef sim_dma1_channel1;
+extern DMA_Request_TypeDef sim_dma1_cselr;
+extern RNG_TypeDef sim_rng;
+extern SPI_TypeDef sim_spi1;
+extern TIM_TypeDef sim_tim6;
+extern TIM_TypeDef sim_tim15;
+extern TIM_TypeDef sim_tim16;
+
+#define DWT (&sim_dwt)
+#define CoreDebug (&sim_core_debug)
+#define SCB (&sim_scb)
+#define RCC (&sim_rcc)
+#define IWDG (&sim_iwdg)
+#define FLASH (&sim_flash)
+#define ADC1 (&sim_adc1)
+#define ADC12_COMMON (&sim_adc12_common)
+#define DMA1_Channel1 (&sim_dma1_channel1)
+#define DMA1_CSELR (&sim_dma1_cselr)
+#define RNG (&sim_rng)
+#define SPI1 (&sim_spi1)
+#define TIM6 (&sim_tim6)
+#define TIM15 (&sim_tim15)
+#define TIM16 (&sim_tim16)
+
+#define RNG_SR_DRDY (1UL << 0U)
+#define RNG_SR_CECS (1UL << 1U)
+#define RNG_SR_SECS (1UL << 2U)
+
+#define SPI_CR1_BR_Pos 3U
+#define SPI_CR1_BR (0x7UL << SPI_CR1_BR_Pos)
+#define SPI_CR1_SPE (1UL << 6U)
+#define SPI_SR_BSY (1UL << 7U)
+#define SPI_SR_OVR (1UL << 6U)
+#define SPI_SR_FRLVL (0x3UL << 9U)
+#define SPI_SR_FTLVL (0x3UL << 11U)
+
+#define SPI_BAUDRATEPRESCALER_2 (0x00000000U)
+#define SPI_BAUDRATEPRESCALER_4 (0x00000008U)
+#define SPI_BAUDRATEPRESCALER_8 (0x00000010U)
+#define SPI_BAUDRATEPRESCALER_16 (0x00000018U)
+#define SPI_BAUDRATEPRESCALER_32 (0x00000020U)
+#define SPI_BAUDRATEPRESCALER_64 (0x00000028U)
+#define SPI_BAUDRATEPRESCALER_128 (0x00000030U)
+#define SPI_BAUDRATEPRESCALER_256 (0x00000038U)
+
+#define RCC_CSR_RMVF (1UL << 23U)
+
+#define ADC_ISR_ADRDY (1UL << 0U)
+#define ADC_CR_ADEN (1UL << 0U)
+#define ADC_CR_ADSTART (1UL << 2U)
+#define ADC_CR_ADVREGEN (1UL << 28U)
+#define ADC_CR_DEEPPWD (1UL << 29U)
+#define ADC_CR_ADCAL (1UL << 31U)
+#define ADC_CFGR_DMAEN (1UL << 0U)
+#define ADC_CFGR_DMACFG (1UL << 1U)
+#define ADC_CFGR_OVRMOD (1UL << 12U)
+#define ADC_CFGR_CONT (1UL << 13U)
+#define ADC_CFGR2_ROVSE (1UL << 0U)
+#define ADC_CFGR2_OVSR_Pos 2U
+#define ADC_SQR1_L_Pos 0U
+#define ADC_SQR1_SQ1_Pos 6U
+#define ADC_CCR_CKMODE_1 (0x2UL << 16U)
+
+#define DMA_CCR_EN (1UL << 0U)
+#define DMA_CCR_CIRC (1UL << 5U)
+#define DMA_CCR_MINC (1UL << 7U)
+#define DMA_CCR_PSIZE_0 (1UL << 8U)
+#define DMA_CCR_MSIZE_0 (1UL << 10U)
+#define DMA_CSELR_C1S (0xFUL << 0U)
+
+//! only the journal pages at the end of the flash are mapped, see Mcu
+#define FLASH_BASE 0x08000000UL
+#define FLASH_PAGE_SIZE 0x00000800U
+#define FLASH_BANK_1 0x00000001U
+#define FLASH_TYPEERASE_PAGES 0x00000000U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD 0x00000000U
+#define FLASH_FLAG_PROGERR (1UL << 3U)
+#define FLASH_FLAG_ALL_ERRORS FLASH_FLAG_PROGERR
+//! ECCR_ECCD on the device, part of the one status register here
+#define FLASH_FLAG_ECCD (1UL << 31U)
+#define FLASH_ECCR_ADDR_ECC (0x7FFFFUL << 0U)
+
+#define IWDG_PR_PR_0 (1UL << 0U)
+#define IWDG_PR_PR_1 (1UL << 1U)
+#define IWDG_PR_PR_2 (1UL << 2U)
+
+// HAL HANDLES -----------------------------------------------------------------
+typedef struct {
+  RNG_TypeDef* Instance;
+  uint32_t ErrorCode;
+} RNG_HandleTypeDef;
+
+typedef struct {
+  uint32_t BaudRatePrescaler;
+} SPI_InitTypeDef;
+
+typedef struct {
+  SPI_TypeDef* Instance;
+  SPI_InitTypeDef Init;
+  __IO uint32_t ErrorCode;
+} SPI_HandleTypeDef;
+
+typedef struct {
+  uint32_t Prescaler;
+  uint32_t Period;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+  TIM_TypeDef* Instance;
+  TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+typedef struct {
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uint32_t Page;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+//! RCC_PLLP_SUPPORT is not defined for the STM32L412, it has no SAI and no
+//! PLLP divider
+typedef struct {
+  uint32_t PLLState;
+  uint32_t PLLSource;
+  uint32_t PLLM;
+  uint32_t PLLN;
+  uint32_t PLLQ;
+  uint32_t PLLR;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+  uint32_t OscillatorType;
+  uint32_t MSIState;
+  uint32_t MSICalibrationValue;
+  uint32_t MSIClockRange;
+  RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+  uint32_t ClockType;
+  uint32_t SYSCLKSource;
+  uint32_t AHBCLKDivider;
+  uint32_t APB1CLKDivider;
+  uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_NONE 0x00000000U
+#define RCC_OSCILLATORTYPE_MSI 0x00000010U
+
+#define RCC_MSI_OFF 0x00000000U
+#define RCC_MSI_ON 0x00000001U
+
+#define RCC_MSIRANGE_6 0x00000060U
+#define RCC_MSIRANGE_11 0x000000B0U
+
+#define RCC_PLL_NONE 0x00000000U
+#define RCC_PLL_OFF 0x00000001U
+#define RCC_PLL_ON 0x00000002U
+#define RCC_PLLSOURCE_MSI 0x00000001U
+#define RCC_PLLQ_DIV2 0x00000002U
+#define RCC_PLLR_DIV2 0x00000002U
+
+#define RCC_CLOCKTYPE_SYSCLK 0x00000001U
+#define RCC_CLOCKTYPE_HCLK 0x00000002U
+#define RCC_CLOCKTYPE_PCLK1 0x00000004U
+#define RCC_CLOCKTYPE_PCLK2 0x00000008U
+#define RCC_SYSCLKSOURCE_MSI 0x00000000U
+#define RCC_SYSCLKSOURCE_PLLCLK 0x00000003U
+#define RCC_SYSCLK_DIV1 0x00000000U
+#define RCC_HCLK_DIV1 0x00000000U
+
+#define FLASH_LATENCY_0 0U
+#define FLASH_LATENCY_1 1U
+#define FLASH_LATENCY_2 2U
+#define FLASH_LATENCY_3 3U
+#define FLASH_LATENCY_4 4U
+
+#define PWR_REGULATOR_VOLTAGE_SCALE1 0x00000200U
+#define PWR_REGULATOR_VOLTAGE_SCALE2 0x00000400U
+
+// MACROS ----------------------------------------------------------------------
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) \
+  ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+
+#define __HAL_SPI_DISABLE(__HANDLE__) \
+  ((__HANDLE__)->Instance->CR1 &= (~SPI_CR1_SPE))
+
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__) \
+  ((__HANDLE__)->Instance->CNT = (__COUNTER__))
+
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) \
+  do {                                                       \
+    (__HANDLE__)->Instance->ARR = (__AUTORELOAD__);          \
+    (__HANDLE__)->Init.Period = (__AUTORELOAD__);            \
+  } while (0)
+
+#define __HAL_TIM_SET_PRESCALER(__HANDLE__, __PRESC__) \
+  ((__HANDLE__)->Instance->PSC = (__PRESC__))
+
+#define __HAL_FLASH_GET_FLAG(__FLAG__) (FLASH->SR & (__FLAG__))
+#define __HAL_FLASH_CLEAR_FLAG(__FLAG__) (FLASH->SR &= ~(__FLAG__))
+
+#define __HAL_RCC_CLEAR_RESET_FLAGS() (RCC->CSR |= RCC_CSR_RMVF)
+
+//! clocks are not modeled
+#define __HAL_RCC_ADC_CLK_ENABLE() ((void)0)
+
+//! no debugger halts the simulated core
+#define __HAL_DBGMCU_FREEZE_IWDG() ((void)0)
+
+// CMSIS INTRINSICS ------------------------------------------------------------
+//! interrupt masks of the simulated core, evaluated by its NVIC model
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_BASEPRI(void);
+void __set_BASEPRI(uint32_t basepri);
+void __set_BASEPRI_MAX(uint32_t basepri);
+[[noreturn]] void NVIC_SystemReset(void);
+
+#define __COMPILER_BARRIER() __asm volatile("" ::: "memory")
+
+static inline void __DSB(void) {
+  __COMPILER_BARRIER();
+}
+
+static inline uint32_t __CLZ(const uint32_t value) {
+  return (value == 0U) ? 32U : static_cast<uint32_t>(__builtin_clz(value));
+}
+
+// HAL FUNCTIONS ---------------------------------------------------------------
+extern __IO uint32_t uwTick;
+uint32_t HAL_GetTick(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct,
+                                      uint32_t FLatency);
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling);
+
+HAL_StatusTypeDef HAL_RNG_Init(RNG_HandleTypeDef* hrng);
+HAL_StatusTypeDef HAL_RNG_DeInit(RNG_HandleTypeDef* hrng);
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef* hrng,
+                                               uint32_t* random32bit);
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData,
+                                   uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi,
+                                       uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* hspi);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi);
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim);
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program_IT(uint32_t TypeProgram, uint32_t Address,
+                                       uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(FLASH_EraseInitTypeDef* pEraseInit);
+uint32_t HAL_FLASH_GetError(void);
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue);
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue);
+
+#endif  // STM32L4XX_HAL_H_
@@ -0,0 +1,137 @@
+//! \brief     Class declaration of the simulated 8-channel DAC.
+//! \details   Decodes the SPI frames of the Transmitter into timestamped
+//!            channel updates, latched by the rising edge of NSS.
+//! \file      virtual_dac.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef VIRTUAL_DAC_HPP_
+#define VIRTUAL_DAC_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstdint>
+
+namespace tkrandom {
+namespace sim {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! one latched DAC channel update
+struct DacUpdate {
+  uint64_t cycle;    //!< core cycle of the latching NSS edge
+  uint8_t channel;   //!< DAC channel 0 .. 7, outputs 1 .. 4 then LEDs 1 .. 4
+  uint16_t value;    //!< new channel value
+};
+
+//! callback for every latched update
+//! \param[in] update latched channel update
+//! \param[in] context pointer given to SetListener()
+using DacListener = void (*)(const DacUpdate& update, void* context);
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! VirtualDac class declaration
+//! \details 24-bit frames: command nibble, address nibble, 16-bit value, MSB
+//!          first. Command 3 writes and updates the addressed channel.
+class VirtualDac {
+ public:
+  //! number of DAC channels
+  static const uint8_t kChannelCount = 8U;
+
+  //! constructor
+  constexpr VirtualDac(void)
+      : values_{},
+        shift_register_(0U),
+        shifted_bits_(0U),
+        is_selected_(false),
+        is_reset_(false),
+        update_count_(0U),
+        frame_error_count_(0U),
+        listener_(nullptr),
+        listener_context_(nullptr) {}
+
+  //! destructor
+  ~VirtualDac(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  VirtualDac(const VirtualDac&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  VirtualDac& operator=(VirtualDac const&) = delete;
+
+  //! clears the channels and the counters, keeps the listener
+  void Clear(void);
+
+  //! sets the callback for latched updates
+  //! \param[in] listener callback, nullptr to disable
+  //! \param[in] context pointer passed to the callback
+  void SetListener(const DacListener listener, void* const context);
+
+  //! applies the level of the NSS line, the rising edge latches the frame
+  //! \param[in] is_high NSS level
+  //! \param[in] cycle core cycle of the edge
+  void SetNss(const bool is_high, const uint64_t cycle);
+
+  //! applies the level of the low active reset line
+  //! \param[in] is_high reset line level
+  void SetReset(const bool is_high);
+
+  //! shifts bytes in while NSS is low
+  //! \param[in] data bytes in transmission order
+  //! \param[in] size number of bytes
+  void ShiftIn(const uint8_t* const data, const uint16_t size);
+
+  //! getter for the current value of a channel
+  //! \param[in] channel DAC channel 0 .. 7
+  //! \return channel value
+  uint16_t GetValue(const uint8_t channel) const;
+
+  //! getter for the number of latched channel updates
+  //! \return updates since Clear()
+  uint64_t GetUpdateCount(void) const;
+
+  //! getter for the number of frames with wrong length or command
+  //! \return frame errors since Clear()
+  uint64_t GetFrameErrorCount(void) const;
+
+ private:
+  //! bits of one frame
+  static const uint32_t kFrameBits_ = 24U;
+
+  //! command nibble: write to and update channel n
+  static const uint32_t kWriteUpdateCommand_ = 3U;
+
+  //! channel values
+  uint16_t values_[kChannelCount];
+
+  //! bits shifted in since the falling edge of NSS
+  uint32_t shift_register_;
+
+  //! number of bits shifted in since the falling edge of NSS
+  uint32_t shifted_bits_;
+
+  //! true while NSS is low
+  bool is_selected_;
+
+  //! true while the reset line is low
+  bool is_reset_;
+
+  //! latched channel updates
+  uint64_t update_count_;
+
+  //! frames with wrong length or command
+  uint64_t frame_error_count_;
+
+  //! callback for latched updates
+  DacListener listener_;
+
+  //! context of the callback
+  void* listener_context_;
+};
+
+}  // namespace sim
+}  // namespace tkrandom
+
+#endif  // VIRTUAL_DAC_HPP_
@@ -0,0 +1,204 @@
+//! \brief     Class definition of the simulated clock tree and regulator.
+//! \details   MSI, PLL, system clock switch, flash latency and voltage scaling
+//!            of the STM32L412 as far as the firmware configures them.
+//! \file      clock_tree.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "clock_tree.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+namespace sim {
+
+const uint32_t ClockTree::kMsiClocks_[12] = {
+    100000U,  200000U,  400000U,  800000U,  1000000U,  2000000U,
+    4000000U, 8000000U, 16000000U, 24000000U, 32000000U, 48000000U};
+
+uint32_t ClockTree::msi_range_ = 11U;
+bool ClockTree::is_pll_on_ = false;
+uint32_t ClockTree::pll_m_ = 1U;
+uint32_t ClockTree::pll_n_ = 8U;
+uint32_t ClockTree::pll_r_ = 2U;
+uint32_t ClockTree::sysclk_source_ = RCC_SYSCLKSOURCE_MSI;
+uint32_t ClockTree::flash_latency_ = FLASH_LATENCY_2;
+uint32_t ClockTree::voltage_scaling_ = PWR_REGULATOR_VOLTAGE_SCALE1;
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void ClockTree::Init() {
+  msi_range_ = 11U;
+  is_pll_on_ = false;
+  pll_m_ = 1U;
+  pll_n_ = 8U;
+  pll_r_ = 2U;
+  sysclk_source_ = RCC_SYSCLKSOURCE_MSI;
+  flash_latency_ = FLASH_LATENCY_2;
+  voltage_scaling_ = PWR_REGULATOR_VOLTAGE_SCALE1;
+}
+//------------------------------------------------------------------------------
+uint32_t ClockTree::GetHclk() {
+  uint32_t return_value = kMsiClocks_[msi_range_];
+  if (sysclk_source_ == RCC_SYSCLKSOURCE_PLLCLK) {
+    return_value = GetPllClock();
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t ClockTree::GetMsiClock() {
+  return kMsiClocks_[msi_range_];
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef ClockTree::SetVoltageScaling(const uint32_t voltage_scaling) {
+  HAL_StatusTypeDef return_value = HAL_OK;
+  const uint32_t previous = voltage_scaling_;
+
+  if ((voltage_scaling != PWR_REGULATOR_VOLTAGE_SCALE1) &&
+      (voltage_scaling != PWR_REGULATOR_VOLTAGE_SCALE2)) {
+    return_value = HAL_ERROR;
+  }
+  else {
+    // the system clock has to be within the limits of the new range already
+    voltage_scaling_ = voltage_scaling;
+    if ((GetHclk() > GetMaxClock()) ||
+        (flash_latency_ < GetMinLatency(GetHclk()))) {
+      voltage_scaling_ = previous;
+      return_value = HAL_ERROR;
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef ClockTree::ConfigureOscillators(
+    const RCC_OscInitTypeDef* const osc_init) {
+  HAL_StatusTypeDef return_value = HAL_OK;
+  const bool is_pll_sysclk = sysclk_source_ == RCC_SYSCLKSOURCE_PLLCLK;
+
+  if ((osc_init->OscillatorType & RCC_OSCILLATORTYPE_MSI) != 0U) {
+    const uint32_t range = osc_init->MSIClockRange >> 4U;
+    if ((osc_init->MSIState != RCC_MSI_ON) || (range >= 12U) ||
+        (is_pll_on_ && (range != msi_range_))) {
+      return_value = HAL_ERROR;  // MSI in use or PLL input out of spec
+    }
+    else if (sysclk_source_ == RCC_SYSCLKSOURCE_MSI) {
+      // the HAL adapts the wait states to the new MSI range itself
+      const uint32_t clock = kMsiClocks_[range];
+      if (clock > GetMaxClock()) {
+        return_value = HAL_ERROR;
+      }
+      else {
+        msi_range_ = range;
+        flash_latency_ = GetMinLatency(clock);
+      }
+    }
+    else {
+      msi_range_ = range;
+    }
+  }
+
+  if ((return_value == HAL_OK) &&
+      (osc_init->PLL.PLLState != RCC_PLL_NONE)) {
+    if (is_pll_sysclk) {
+      return_value = HAL_ERROR;  // the PLL clocks the core
+    }
+    else if (osc_init->PLL.PLLState == RCC_PLL_OFF) {
+      is_pll_on_ = false;
+    }
+    else {
+      const RCC_PLLInitTypeDef& pll = osc_init->PLL;
+      const bool is_valid = (pll.PLLState == RCC_PLL_ON) &&
+                            (pll.PLLSource == RCC_PLLSOURCE_MSI) &&
+                            (pll.PLLM >= 1U) && (pll.PLLM <= 8U) &&
+                            (pll.PLLN >= 8U) && (pll.PLLN <= 86U) &&
+                            ((pll.PLLR == 2U) || (pll.PLLR == 4U) ||
+                             (pll.PLLR == 6U) || (pll.PLLR == 8U));
+      if (!is_valid) {
+        return_value = HAL_ERROR;
+      }
+      else {
+        const uint32_t input = kMsiClocks_[msi_range_] / pll.PLLM;
+        const uint32_t vco = input * pll.PLLN;
+        if ((input < 4000000U) || (input > 16000000U) || (vco < 64000000U) ||
+            (vco > 344000000U) || ((vco / pll.PLLR) > 80000000U)) {
+          return_value = HAL_ERROR;
+        }
+        else {
+          is_pll_on_ = true;
+          pll_m_ = pll.PLLM;
+          pll_n_ = pll.PLLN;
+          pll_r_ = pll.PLLR;
+        }
+      }
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef ClockTree::ConfigureClocks(
+    const RCC_ClkInitTypeDef* const clk_init, const uint32_t flash_latency) {
+  HAL_StatusTypeDef return_value = HAL_OK;
+
+  if ((clk_init->AHBCLKDivider != RCC_SYSCLK_DIV1) ||
+      (clk_init->APB1CLKDivider != RCC_HCLK_DIV1) ||
+      (clk_init->APB2CLKDivider != RCC_HCLK_DIV1)) {
+    return_value = HAL_ERROR;  // not modeled
+  }
+  else if ((clk_init->ClockType & RCC_CLOCKTYPE_SYSCLK) != 0U) {
+    uint32_t clock = 0U;
+    if (clk_init->SYSCLKSource == RCC_SYSCLKSOURCE_MSI) {
+      clock = kMsiClocks_[msi_range_];
+    }
+    else if (clk_init->SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK) {
+      clock = GetPllClock();
+    }
+    if ((clock == 0U) || (clock > GetMaxClock()) ||
+        (flash_latency < GetMinLatency(clock))) {
+      return_value = HAL_ERROR;
+    }
+    else {
+      sysclk_source_ = clk_init->SYSCLKSource;
+      flash_latency_ = flash_latency;
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t ClockTree::GetPllClock() {
+  uint32_t return_value = 0U;
+  if (is_pll_on_) {
+    return_value = ((kMsiClocks_[msi_range_] / pll_m_) * pll_n_) / pll_r_;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t ClockTree::GetMaxClock() {
+  uint32_t return_value = 80000000U;
+  if (voltage_scaling_ == PWR_REGULATOR_VOLTAGE_SCALE2) {
+    return_value = 26000000U;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t ClockTree::GetMinLatency(const uint32_t clock) {
+  // one more wait state per 16 MHz in range 1, per 6 MHz in range 2
+  uint32_t step = 16000000U;
+  if (voltage_scaling_ == PWR_REGULATOR_VOLTAGE_SCALE2) {
+    step = 6000000U;
+  }
+  uint32_t return_value = (clock - 1U) / step;
+  if ((voltage_scaling_ == PWR_REGULATOR_VOLTAGE_SCALE2) &&
+      (return_value > FLASH_LATENCY_3)) {
+    return_value = FLASH_LATENCY_3;  // up to 26 MHz with 3 wait states
+  }
+  return return_value;
+}
+
+}  // namespace sim
+}  // namespace tkrandom
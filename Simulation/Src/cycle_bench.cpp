@@ -0,0 +1,136 @@
+//! \brief     Command line tool that runs the microbenchmarks on the simulated
+//!            MCU.
+//! \details   Measures the hot functions of MicroBench with a high-resolution
+//!            host clock or with the simulated DWT cycle counter and writes
+//!            the results as one JSON line.
+//! \file      cycle_bench.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+//
+//  usage: cycle_bench [options]
+//    --iterations N   calls per function, default 10000
+//    --clock NAME     host (steady clock, ns) or sim (simulated DWT cycles
+//                     of the cost model), default host
+//    --label TEXT     label of the JSON line, e.g. the firmware version
+//    --output FILE    appends the JSON line to a file instead of stdout
+
+// INCLUDES --------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "cycle_counter.hpp"
+#include "firmware.hpp"
+#include "micro_bench.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace {
+
+//! command line options
+struct Options {
+  uint32_t iterations = 10000U;
+  bool is_host_clock = true;
+  const char* label = "";
+  const char* output_path = nullptr;
+};
+
+//! nanoseconds of the host steady clock
+uint32_t HostNanoseconds(void) {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+//! cycles of the simulated DWT
+uint32_t SimulatedCycles(void) {
+  return tkrandom::CycleCounter::Now();
+}
+
+//! parses the command line
+//! \return false on unknown or incomplete options
+bool ParseOptions(const int argc, char** const argv, Options* const options) {
+  bool return_value = true;
+
+  for (int i = 1; (i < argc) && return_value; ++i) {
+    const char* const option = argv[i];
+    const char* const value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr) {
+      return_value = false;
+    }
+    else if (std::strcmp(option, "--iterations") == 0) {
+      options->iterations =
+          static_cast<uint32_t>(std::strtoul(value, nullptr, 0));
+      return_value = options->iterations > 0U;
+    }
+    else if (std::strcmp(option, "--clock") == 0) {
+      options->is_host_clock = std::strcmp(value, "sim") != 0;
+      return_value = options->is_host_clock == (std::strcmp(value, "host") == 0);
+    }
+    else if (std::strcmp(option, "--label") == 0) {
+      options->label = value;
+    }
+    else if (std::strcmp(option, "--output") == 0) {
+      options->output_path = value;
+    }
+    else {
+      return_value = false;
+    }
+    i++;
+  }
+  if (!return_value) {
+    std::fprintf(stderr, "usage: cycle_bench [--iterations N] "
+                         "[--clock host|sim] [--label TEXT] "
+                         "[--output FILE]\n");
+  }
+
+  return return_value;
+}
+
+}  // namespace
+
+// MAIN ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Options options;
+  std::FILE* output = stdout;
+
+  if (!ParseOptions(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+  if (options.output_path != nullptr) {
+    output = std::fopen(options.output_path, "a");
+    if (output == nullptr) {
+      std::fprintf(stderr, "cannot write %s\n", options.output_path);
+      return EXIT_FAILURE;
+    }
+  }
+
+  tkrandom::sim::InitFirmware();
+  tkrandom::MicroBench bench(
+      tkrandom::sim::transmitter, tkrandom::sim::generator,
+      tkrandom::sim::rng_handler,
+      options.is_host_clock ? &HostNanoseconds : &SimulatedCycles,
+      options.is_host_clock ? 1000000000U : tkrandom::sim::Mcu::kCoreClock);
+  bench.Run(options.iterations);
+
+  char json[1024];
+  const uint32_t length = bench.WriteJson(json, sizeof(json));
+  std::fprintf(output, "{\"label\":\"%s\",\"clock\":\"%s\",\"bench\":%s}\n",
+               options.label, options.is_host_clock ? "host-ns" : "sim-cycles",
+               json);
+  if (output != stdout) {
+    std::fclose(output);
+  }
+
+  int return_value = EXIT_SUCCESS;
+  if (length >= sizeof(json)) {
+    std::fprintf(stderr, "JSON truncated\n");
+    return_value = EXIT_FAILURE;
+  }
+  return return_value;
+}
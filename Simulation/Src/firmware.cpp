@@ -0,0 +1,225 @@
+//! \brief     Composition root of the firmware on the simulated MCU.
+//! \details   Mirrors the objects, peripheral initialization and callbacks of
+//!            Core/Src/main.c.
+//! \file      firmware.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "firmware.hpp"
+
+#include <new>
+
+#include "board.hpp"
+#include "trace_log.hpp"
+
+// MICS ------------------------------------------------------------------------
+RNG_HandleTypeDef hrng;
+SPI_HandleTypeDef hspi1;
+TIM_HandleTypeDef htim6;
+TIM_HandleTypeDef htim15;
+TIM_HandleTypeDef htim16;
+
+namespace tkrandom {
+namespace sim {
+
+constinit PcbStatusLed pcb_status_led;
+constinit Transmitter transmitter(&hspi1);
+constinit Generator generator(&hrng);
+constinit LedRefresher led_refresher(transmitter);
+constinit CvInputs cv_inputs;
+constinit RngHandler rng_handler(generator, transmitter, led_refresher,
+                                 cv_inputs);
+constinit NoiseHandler noise_handler(generator, transmitter, &htim15);
+constinit Animation animation(led_refresher);
+constinit SwitchDebouncer switch_debouncer;
+constinit Scheduler scheduler;
+constinit Supervisor supervisor(transmitter, generator, pcb_status_led);
+constinit EventHandler event_handler(supervisor,
+                                     rng_handler,
+                                     animation,
+                                     noise_handler,
+                                     switch_debouncer,
+                                     scheduler,
+                                     &htim16);
+constinit PowerManager power_manager(transmitter, &htim6, &htim15, &htim16);
+constinit SettingsJournal settings_journal;
+constinit SettingsManager settings_manager(settings_journal, event_handler,
+                                           rng_handler, generator,
+                                           power_manager, noise_handler);
+constinit CoroutineExecutor coroutine_executor(generator);
+
+namespace {
+
+//! runs the constructor of a firmware object again, like a power cycle
+template <typename T, typename... Args>
+void Reconstruct(T& object, Args&&... args) {
+  object.~T();
+  new (&object) T(static_cast<Args&&>(args)...);
+}
+
+//! peripheral initialization of main.c, only what the simulation models
+void InitPeripherals() {
+  hrng = {};
+  hrng.Instance = RNG;
+  HAL_RNG_Init(&hrng);
+
+  hspi1 = {};
+  hspi1.Instance = SPI1;
+  hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2;
+  HAL_SPI_Init(&hspi1);
+
+  htim6 = {};
+  htim6.Instance = TIM6;
+  htim6.Init.Prescaler = 47U;
+  htim6.Init.Period = 999U;
+  HAL_TIM_Base_Init(&htim6);
+  HAL_TIM_Base_Start_IT(&htim6);
+
+  htim15 = {};
+  htim15.Instance = TIM15;
+  htim15.Init.Prescaler = 0U;
+  htim15.Init.Period = 999U;
+  HAL_TIM_Base_Init(&htim15);
+
+  htim16 = {};
+  htim16.Instance = TIM16;
+  htim16.Init.Prescaler = 47U;
+  htim16.Init.Period = 499U;
+  HAL_TIM_Base_Init(&htim16);
+
+  Mcu::EnableExti(board::Gate1::kMask | board::Gate2::kMask);
+}
+
+}  // namespace
+
+// FUNCTION DEFINITIONS --------------------------------------------------------
+void InitFirmware(const uint16_t random_seed) {
+  Mcu::Init();
+  Reconstruct(pcb_status_led);
+  Reconstruct(transmitter, &hspi1);
+  Reconstruct(generator, &hrng);
+  Reconstruct(led_refresher, transmitter);
+  Reconstruct(cv_inputs);
+  Reconstruct(rng_handler, generator, transmitter, led_refresher, cv_inputs);
+  Reconstruct(noise_handler, generator, transmitter, &htim15);
+  Reconstruct(animation, led_refresher);
+  Reconstruct(switch_debouncer);
+  Reconstruct(scheduler);
+  Reconstruct(supervisor, transmitter, generator, pcb_status_led);
+  Reconstruct(event_handler, supervisor, rng_handler, animation,
+              noise_handler, switch_debouncer, scheduler, &htim16);
+  Reconstruct(power_manager, transmitter, &htim6, &htim15, &htim16);
+  Reconstruct(settings_journal);
+  Reconstruct(settings_manager, settings_journal, event_handler, rng_handler,
+              generator, power_manager, noise_handler);
+  Reconstruct(coroutine_executor, generator);
+
+  TraceLog::Init();
+  InitPeripherals();
+  settings_journal.Init();
+  settings_manager.ApplySeed();
+  if (random_seed != 0U) {
+    generator.SetSeed(random_seed);
+  }
+  event_handler.Init();
+  settings_manager.ApplySettings();
+  coroutine_executor.Spawn(pcb_status_led.Run(coroutine_executor));
+  supervisor.Init();
+}
+//------------------------------------------------------------------------------
+void RunFirmware(const uint64_t limit) {
+  while (Mcu::GetCycles() < limit) {
+    supervisor.Process();
+    event_handler.Run();
+    coroutine_executor.RunReady();
+    settings_manager.Process();
+    Mcu::Charge(kMainLoopCycles);
+  }
+}
+
+}  // namespace sim
+}  // namespace tkrandom
+
+// CALLBACKS -------------------------------------------------------------------
+using tkrandom::sim::coroutine_executor;
+using tkrandom::sim::cv_inputs;
+using tkrandom::sim::event_handler;
+using tkrandom::sim::noise_handler;
+using tkrandom::sim::settings_journal;
+using tkrandom::sim::supervisor;
+using tkrandom::sim::transmitter;
+
+void PendSV_Callback(void) {
+  event_handler.ProcessGates();
+}
+
+void HAL_FLASH_EndOfOperationCallback(uint32_t return_value) {
+  static_cast<void>(return_value);
+  settings_journal.ProcessOperationComplete();
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t return_value) {
+  static_cast<void>(return_value);
+  tkrandom::TraceLog::Log(tkrandom::TraceEvent::kFlashError,
+                          HAL_FLASH_GetError());
+  settings_journal.ProcessOperationError();
+}
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim) {
+  if (htim->Instance == TIM6) {
+    event_handler.SignalEvent(tkrandom::Event::kTimerElapsed);
+    coroutine_executor.ProcessTick();
+    cv_inputs.ProcessTick();
+    supervisor.ProcessTick();
+  }
+  // sample timer of the noise output
+  if (htim->Instance == TIM15) {
+    noise_handler.ProcessSampleTick();
+  }
+  // track timer of the track-and-hold mode
+  if (htim->Instance == TIM16) {
+    event_handler.SignalEvent(tkrandom::Event::kTrackTick);
+  }
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi) {
+  if (hspi->Instance == SPI1) {
+    transmitter.ProcessTransferComplete();
+    coroutine_executor.Signal(tkrandom::CoroutineEvent::kTransferComplete);
+  }
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi) {
+  if (hspi->Instance == SPI1) {
+    transmitter.ProcessTransferError();
+    supervisor.ReportFault(tkrandom::Fault::kTransfer);
+  }
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t gpio_pin) {
+  // EXTI line for IN_1, inverted input stage: low pin level is an open gate
+  if (gpio_pin == tkrandom::board::Gate1::kMask) {
+    if (!tkrandom::board::Gate1::IsSet()) {
+      event_handler.SignalEvent(tkrandom::Event::kGate1Triggered);
+      coroutine_executor.Signal(tkrandom::CoroutineEvent::kGate1Opened);
+    }
+    else {
+      event_handler.SignalEvent(tkrandom::Event::kGate1Released);
+    }
+  }
+  // EXTI line for IN_2
+  if (gpio_pin == tkrandom::board::Gate2::kMask) {
+    if (!tkrandom::board::Gate2::IsSet()) {
+      event_handler.SignalEvent(tkrandom::Event::kGate2Triggered);
+      coroutine_executor.Signal(tkrandom::CoroutineEvent::kGate2Opened);
+    }
+    else {
+      event_handler.SignalEvent(tkrandom::Event::kGate2Released);
+    }
+  }
+}
@@ -0,0 +1,753 @@
+//! \brief     Command line tool that checks firmware features on the simulated
+//!            MCU.
+//! \details   Each check powers up the firmware, drives one feature through
+//!            its public interface and compares the observed behavior with
+//!            the specification.
+//! \file      firmware_checks.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+//
+//  usage: firmware_checks --check NAME
+//    profiles   switches the performance profiles at runtime and measures the
+//               tick, sample and track timer rates and the SPI clock
+//    journal    changes settings by host commands, fills the journal pages
+//               until they are compacted with failing flash operations,
+//               reboots and reads the settings back
+//    noise      streams each noise color by host commands and compares the
+//               sample rate, mean, deviation and lag-1 correlation
+//    chaos      selects chaotic sources by host commands, compares the gated
+//               logistic map with a reference and runs a perturbed Henon map
+//               on the internal clock, drives the Henon map out of its basin
+//    faults     reports a recoverable and a fatal fault and checks recovery
+//               and the IWDG feed
+//    spi        sends DAC frames by the register path, checks byte order, NSS,
+//               the RX FIFO overrun and the recovery of a stalled SPI
+
+// INCLUDES --------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "board.hpp"
+#include "chaos_generator.hpp"
+#include "firmware.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace {
+
+using tkrandom::PerformanceProfile;
+using tkrandom::SettingKey;
+using tkrandom::SettingsManagerStatus;
+using tkrandom::sim::Mcu;
+
+//! check with its command line name
+struct Check {
+  const char* name;    //!< value of --check
+  bool (*run)(void);   //!< returns true if the check passed
+};
+
+//! runs the main loop for a time
+void RunFor(const uint64_t microseconds) {
+  tkrandom::sim::RunFirmware(Mcu::GetCycles() + Mcu::ToCycles(microseconds));
+}
+
+//! measures the update rate of a timer over a window
+//! \return updates per second
+double MeasureRate(const TIM_TypeDef* const instance,
+                   const uint64_t microseconds) {
+  const uint64_t start = Mcu::GetTimerUpdates(instance);
+  RunFor(microseconds);
+  return static_cast<double>(Mcu::GetTimerUpdates(instance) - start) *
+         1000000.0 / static_cast<double>(microseconds);
+}
+
+//! true if a rate is within 1 % of its nominal value
+bool IsRateValid(const double rate, const double nominal) {
+  return (rate > (nominal * 0.99)) && (rate < (nominal * 1.01));
+}
+
+//! measures the time per random word, drawn back to back
+//! \return microseconds per word, 0.0 if a word was missing
+double MeasureWordTime() {
+  const uint32_t words = 256U;
+  uint32_t word = 0U;
+  bool is_drawn = true;
+
+  tkrandom::sim::generator.GetRandomWord(&word);  // starts a fresh word
+  const uint64_t start = Mcu::GetCycles();
+  for (uint32_t index = 0U; index < words; ++index) {
+    is_drawn = is_drawn && (tkrandom::sim::generator.GetRandomWord(&word) ==
+                            tkrandom::GeneratorStatus::kSuccess);
+  }
+  const double word_time = static_cast<double>(Mcu::GetCycles() - start) *
+                           1000000.0 / Mcu::kCoreClock / words;
+  return is_drawn ? word_time : 0.0;
+}
+
+//! profile switches of the profiles check
+struct ProfileStep {
+  const char* name;             //!< name in the report
+  PerformanceProfile profile;   //!< profile switched to
+  uint32_t hclk;                //!< expected HCLK in Hz
+  double word_time;             //!< 42 MSI cycles per RNG word in us
+};
+
+//! every transition between two profiles occurs at least once
+const ProfileStep kProfileSteps[] = {
+    {"standard", PerformanceProfile::kStandard, 48000000U, 0.875},
+    {"turbo", PerformanceProfile::kTurbo, 80000000U, 0.875},
+    {"lowclock", PerformanceProfile::kLowClock, 4000000U, 10.5},
+    {"turbo", PerformanceProfile::kTurbo, 80000000U, 0.875},
+    {"standard", PerformanceProfile::kStandard, 48000000U, 0.875},
+    {"lowclock", PerformanceProfile::kLowClock, 4000000U, 10.5},
+    {"standard", PerformanceProfile::kStandard, 48000000U, 0.875}};
+
+//! switches the profiles while noise and track-and-hold run
+bool CheckProfiles() {
+  using tkrandom::sim::event_handler;
+  bool return_value = true;
+  const uint32_t track_rate = 1000U;
+  const uint64_t window = 200000U;
+
+  // all three retuned timers run: TIM6 always, TIM15 for the noise output,
+  // TIM16 while gate 1 is open in track-and-hold mode
+  tkrandom::sim::InitFirmware();
+  event_handler.SetHoldModes(tkrandom::HoldMode::kTrackAndHold,
+                             tkrandom::HoldMode::kSampleAndHold);
+  event_handler.SetTrackRate(track_rate);
+  tkrandom::sim::noise_handler.Start(tkrandom::Output::kOutput4,
+                                     tkrandom::NoiseColor::kWhite);
+  Mcu::ScheduleInput(Mcu::GetCycles(), tkrandom::PortB::Regs(),
+                     tkrandom::board::Gate1::kMask, false);
+  RunFor(10000U);
+
+  for (const ProfileStep& step : kProfileSteps) {
+    const bool is_switched =
+        tkrandom::sim::power_manager.SetProfile(step.profile) ==
+        tkrandom::PowerManagerStatus::kSuccess;
+    // the new prescalers are preloaded until the next update event
+    RunFor(5000U);
+    const uint32_t hclk = HAL_RCC_GetHCLKFreq();
+    const uint32_t spi_clock =
+        hclk >> (((hspi1.Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos) + 1U);
+    const double tick_rate = MeasureRate(TIM6, window);
+    const double sample_rate = MeasureRate(TIM15, window);
+    const double track_tick_rate = MeasureRate(TIM16, window);
+    const double word_time = MeasureWordTime();
+    const bool is_valid =
+        is_switched && (hclk == step.hclk) && (spi_clock <= 24000000U) &&
+        IsRateValid(tick_rate, 1000.0) && IsRateValid(sample_rate, 48000.0) &&
+        IsRateValid(track_tick_rate, track_rate) &&
+        (word_time > (step.word_time * 0.99)) &&
+        (word_time < (step.word_time * 1.5));
+    std::printf("profiles: %-8s hclk %8u Hz spi %8u Hz tick %7.1f Hz "
+                "sample %8.1f Hz track %7.1f Hz word %5.2f us %s\n",
+                step.name, hclk, spi_clock, tick_rate, sample_rate,
+                track_tick_rate, word_time, is_valid ? "ok" : "FAIL");
+    return_value = return_value && is_valid;
+  }
+
+  return return_value;
+}
+
+//! posts a setting command like the debugger and waits until it is handled
+//! \return status of the command
+SettingsManagerStatus PostCommand(const SettingKey key, const uint16_t value) {
+  tkrandom::sim::settings_manager.PostCommand(key, value);
+  RunFor(1000U);
+  const tkrandom::SettingsCommand& command =
+      tkrandom::sim::settings_manager.GetCommand();
+  return command.is_pending ? SettingsManagerStatus::kError : command.status;
+}
+
+//! compares a setting of the journal with its expected value
+bool IsStored(const SettingKey key, const uint16_t expected) {
+  uint16_t value = 0U;
+  return (tkrandom::sim::settings_journal.Read(key, &value) ==
+          tkrandom::SettingsJournalStatus::kSuccess) &&
+         (value == expected);
+}
+
+//! setting commands of the journal check
+struct SettingStep {
+  SettingKey key;                 //!< key of the setting
+  uint16_t value;                 //!< value sent by the host
+  SettingsManagerStatus status;   //!< expected result
+};
+
+//! valid and invalid settings, the last valid value of a key is kept
+const SettingStep kSettingSteps[] = {
+    {SettingKey::kHoldMode1, 1U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kTrackRate, 250U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kPerformanceProfile, 2U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kNoiseOutput, 4U, SettingsManagerStatus::kRejected},
+    {SettingKey::kPerformanceProfile, 1U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kNoiseOutput, 4U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kPerformanceProfile, 2U, SettingsManagerStatus::kRejected},
+    {SettingKey::kNoiseOutput, 0U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kLedDecay, 3U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kRandomSeed, 1234U, SettingsManagerStatus::kSuccess},
+    {SettingKey::kPerformanceProfile, 7U, SettingsManagerStatus::kRejected},
+    {SettingKey::kHoldMode2, 2U, SettingsManagerStatus::kRejected},
+    {SettingKey::kCount, 0U, SettingsManagerStatus::kRejected}};
+
+//! writes settings through the host commands and reads them back after a
+//! power cycle
+bool CheckJournal() {
+  using tkrandom::sim::settings_journal;
+  bool return_value = true;
+  const uint32_t rewrites = 600U;
+
+  tkrandom::sim::InitFirmware();
+  uint16_t value = 0U;
+  const bool is_empty = settings_journal.Read(SettingKey::kTrackRate, &value) ==
+                        tkrandom::SettingsJournalStatus::kNotFound;
+  std::printf("journal: empty at first start %s\n", is_empty ? "ok" : "FAIL");
+  return_value = return_value && is_empty;
+
+  uint32_t step_index = 0U;
+  for (const SettingStep& step : kSettingSteps) {
+    const SettingsManagerStatus status = PostCommand(step.key, step.value);
+    const bool is_valid = status == step.status;
+    std::printf("journal: command %u key %u value %u status %u %s\n",
+                step_index, static_cast<uint32_t>(step.key), step.value,
+                static_cast<uint32_t>(status), is_valid ? "ok" : "FAIL");
+    return_value = return_value && is_valid;
+    ++step_index;
+  }
+  const bool is_live = (HAL_RCC_GetHCLKFreq() == 80000000U) &&
+                       (htim16.Instance->ARR == 3999U);
+  std::printf("journal: applied at runtime %s\n", is_live ? "ok" : "FAIL");
+  return_value = return_value && is_live;
+
+  // 256 double words per page, the rewrites compact the journal twice, the
+  // failed appends and compactions are retried
+  Mcu::SetFlashFailures(13U);
+  bool is_accepted = true;
+  for (uint32_t index = 0U; index < rewrites; ++index) {
+    is_accepted = is_accepted &&
+                  (PostCommand(SettingKey::kTrackRate,
+                               static_cast<uint16_t>(100U + index)) ==
+                   SettingsManagerStatus::kSuccess);
+  }
+  RunFor(100000U);
+  const uint16_t track_rate = static_cast<uint16_t>(100U + rewrites - 1U);
+  std::printf("journal: %u rewrites of the track rate, every 13th flash "
+              "operation failing %s\n", rewrites, is_accepted ? "ok" : "FAIL");
+  return_value = return_value && is_accepted;
+
+  // the retries run out and the host reads the error, the next command
+  // starts another attempt
+  Mcu::SetFlashFailures(1U);
+  PostCommand(SettingKey::kLedDecay, 5U);
+  RunFor(10000U);
+  const bool is_surfaced = tkrandom::sim::settings_manager.GetCommand().status ==
+                           SettingsManagerStatus::kError;
+  Mcu::SetFlashFailures(0U);
+  const bool is_retried =
+      PostCommand(SettingKey::kLedDecay, 6U) == SettingsManagerStatus::kSuccess;
+  RunFor(10000U);
+  std::printf("journal: failing flash reported %s, retried %s\n",
+              is_surfaced ? "ok" : "FAIL", is_retried ? "ok" : "FAIL");
+  return_value = return_value && is_surfaced && is_retried;
+
+  // power cycle, the flash pages keep their content
+  tkrandom::sim::InitFirmware();
+  const bool is_read_back =
+      IsStored(SettingKey::kHoldMode1, 1U) &&
+      IsStored(SettingKey::kTrackRate, track_rate) &&
+      IsStored(SettingKey::kPerformanceProfile, 1U) &&
+      IsStored(SettingKey::kLedDecay, 6U) &&
+      IsStored(SettingKey::kRandomSeed, 1234U) &&
+      (settings_journal.Read(SettingKey::kHoldMode2, &value) ==
+       tkrandom::SettingsJournalStatus::kNotFound);
+  std::printf("journal: read back after reboot %s\n",
+              is_read_back ? "ok" : "FAIL");
+  return_value = return_value && is_read_back;
+
+  // applied again: profile, track rate, seed and track-and-hold on gate 1
+  const uint64_t track_ticks = Mcu::GetTimerUpdates(TIM16);
+  Mcu::ScheduleInput(Mcu::GetCycles(), tkrandom::PortB::Regs(),
+                     tkrandom::board::Gate1::kMask, false);
+  RunFor(500000U);
+  const double track_tick_rate =
+      static_cast<double>(Mcu::GetTimerUpdates(TIM16) - track_ticks) * 2.0;
+  const bool is_reapplied = (HAL_RCC_GetHCLKFreq() == 80000000U) &&
+                            (tkrandom::sim::generator.GetSeed() == 1234U) &&
+                            IsRateValid(track_tick_rate, track_rate);
+  std::printf("journal: applied after reboot, track %.1f Hz %s\n",
+              track_tick_rate, is_reapplied ? "ok" : "FAIL");
+  return_value = return_value && is_reapplied;
+
+  return return_value;
+}
+
+//! samples of one DAC channel
+struct ChannelRecord {
+  uint8_t channel;                //!< recorded DAC channel
+  std::vector<uint16_t> values;   //!< values in time order
+};
+
+//! appends the updates of the recorded channel
+void OnDacUpdate(const tkrandom::sim::DacUpdate& update, void* context) {
+  ChannelRecord* const record = static_cast<ChannelRecord*>(context);
+  if (update.channel == record->channel) {
+    record->values.push_back(update.value);
+  }
+}
+
+//! expected statistics of one noise color, in DAC steps
+struct NoiseStep {
+  const char* name;               //!< name in the report
+  tkrandom::NoiseColor color;     //!< color switched to
+  double max_offset;              //!< largest distance of the mean to 0x8000
+  double min_deviation;           //!< lower limit of the standard deviation
+  double max_deviation;           //!< upper limit of the standard deviation
+  double min_correlation;         //!< lower limit of the lag-1 correlation
+  double max_correlation;         //!< upper limit of the lag-1 correlation
+};
+
+//! white noise is uniform and uncorrelated, the mean of the correlated
+//! colors wanders more, brown noise follows its leak of 1/64
+const NoiseStep kNoiseSteps[] = {
+    {"white", tkrandom::NoiseColor::kWhite, 512.0, 18000.0, 19500.0, -0.05,
+     0.05},
+    {"pink", tkrandom::NoiseColor::kPink, 2048.0, 5000.0, 11000.0, 0.5, 0.9},
+    {"brown", tkrandom::NoiseColor::kBrown, 4096.0, 4000.0, 11000.0, 0.97,
+     0.995}};
+
+//! streams the noise colors to output 4 and checks the sample statistics
+bool CheckNoise() {
+  bool return_value = true;
+  const uint64_t window = 500000U;
+  // output 4 is DAC channel 3
+  const uint16_t output = static_cast<uint16_t>(tkrandom::Output::kOutput4);
+  ChannelRecord record = {static_cast<uint8_t>(output), {}};
+
+  tkrandom::sim::InitFirmware();
+  Mcu::GetDac().SetListener(&OnDacUpdate, &record);
+  for (const NoiseStep& step : kNoiseSteps) {
+    const bool is_accepted =
+        (PostCommand(SettingKey::kNoiseColor,
+                     static_cast<uint16_t>(step.color)) ==
+         SettingsManagerStatus::kSuccess) &&
+        (PostCommand(SettingKey::kNoiseOutput, output + 1U) ==
+         SettingsManagerStatus::kSuccess);
+    RunFor(10000U);  // the filters settle
+    record.values.clear();
+    RunFor(window);
+
+    const std::vector<uint16_t>& values = record.values;
+    const double count = static_cast<double>(values.size());
+    double sum = 0.0;
+    for (const uint16_t value : values) {
+      sum += value;
+    }
+    const double mean = (count > 0.0) ? (sum / count) : 0.0;
+    double variance = 0.0;
+    double covariance = 0.0;
+    for (size_t index = 0U; index < values.size(); ++index) {
+      const double deviation = values[index] - mean;
+      variance += deviation * deviation;
+      if (index > 0U) {
+        covariance += deviation * (values[index - 1U] - mean);
+      }
+    }
+    const double deviation = (count > 0.0) ? std::sqrt(variance / count) : 0.0;
+    const double correlation = (variance > 0.0) ? (covariance / variance) : 0.0;
+    const double rate = count * 1000000.0 / static_cast<double>(window);
+    const bool is_valid =
+        is_accepted && IsRateValid(rate, 48000.0) &&
+        (std::fabs(mean - 32768.0) < step.max_offset) &&
+        (deviation > step.min_deviation) &&
+        (deviation < step.max_deviation) &&
+        (correlation > step.min_correlation) &&
+        (correlation < step.max_correlation);
+    std::printf("noise: %-5s rate %8.1f Hz mean %8.1f deviation %7.1f "
+                "correlation %6.3f %s\n",
+                step.name, rate, mean, deviation, correlation,
+                is_valid ? "ok" : "FAIL");
+    return_value = return_value && is_valid;
+  }
+
+  // switched off, the output is handed back to the gates
+  const bool is_stopped =
+      (PostCommand(SettingKey::kNoiseOutput, 0U) ==
+       SettingsManagerStatus::kSuccess) &&
+      (!tkrandom::sim::noise_handler.IsStreaming());
+  record.values.clear();
+  RunFor(10000U);
+  const bool is_silent = is_stopped && record.values.empty();
+  std::printf("noise: off %s\n", is_silent ? "ok" : "FAIL");
+  return_value = return_value && is_silent;
+
+  // the last color is streamed again after a power cycle
+  const bool is_rejected =
+      PostCommand(SettingKey::kNoiseOutput, output + 2U) ==
+      SettingsManagerStatus::kRejected;
+  PostCommand(SettingKey::kNoiseOutput, output + 1U);
+  RunFor(100000U);
+  tkrandom::sim::InitFirmware();
+  record.values.clear();
+  RunFor(10000U);
+  const bool is_restored = is_rejected &&
+                           tkrandom::sim::noise_handler.IsStreaming() &&
+                           (!record.values.empty());
+  std::printf("noise: streamed after reboot %s\n",
+              is_restored ? "ok" : "FAIL");
+  return_value = return_value && is_restored;
+  Mcu::GetDac().SetListener(nullptr, nullptr);
+
+  return return_value;
+}
+
+//! schedules gates of a fixed length at a fixed rate, an open gate is a low
+//! level at the inverting input stage
+void ScheduleGates(GPIO_TypeDef* const port, const uint16_t pin,
+                   const uint32_t count, const uint64_t period) {
+  const uint64_t start = Mcu::GetCycles() + Mcu::ToCycles(1000U);
+  for (uint32_t index = 0U; index < count; ++index) {
+    const uint64_t cycle = start + (index * period);
+    Mcu::ScheduleInput(cycle, port, pin, false);
+    Mcu::ScheduleInput(cycle + (period / 2U), port, pin, true);
+  }
+}
+
+//! counts the values that occur in order on the unperturbed orbit of a map
+//! \details SetSource() steps once, the orbit is searched from there
+uint32_t CountOrbitValues(const std::vector<uint16_t>& values,
+                          const tkrandom::ChaosMap map) {
+  const uint32_t max_steps = 16U;  // steps between two values
+  uint32_t return_value = 0U;
+  tkrandom::ChaosGenerator reference;
+  reference.SetMap(map);
+  reference.Step(0);
+  for (const uint16_t value : values) {
+    uint32_t steps = 0U;
+    while ((reference.GetValue() != value) && (steps < max_steps)) {
+      reference.Step(0);
+      steps++;
+    }
+    if (reference.GetValue() != value) {
+      break;
+    }
+    return_value++;
+  }
+  return return_value;
+}
+
+//! true if a generator continues like one that has just been reset
+bool IsRestarted(tkrandom::ChaosGenerator* const generator,
+                 const tkrandom::ChaosMap map) {
+  const uint32_t steps = 8U;
+  tkrandom::ChaosGenerator reference;
+  reference.SetMap(map);
+  bool return_value = generator->GetValue() == reference.GetValue();
+  for (uint32_t step = 0U; step < steps; ++step) {
+    generator->Step(0);
+    reference.Step(0);
+    return_value =
+        return_value && (generator->GetValue() == reference.GetValue());
+  }
+  return return_value;
+}
+
+//! Henon states that escape from the attractor restart the map
+//! \details from the initial state x = 0.125 one step lands on 1.103125 plus
+//!          the perturbation in 2^-16 units
+bool CheckHenonEscape() {
+  using tkrandom::ChaosMap;
+  const int32_t to_2_4 = 84992;   // x = 2.4, inside the limit
+  const int32_t to_2_9 = 117760;  // x = 2.9, outside the limit
+
+  // 1.4 x^2 of x = 2.4 exceeds Q3.28, the next step escapes to about -7
+  tkrandom::ChaosGenerator near;
+  near.SetMap(ChaosMap::kHenon);
+  near.Step(to_2_4);
+  const bool is_kept = near.GetValue() == 0xFFFFU;
+  near.Step(0);
+  const bool is_near_reset = is_kept && IsRestarted(&near, ChaosMap::kHenon);
+
+  tkrandom::ChaosGenerator far;
+  far.SetMap(ChaosMap::kHenon);
+  far.Step(to_2_9);
+  const bool is_far_reset = IsRestarted(&far, ChaosMap::kHenon);
+
+  const bool return_value = is_near_reset && is_far_reset;
+  std::printf("chaos: henon escape from x = 2.4 and 2.9 restarts %s\n",
+              return_value ? "ok" : "FAIL");
+  return return_value;
+}
+
+//! selects chaotic sources and drives them by gates
+bool CheckChaos() {
+  using tkrandom::ChaosClock;
+  using tkrandom::ChaosMap;
+  using tkrandom::Output;
+  using tkrandom::Source;
+  bool return_value = CheckHenonEscape();
+  const uint32_t gate_count = 200U;
+  const uint32_t clocked_count = 20U;
+
+  tkrandom::sim::InitFirmware();
+  ChannelRecord record = {static_cast<uint8_t>(Output::kOutput1), {}};
+  Mcu::GetDac().SetListener(&OnDacUpdate, &record);
+
+  // logistic map on output 1 stepped by gate 1, every gate steps after its
+  // output, the neutral CV parameters pass the values unchanged
+  const bool is_logistic =
+      (PostCommand(SettingKey::kChaosClock,
+                   static_cast<uint16_t>(ChaosClock::kGate)) ==
+       SettingsManagerStatus::kSuccess) &&
+      (PostCommand(SettingKey::kChaosSources,
+                   static_cast<uint16_t>(Source::kLogistic)) ==
+       SettingsManagerStatus::kSuccess);
+  record.values.clear();
+  ScheduleGates(tkrandom::PortB::Regs(), tkrandom::board::Gate1::kMask,
+                gate_count, Mcu::ToCycles(1000U));
+  RunFor((gate_count + 10U) * 1000U);
+  tkrandom::ChaosGenerator reference;
+  reference.SetMap(ChaosMap::kLogistic);
+  reference.Step(0);
+  uint32_t matches = 0U;
+  for (const uint16_t value : record.values) {
+    if (value == reference.GetValue()) {
+      matches++;
+    }
+    reference.Step(0);
+  }
+  const bool is_gated = is_logistic && (record.values.size() == gate_count) &&
+                        (matches == gate_count);
+  std::printf("chaos: logistic on gate 1, %zu values, %u match %s\n",
+              record.values.size(), matches, is_gated ? "ok" : "FAIL");
+  return_value = return_value && is_gated;
+
+  // Henon map on output 4 stepped by the internal 16 Hz clock, gates slower
+  // than the clock read a later state of its orbit each
+  record = {static_cast<uint8_t>(Output::kOutput4), {}};
+  const uint16_t sources = static_cast<uint16_t>(
+      static_cast<uint32_t>(Source::kHenon)
+      << (2U * static_cast<uint32_t>(Output::kOutput4)));
+  const bool is_henon =
+      (PostCommand(SettingKey::kChaosSources, sources) ==
+       SettingsManagerStatus::kSuccess) &&
+      (PostCommand(SettingKey::kChaosClock,
+                   static_cast<uint16_t>(ChaosClock::kInternal)) ==
+       SettingsManagerStatus::kSuccess);
+  record.values.clear();
+  ScheduleGates(tkrandom::PortA::Regs(), tkrandom::board::Gate2::kMask,
+                clocked_count, Mcu::ToCycles(100000U));
+  RunFor((clocked_count + 1U) * 100000U);
+  const uint32_t orbit_values =
+      CountOrbitValues(record.values, ChaosMap::kHenon);
+  const bool is_internal = is_henon &&
+                           (record.values.size() == clocked_count) &&
+                           (orbit_values == clocked_count);
+  std::printf("chaos: henon on the internal clock, %zu values, %u on the "
+              "orbit %s\n",
+              record.values.size(), orbit_values,
+              is_internal ? "ok" : "FAIL");
+  return_value = return_value && is_internal;
+
+  // the perturbation moves the restarted map off its orbit
+  const bool is_perturbed =
+      (PostCommand(SettingKey::kChaosPerturbation, 1U) ==
+       SettingsManagerStatus::kSuccess) &&
+      (PostCommand(SettingKey::kChaosPerturbation, 2U) ==
+       SettingsManagerStatus::kRejected) &&
+      (PostCommand(SettingKey::kChaosSources, 0U) ==
+       SettingsManagerStatus::kSuccess) &&
+      (PostCommand(SettingKey::kChaosSources, sources) ==
+       SettingsManagerStatus::kSuccess);
+  record.values.clear();
+  ScheduleGates(tkrandom::PortA::Regs(), tkrandom::board::Gate2::kMask,
+                clocked_count, Mcu::ToCycles(100000U));
+  RunFor((clocked_count + 1U) * 100000U);
+  const uint32_t perturbed_values =
+      CountOrbitValues(record.values, ChaosMap::kHenon);
+  const bool is_diverged = is_perturbed &&
+                           (record.values.size() == clocked_count) &&
+                           (perturbed_values < clocked_count);
+  std::printf("chaos: perturbed henon, %zu values, %u on the orbit %s\n",
+              record.values.size(), perturbed_values,
+              is_diverged ? "ok" : "FAIL");
+  return_value = return_value && is_diverged;
+  Mcu::GetDac().SetListener(nullptr, nullptr);
+
+  return return_value;
+}
+
+//! true if the IWDG has been fed since the key register was cleared
+bool IsWatchdogFed() {
+  return IWDG->KR == 0xAAAAU;
+}
+
+//! reports faults after the start like Error_Handler() does
+bool CheckFaults() {
+  using tkrandom::Fault;
+  using tkrandom::sim::supervisor;
+  bool return_value = true;
+
+  tkrandom::sim::InitFirmware();
+  RunFor(10000U);
+  const bool is_started = supervisor.IsStarted();
+  std::printf("faults: IWDG started %s\n", is_started ? "ok" : "FAIL");
+  return_value = return_value && is_started;
+
+  // SPI, DAC and RNG are reinitialized and the IWDG stays fed
+  const uint32_t recoveries = supervisor.GetStatistics().recoveries;
+  supervisor.ReportFault(Fault::kGeneral);
+  IWDG->KR = 0U;
+  RunFor(200000U);
+  const bool is_recovered =
+      (supervisor.GetStatistics().recoveries == recoveries + 1U) &&
+      IsWatchdogFed();
+  std::printf("faults: general fault recovered %s\n",
+              is_recovered ? "ok" : "FAIL");
+  return_value = return_value && is_recovered;
+
+  // a peripheral that did not start is never reported as recovered, the
+  // IWDG is no longer fed and resets the MCU
+  supervisor.ReportFault(Fault::kFatal);
+  RunFor(1000U);
+  IWDG->KR = 0U;
+  RunFor(200000U);
+  const bool is_fatal =
+      (supervisor.GetStatistics().recoveries == recoveries + 1U) &&
+      (supervisor.Process() == tkrandom::SupervisorStatus::kError) &&
+      (!IsWatchdogFed());
+  std::printf("faults: fatal fault starves the IWDG %s\n",
+              is_fatal ? "ok" : "FAIL");
+  return_value = return_value && is_fatal;
+
+  // the NMI of a double ECC error resumes only inside the journal pages, the
+  // last 4 KB of the flash, and never leaves ECCD set
+  FLASH->ECCR = 0xF008U;
+  FLASH->SR |= FLASH_FLAG_ECCD;
+  const bool is_resumed = tkrandom::SettingsJournal::HandleEccError() &&
+                          (__HAL_FLASH_GET_FLAG(FLASH_FLAG_ECCD) == 0U);
+  FLASH->ECCR = 0x0100U;
+  FLASH->SR |= FLASH_FLAG_ECCD;
+  const bool is_ecc_fatal = (!tkrandom::SettingsJournal::HandleEccError()) &&
+                            (__HAL_FLASH_GET_FLAG(FLASH_FLAG_ECCD) == 0U);
+  const bool is_other_nmi = !tkrandom::SettingsJournal::HandleEccError();
+  std::printf("faults: ECC error in the journal resumed %s, in the code "
+              "fatal %s, other NMI fatal %s\n", is_resumed ? "ok" : "FAIL",
+              is_ecc_fatal ? "ok" : "FAIL", is_other_nmi ? "ok" : "FAIL");
+  return_value = return_value && is_resumed && is_ecc_fatal && is_other_nmi;
+
+  return return_value;
+}
+
+#if !defined(TKRANDOM_SPI_HAL)
+//! true if the DAC chip select is released
+bool IsNssHigh() {
+  return (tkrandom::PortA::Regs()->ODR & tkrandom::board::DacNss::kMask) != 0U;
+}
+
+//! values whose bytes differ, a swapped or lost byte changes the DAC value
+const uint16_t kSpiValues[] = {0x1234U, 0xA55AU, 0x00FFU, 0xFF00U};
+#endif
+
+//! sends blocking DAC frames by the register path of Transmitter::WriteFrame()
+bool CheckSpi() {
+  bool return_value = true;
+
+  tkrandom::sim::InitFirmware();
+  RunFor(1000U);
+#if defined(TKRANDOM_SPI_HAL)
+  std::printf("spi: register path not built, TKRANDOM_SPI_HAL\n");
+#else
+  using tkrandom::Output;
+  using tkrandom::TransmitterStatus;
+  using tkrandom::sim::transmitter;
+  tkrandom::sim::VirtualDac& dac = Mcu::GetDac();
+  const uint64_t frame_errors = dac.GetFrameErrorCount();
+
+  // every frame is latched by its own NSS pulse with the bytes in order
+  bool is_latched = true;
+  for (const uint16_t value : kSpiValues) {
+    for (uint8_t output = 0U; output <= 3U; ++output) {
+      is_latched = is_latched &&
+                   (transmitter.SetVoltage(static_cast<Output>(output),
+                                           value) ==
+                    TransmitterStatus::kSuccess) &&
+                   (dac.GetValue(output) == value) && IsNssHigh();
+    }
+  }
+  is_latched = is_latched && (dac.GetFrameErrorCount() == frame_errors) &&
+               ((SPI1->SR & SPI_SR_FRLVL) == 0U);
+  std::printf("spi: byte order and NSS of %zu frames, %u cycles per frame "
+              "%s\n", sizeof(kSpiValues) / sizeof(kSpiValues[0]) * 4U,
+              transmitter.GetFrameCycles(), is_latched ? "ok" : "FAIL");
+  return_value = return_value && is_latched;
+
+  // DMA frames fill the RX FIFO up to an overrun, which is cleared first
+  transmitter.QueueLedBrightness(tkrandom::Led::kLed1, 0x8000U);
+  transmitter.QueueLedBrightness(tkrandom::Led::kLed2, 0x8000U);
+  RunFor(100U);
+  const bool is_drained =
+      (transmitter.SetVoltage(Output::kOutput1, 0x4321U) ==
+       TransmitterStatus::kSuccess) &&
+      (dac.GetValue(0U) == 0x4321U) &&
+      ((SPI1->SR & (SPI_SR_FRLVL | SPI_SR_OVR)) == 0U);
+  std::printf("spi: overrun of DMA frames cleared %s\n",
+              is_drained ? "ok" : "FAIL");
+  return_value = return_value && is_drained;
+
+  // a stuck SPI times out, NSS is released and the HAL resends the frame
+  Mcu::SetSpiStall(true);
+  const bool is_recovered =
+      (transmitter.SetVoltage(Output::kOutput3, 0xBEEFU) ==
+       TransmitterStatus::kSuccess) &&
+      (dac.GetValue(2U) == 0xBEEFU) && IsNssHigh() &&
+      (dac.GetFrameErrorCount() == frame_errors + 1U);
+  std::printf("spi: stalled frame recovered after %u cycles %s\n",
+              transmitter.GetFrameCycles(), is_recovered ? "ok" : "FAIL");
+  return_value = return_value && is_recovered;
+  Mcu::SetSpiStall(false);
+#endif
+
+  return return_value;
+}
+
+//! checks of the tool
+const Check kChecks[] = {
+    {"profiles", &CheckProfiles},
+    {"journal", &CheckJournal},
+    {"noise", &CheckNoise},
+    {"chaos", &CheckChaos},
+    {"faults", &CheckFaults},
+    {"spi", &CheckSpi}};
+
+}  // namespace
+
+// MAIN ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  const Check* check = nullptr;
+
+  if ((argc == 3) && (std::strcmp(argv[1], "--check") == 0)) {
+    for (const Check& candidate : kChecks) {
+      if (std::strcmp(argv[2], candidate.name) == 0) {
+        check = &candidate;
+      }
+    }
+  }
+  if (check == nullptr) {
+    std::fprintf(stderr, "usage: firmware_checks --check NAME, NAME is one "
+                         "of:");
+    for (const Check& candidate : kChecks) {
+      std::fprintf(stderr, " %s", candidate.name);
+    }
+    std::fprintf(stderr, "\n");
+    return EXIT_FAILURE;
+  }
+
+  return check->run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,330 @@
+//! \brief     Benchmark that replays the reference gate scenarios on the
+//!            simulated MCU.
+//! \details   Reports captured, merged and dropped gates, gate to output
+//!            latency percentiles and the highest sustainable gate rate per
+//!            scenario and distribution configuration.
+//! \file      gate_bench.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+//
+//  usage: gate_bench [options]
+//    --rate HZ      gate rate of the latency run, default 5000
+//    --gates N      gates per input and run, default 1000
+//    --csv          comma separated output
+//    --check        exit code 1 if the latency run drops or merges a gate
+//
+//  A gate counts as dropped if the EXTI line was still pending at its opening
+//  edge, as merged if the gate work of the previous gate had not started yet.
+//  The latency is measured from the opening edge to the latched DAC update of
+//  output 1 (IN_1) or output 4 (IN_2). A rate is sustainable if no gate is
+//  dropped or merged and every gate is answered.
+
+// INCLUDES --------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "board.hpp"
+#include "firmware.hpp"
+#include "gate_scenario.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace {
+
+using tkrandom::GateEdge;
+using tkrandom::GateScenario;
+using tkrandom::GateScenarioConfig;
+using tkrandom::sim::Mcu;
+
+//! command line options
+struct Options {
+  uint32_t rate = 5000U;
+  uint32_t gate_count = 1000U;
+  bool is_csv = false;
+  bool is_check = false;
+};
+
+//! distribution switch configuration
+struct SwitchConfig {
+  const char* name;  //!< name in the report
+  uint32_t mask;     //!< switch mask, bit 0 is output 1, set is normal
+};
+
+//! switch configurations of the report
+const SwitchConfig kSwitchConfigs[] = {
+    {"uniform", 0x0U}, {"normal", 0xFU}, {"mixed", 0x5U}};
+
+//! names of kGateScenarios
+const char* const kScenarioNames[tkrandom::kGateScenarioCount] = {
+    "steady", "burst", "jitter", "dual", "short"};
+
+//! DAC channel answering a gate input: output 1 for IN_1, output 4 for IN_2
+const uint8_t kAnswerChannels[2] = {0U, 3U};
+
+//! lowest and highest rate of the search in Hz
+const uint32_t kSearchLow = 100U;
+const uint32_t kSearchHigh = 200000U;
+
+//! bisection steps of the search
+const uint32_t kSearchSteps = 14U;
+
+//! opening edges of one input waiting for their DAC update
+struct PendingGates {
+  std::vector<uint64_t> opens;  //!< opening edges in time order
+  size_t next = 0U;             //!< first unanswered edge
+};
+
+//! result of one run
+struct RunResult {
+  uint32_t injected = 0U;
+  uint32_t captured = 0U;
+  uint32_t merged = 0U;
+  uint32_t dropped = 0U;
+  uint32_t answered = 0U;
+  std::vector<uint64_t> latencies;  //!< cycles per answered gate
+
+  bool IsSustained(void) const {
+    return (dropped == 0U) && (merged == 0U) && (answered == injected);
+  }
+};
+
+//! state of the DAC listener
+struct Listener {
+  PendingGates inputs[2];
+  RunResult* result = nullptr;
+};
+
+Listener listener;
+
+//! assigns a DAC update to the oldest unanswered gate of its input
+void OnDacUpdate(const tkrandom::sim::DacUpdate& update, void* context) {
+  Listener* const state = static_cast<Listener*>(context);
+  if (state->result == nullptr) {
+    return;
+  }
+  for (uint32_t input = 0U; input < 2U; ++input) {
+    PendingGates& pending = state->inputs[input];
+    if ((update.channel != kAnswerChannels[input]) ||
+        (pending.next >= pending.opens.size()) ||
+        (pending.opens[pending.next] > update.cycle)) {
+      continue;
+    }
+    state->result->latencies.push_back(update.cycle -
+                                       pending.opens[pending.next]);
+    state->result->answered++;
+    // later gates answered by the same update stay unanswered
+    while ((pending.next < pending.opens.size()) &&
+           (pending.opens[pending.next] <= update.cycle)) {
+      pending.next++;
+    }
+  }
+}
+
+//! schedules the level of a gate input (IN_1 PB1, IN_2 PA10), an open gate is
+//! a low level
+void ScheduleGate(const uint64_t cycle, const uint32_t input,
+                  const bool is_open) {
+  if (input == 1U) {
+    Mcu::ScheduleInput(cycle, tkrandom::PortB::Regs(),
+                       tkrandom::board::Gate1::kMask, !is_open);
+  }
+  else {
+    Mcu::ScheduleInput(cycle, tkrandom::PortA::Regs(),
+                       tkrandom::board::Gate2::kMask, !is_open);
+  }
+}
+
+//! schedules the levels of the distribution switches
+void ScheduleSwitches(const uint64_t cycle, const uint32_t mask) {
+  for (uint32_t index = 0U; index < 4U; ++index) {
+    const uint16_t pin = static_cast<uint16_t>(1U << (index + 4U));
+    Mcu::ScheduleInput(cycle, tkrandom::PortB::Regs(), pin,
+                       (mask & (1U << index)) != 0U);
+  }
+}
+
+//! powers up the firmware and replays a scenario during the start animation
+void Run(const uint32_t switches, const uint32_t scenario,
+         const uint32_t rate, const uint32_t gate_count,
+         RunResult* const result) {
+  // after the debounced switches, gates run alongside the start animation
+  const uint64_t start = Mcu::ToCycles(100000U);
+  GateScenarioConfig config = tkrandom::kGateScenarios[scenario];
+  config.rate = rate;
+  config.gate_count = gate_count;
+
+  *result = RunResult();
+  listener = Listener();
+  tkrandom::sim::InitFirmware();
+  ScheduleSwitches(0U, switches);
+  tkrandom::sim::RunFirmware(start);
+  // unmasking in ResetGateStatistics() takes due interrupts, so the counters
+  // are reset ahead of the first edge
+  tkrandom::sim::event_handler.ResetGateStatistics();
+  listener.result = result;
+
+  GateScenario trace;
+  GateEdge edge = {0U, 0U, false};
+  uint64_t end = start;
+  trace.Init(config, Mcu::kCoreClock);
+  while (trace.Next(&edge)) {
+    ScheduleGate(start + edge.cycle, edge.input, edge.is_open);
+    if (edge.is_open) {
+      listener.inputs[edge.input - 1U].opens.push_back(start + edge.cycle);
+      result->injected++;
+    }
+    end = start + edge.cycle;
+  }
+  end += (Mcu::kCoreClock / rate) + Mcu::ToCycles(1000U);
+
+  tkrandom::sim::RunFirmware(end);
+  listener.result = nullptr;
+
+  const tkrandom::GateStatistics statistics =
+      tkrandom::sim::event_handler.GetGateStatistics();
+  result->captured = statistics.captured;
+  result->merged = statistics.merged;
+  result->dropped = result->injected - statistics.captured;
+  std::sort(result->latencies.begin(), result->latencies.end());
+}
+
+//! highest sustainable rate by bisection between kSearchLow and kSearchHigh
+uint32_t SearchRate(const uint32_t switches, const uint32_t scenario,
+                    const uint32_t gate_count) {
+  uint32_t low = kSearchLow;
+  uint32_t high = kSearchHigh;
+  RunResult result;
+
+  Run(switches, scenario, low, gate_count, &result);
+  if (!result.IsSustained()) {
+    return 0U;
+  }
+  Run(switches, scenario, high, gate_count, &result);
+  if (result.IsSustained()) {
+    return high;
+  }
+  for (uint32_t step = 0U; (step < kSearchSteps) && (high - low > 1U);
+       ++step) {
+    const uint32_t rate = low + ((high - low) / 2U);
+    Run(switches, scenario, rate, gate_count, &result);
+    if (result.IsSustained()) {
+      low = rate;
+    }
+    else {
+      high = rate;
+    }
+  }
+  return low;
+}
+
+//! latency percentile in us
+double Percentile(const std::vector<uint64_t>& sorted, const uint32_t percent) {
+  double return_value = 0.0;
+  if (!sorted.empty()) {
+    const size_t index = ((sorted.size() - 1U) * percent) / 100U;
+    return_value = static_cast<double>(sorted[index]) * 1e6 / Mcu::kCoreClock;
+  }
+  return return_value;
+}
+
+//! parses the command line
+//! \return false on unknown or incomplete options
+bool ParseOptions(const int argc, char** const argv, Options* const options) {
+  bool return_value = true;
+
+  for (int i = 1; (i < argc) && return_value; ++i) {
+    const char* const option = argv[i];
+    const char* const value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (std::strcmp(option, "--csv") == 0) {
+      options->is_csv = true;
+    }
+    else if (std::strcmp(option, "--check") == 0) {
+      options->is_check = true;
+    }
+    else if (value == nullptr) {
+      return_value = false;
+    }
+    else if (std::strcmp(option, "--rate") == 0) {
+      options->rate = static_cast<uint32_t>(std::strtoul(value, nullptr, 0));
+      i++;
+    }
+    else if (std::strcmp(option, "--gates") == 0) {
+      options->gate_count =
+          static_cast<uint32_t>(std::strtoul(value, nullptr, 0));
+      i++;
+    }
+    else {
+      return_value = false;
+    }
+  }
+  if ((options->rate == 0U) || (options->gate_count == 0U)) {
+    return_value = false;
+  }
+  if (!return_value) {
+    std::fprintf(stderr, "usage: gate_bench [--rate HZ] [--gates N] [--csv] "
+                         "[--check]\n");
+  }
+
+  return return_value;
+}
+
+}  // namespace
+
+// MAIN ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Options options;
+  int return_value = EXIT_SUCCESS;
+
+  if (!ParseOptions(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+  Mcu::GetDac().SetListener(&OnDacUpdate, &listener);
+
+  if (options.is_csv) {
+    std::printf("distribution,scenario,rate,injected,captured,merged,dropped,"
+                "p50_us,p90_us,p99_us,max_us,max_rate\n");
+  }
+  else {
+    std::printf("%u gates per input at %u Hz, latency in us\n",
+                options.gate_count, options.rate);
+    std::printf("%-8s %-7s %8s %8s %6s %7s %7s %7s %7s %7s %9s\n",
+                "distrib", "trace", "injected", "captured", "merged",
+                "dropped", "p50", "p90", "p99", "max", "max rate");
+  }
+  for (const SwitchConfig& switches : kSwitchConfigs) {
+    for (uint32_t scenario = 0U; scenario < tkrandom::kGateScenarioCount;
+         ++scenario) {
+      RunResult result;
+      Run(switches.mask, scenario, options.rate, options.gate_count, &result);
+      const uint32_t max_rate =
+          SearchRate(switches.mask, scenario, options.gate_count);
+      const double p50 = Percentile(result.latencies, 50U);
+      const double p90 = Percentile(result.latencies, 90U);
+      const double p99 = Percentile(result.latencies, 99U);
+      const double max = Percentile(result.latencies, 100U);
+      if (options.is_csv) {
+        std::printf("%s,%s,%u,%u,%u,%u,%u,%.2f,%.2f,%.2f,%.2f,%u\n",
+                    switches.name, kScenarioNames[scenario], options.rate,
+                    result.injected, result.captured, result.merged,
+                    result.dropped, p50, p90, p99, max, max_rate);
+      }
+      else {
+        std::printf("%-8s %-7s %8u %8u %6u %7u %7.2f %7.2f %7.2f %7.2f %9u\n",
+                    switches.name, kScenarioNames[scenario], result.injected,
+                    result.captured, result.merged, result.dropped, p50, p90,
+                    p99, max, max_rate);
+      }
+      if (options.is_check && !result.IsSustained()) {
+        return_value = EXIT_FAILURE;
+      }
+    }
+  }
+
+  return return_value;
+}
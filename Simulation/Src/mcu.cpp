@@ -0,0 +1,748 @@
+//! \brief     Class definition of the simulated STM32L412 core and peripherals.
+//! \details   Cycle clock, NVIC with the priority tiers of the firmware,
+//!            timers, EXTI, SPI with DMA, RNG, the GPIO ports and the flash
+//!            pages of the settings journal.
+//! \file      mcu.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "mcu.hpp"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "board.hpp"
+#include "clock_tree.hpp"
+#include "interrupt_tiers.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+namespace sim {
+
+uint64_t Mcu::cycles_ = 0U;
+uint64_t Mcu::cycle_counter_origin_ = 0U;
+uint32_t Mcu::running_priority_ = Mcu::kThreadPriority_;
+bool Mcu::is_primask_set_ = false;
+uint32_t Mcu::basepri_ = 0U;
+bool Mcu::is_pendsv_pending_ = false;
+uint16_t Mcu::exti_mask_ = 0U;
+uint16_t Mcu::exti_pending_ = 0U;
+std::deque<Mcu::InputEdge> Mcu::inputs_;
+Mcu::Timer Mcu::timers_[Mcu::kTimerCount_] = {};
+Mcu::TimerUpdates Mcu::timer_updates_[Mcu::kTimerCount_] = {};
+SPI_HandleTypeDef* Mcu::dma_handle_ = nullptr;
+uint64_t Mcu::dma_complete_cycle_ = 0U;
+std::deque<Mcu::SpiByte> Mcu::spi_tx_;
+uint32_t Mcu::spi_rx_level_ = 0U;
+bool Mcu::is_spi_overrun_ = false;
+bool Mcu::is_spi_data_read_ = false;
+bool Mcu::is_spi_stalled_ = false;
+bool Mcu::is_flash_locked_ = true;
+Mcu::FlashOperation Mcu::flash_operation_ = Mcu::FlashOperation::kNone;
+uint32_t Mcu::flash_address_ = 0U;
+uint64_t Mcu::flash_data_ = 0U;
+uint32_t Mcu::flash_erase_size_ = 0U;
+uint64_t Mcu::flash_complete_cycle_ = 0U;
+uint32_t Mcu::flash_error_ = 0U;
+uint32_t Mcu::flash_failure_period_ = 0U;
+uint32_t Mcu::flash_operations_ = 0U;
+uint64_t Mcu::rng_ready_cycle_ = 0U;
+VirtualDac Mcu::dac_;
+RngSource Mcu::rng_source_;
+CostModel Mcu::cost_model_;
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void Mcu::Init() {
+  static bool is_mapped = false;
+  if (!is_mapped) {
+    // board.hpp resolves the ports from their device addresses at compile
+    // time, so the register blocks have to live exactly there
+    void* const address = reinterpret_cast<void*>(GPIOA_BASE);
+    void* const mapping =
+        mmap(address, kGpioMapSize_, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mapping != address) {
+      std::fprintf(stderr, "sim: cannot map the GPIO ports at 0x%08lX\n",
+                   GPIOA_BASE);
+      std::abort();
+    }
+    // the journal pages are read through their flash addresses
+    void* const flash = reinterpret_cast<void*>(kFlashMapBase_);
+    if (mmap(flash, kFlashMapSize_, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) !=
+        flash) {
+      std::fprintf(stderr, "sim: cannot map the flash at 0x%08X\n",
+                   kFlashMapBase_);
+      std::abort();
+    }
+    EraseFlash();
+    is_mapped = true;
+  }
+  std::memset(reinterpret_cast<void*>(GPIOA_BASE), 0, kGpioMapSize_);
+
+  cycles_ = 0U;
+  uwTick = 0U;
+  cycle_counter_origin_ = 0U;
+  running_priority_ = kThreadPriority_;
+  is_primask_set_ = false;
+  basepri_ = 0U;
+  is_pendsv_pending_ = false;
+  exti_mask_ = 0U;
+  exti_pending_ = 0U;
+  inputs_.clear();
+  for (Timer& timer : timers_) {
+    timer = {};
+  }
+  for (TimerUpdates& updates : timer_updates_) {
+    updates = {};
+  }
+  ClockTree::Init();
+  dma_handle_ = nullptr;
+  dma_complete_cycle_ = 0U;
+  spi_tx_.clear();
+  spi_rx_level_ = 0U;
+  is_spi_overrun_ = false;
+  is_spi_data_read_ = false;
+  is_spi_stalled_ = false;
+  is_flash_locked_ = true;
+  flash_operation_ = FlashOperation::kNone;
+  flash_error_ = 0U;
+  flash_failure_period_ = 0U;
+  flash_operations_ = 0U;
+  FLASH->SR = 0U;
+  FLASH->ECCR = 0U;
+  rng_ready_cycle_ = 0U;
+  dac_.Clear();
+  // MX_GPIO_Init() drives NSS and the DAC reset low
+  dac_.SetReset(false);
+  dac_.SetNss(false, cycles_);
+
+  // inverted input stages: closed gates are high levels
+  PortB::Regs()->IDR = board::Gate1::kMask;
+  PortA::Regs()->IDR = board::Gate2::kMask;
+}
+//------------------------------------------------------------------------------
+void Mcu::EraseFlash() {
+  std::memset(reinterpret_cast<void*>(kFlashMapBase_), 0xFF, kFlashMapSize_);
+}
+//------------------------------------------------------------------------------
+void Mcu::SetFlashFailures(const uint32_t period) {
+  flash_failure_period_ = period;
+  flash_operations_ = 0U;
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::GetCycles() {
+  return cycles_;
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::ToCycles(const uint64_t microseconds) {
+  return microseconds * (kCoreClock / 1000000U);
+}
+//------------------------------------------------------------------------------
+void Mcu::Charge(const uint32_t cycles) {
+  uint64_t remaining = cycles;
+
+  // interrupts taken in between delay the end of the running context
+  while (true) {
+    const uint64_t next = GetNextEventCycle();
+    if (next > (cycles_ + remaining)) {
+      Advance(remaining);
+      break;
+    }
+    if (next > cycles_) {
+      remaining -= next - cycles_;
+      Advance(next - cycles_);
+    }
+    Poll();
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::WaitForInterrupt(const uint64_t limit) {
+  const uint64_t next = GetNextEventCycle();
+  if (next > limit) {
+    if (limit > cycles_) {
+      Advance(limit - cycles_);
+    }
+  }
+  else {
+    if (next > cycles_) {
+      Advance(next - cycles_);
+    }
+    Poll();
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::ScheduleInput(const uint64_t cycle, GPIO_TypeDef* const port,
+                        const uint16_t pin, const bool is_high) {
+  const InputEdge edge = {std::max(cycle, cycles_), port, pin, is_high};
+  const auto position = std::upper_bound(
+      inputs_.begin(), inputs_.end(), edge,
+      [](const InputEdge& a, const InputEdge& b) { return a.cycle < b.cycle; });
+  inputs_.insert(position, edge);
+}
+//------------------------------------------------------------------------------
+void Mcu::EnableExti(const uint16_t pins) {
+  exti_mask_ = exti_mask_ | pins;
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::GetTimerUpdates(const TIM_TypeDef* const instance) {
+  uint64_t return_value = 0U;
+  for (const TimerUpdates& updates : timer_updates_) {
+    if (updates.instance == instance) {
+      return_value = updates.count;
+    }
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+VirtualDac& Mcu::GetDac() {
+  return dac_;
+}
+//------------------------------------------------------------------------------
+RngSource& Mcu::GetRngSource() {
+  return rng_source_;
+}
+//------------------------------------------------------------------------------
+CostModel& Mcu::GetCostModel() {
+  return cost_model_;
+}
+//------------------------------------------------------------------------------
+void Mcu::SetSpiStall(const bool is_stalled) {
+  is_spi_stalled_ = is_stalled;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::ReadSpiStatus() {
+  Charge(cost_model_.register_access);
+  ShiftSpi();
+  // FTLVL and FRLVL count 1, 2, 3 and 4 bytes as 1, 2, 3 and full (3)
+  uint32_t status =
+      (std::min<uint32_t>(static_cast<uint32_t>(spi_tx_.size()), 3U)
+       << 11U) |
+      (std::min<uint32_t>(spi_rx_level_, 3U) << 9U);
+  if (!spi_tx_.empty()) {
+    status |= SPI_SR_BSY;
+  }
+  if (is_spi_overrun_) {
+    status |= SPI_SR_OVR;
+    is_spi_overrun_ = !is_spi_data_read_;
+  }
+  is_spi_data_read_ = false;
+  return status;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::ReadSpiData(const uint32_t size) {
+  Charge(cost_model_.register_access);
+  ShiftSpi();
+  spi_rx_level_ -= std::min(spi_rx_level_, size);
+  is_spi_data_read_ = true;
+  return 0U;
+}
+//------------------------------------------------------------------------------
+void Mcu::WriteSpiData(const uint32_t value, const uint32_t size) {
+  Charge(cost_model_.register_access);
+  ShiftSpi();
+  const uint64_t byte_cycles = GetFrameCycles(SPI1, 1U);
+  for (uint32_t i = 0U; (i < size) && (spi_tx_.size() < kSpiFifoSize_);
+       ++i) {
+    // the bytes are shifted out back to back
+    const uint64_t start =
+        spi_tx_.empty() ? cycles_ : std::max(cycles_, spi_tx_.back().cycle);
+    spi_tx_.push_back(
+        {start + byte_cycles, static_cast<uint8_t>(value >> (i * 8U))});
+  }
+  is_spi_data_read_ = false;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::ReadRngStatus() {
+  Charge(cost_model_.register_access);
+  uint32_t status = 0U;
+  if (rng_source_.HasFault()) {
+    status = RNG_SR_SECS;
+  }
+  else if (cycles_ >= rng_ready_cycle_) {
+    status = RNG_SR_DRDY;
+  }
+  return status;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::ReadRngData() {
+  Charge(cost_model_.register_access);
+  rng_ready_cycle_ = cycles_ + GetRngWordCycles();
+  return rng_source_.Next();
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef Mcu::GenerateRandomNumber(uint32_t* const word) {
+  HAL_StatusTypeDef return_value = HAL_ERROR;
+
+  Charge(cost_model_.hal_call);
+  if (!rng_source_.HasFault()) {
+    if (cycles_ < rng_ready_cycle_) {
+      Charge(static_cast<uint32_t>(rng_ready_cycle_ - cycles_));
+    }
+    *word = rng_source_.Next();
+    rng_ready_cycle_ = cycles_ + GetRngWordCycles();
+    return_value = HAL_OK;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void Mcu::ResetRng() {
+  rng_source_.SetFault(false);
+  rng_ready_cycle_ = cycles_ + GetRngWordCycles();
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::ReadCycleCounter() {
+  return static_cast<uint32_t>(cycles_ - cycle_counter_origin_);
+}
+//------------------------------------------------------------------------------
+void Mcu::WriteCycleCounter(const uint32_t value) {
+  cycle_counter_origin_ = cycles_ - value;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::ReadInterruptControl() {
+  uint32_t return_value = 0U;
+  if (is_pendsv_pending_) {
+    return_value = SCB_ICSR_PENDSVSET_Msk;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void Mcu::WriteInterruptControl(const uint32_t value) {
+  if ((value & SCB_ICSR_PENDSVSET_Msk) != 0U) {
+    is_pendsv_pending_ = true;
+    Poll();
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::WriteGpio(GPIO_TypeDef* const port, const uint32_t set_reset) {
+  const uint32_t set = set_reset & 0xFFFFU;
+  const uint32_t reset = set_reset >> 16U;
+  port->ODR = (port->ODR & ~reset) | set;
+
+  if (port == PortA::Regs()) {
+    dac_.SetReset((port->ODR & board::DacReset::kMask) != 0U);
+    dac_.SetNss((port->ODR & board::DacNss::kMask) != 0U, cycles_);
+  }
+  Charge(cost_model_.register_access);
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef Mcu::TransmitSpi(SPI_HandleTypeDef* const handle,
+                                   const uint8_t* const data,
+                                   const uint16_t size) {
+  HAL_StatusTypeDef return_value = HAL_BUSY;
+
+  if (dma_handle_ == nullptr) {
+    Charge(cost_model_.hal_call);
+    dac_.ShiftIn(data, size);
+    Charge(static_cast<uint32_t>(GetFrameCycles(handle->Instance, size)));
+    // the received bytes are left, the overrun flag is cleared
+    ReceiveSpi(size);
+    is_spi_overrun_ = false;
+    return_value = HAL_OK;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef Mcu::StartSpiDma(SPI_HandleTypeDef* const handle,
+                                   const uint8_t* const data,
+                                   const uint16_t size) {
+  HAL_StatusTypeDef return_value = HAL_BUSY;
+
+  if (dma_handle_ == nullptr) {
+    dma_handle_ = handle;
+    dac_.ShiftIn(data, size);
+    ReceiveSpi(size);
+    Charge(cost_model_.dma_start);
+    dma_complete_cycle_ = cycles_ + GetFrameCycles(handle->Instance, size);
+    return_value = HAL_OK;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void Mcu::AbortSpi() {
+  // flushes both FIFOs and resets a stalled SPI
+  dma_handle_ = nullptr;
+  spi_tx_.clear();
+  spi_rx_level_ = 0U;
+  is_spi_overrun_ = false;
+  is_spi_stalled_ = false;
+  Charge(cost_model_.hal_call);
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef Mcu::StartTimer(TIM_HandleTypeDef* const handle) {
+  HAL_StatusTypeDef return_value = HAL_ERROR;
+  Timer* free_timer = nullptr;
+
+  for (Timer& timer : timers_) {
+    if (timer.handle == handle) {
+      free_timer = nullptr;
+      break;  // HAL state is busy
+    }
+    if ((timer.handle == nullptr) && (free_timer == nullptr)) {
+      free_timer = &timer;
+    }
+  }
+  if (free_timer != nullptr) {
+    free_timer->handle = handle;
+    free_timer->priority = InterruptTiers::kTimer;
+    if (handle->Instance == TIM15) {
+      free_timer->priority = InterruptTiers::kAudio;
+    }
+    free_timer->next_cycle = cycles_ + GetTimerPeriod(handle);
+    return_value = HAL_OK;
+  }
+  Charge(cost_model_.hal_call);
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void Mcu::StopTimer(TIM_HandleTypeDef* const handle) {
+  for (Timer& timer : timers_) {
+    if (timer.handle == handle) {
+      timer = {};
+    }
+  }
+  Charge(cost_model_.hal_call);
+}
+//------------------------------------------------------------------------------
+void Mcu::SetFlashLock(const bool is_locked) {
+  is_flash_locked_ = is_locked;
+  Charge(cost_model_.register_access);
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef Mcu::StartFlashProgram(const uint32_t address,
+                                         const uint64_t data) {
+  HAL_StatusTypeDef return_value = HAL_ERROR;
+
+  Charge(cost_model_.hal_call);
+  if (flash_operation_ != FlashOperation::kNone) {
+    return_value = HAL_BUSY;
+  }
+  else if ((!is_flash_locked_) && (address >= kFlashMapBase_) &&
+           (address < (kFlashMapBase_ + kFlashMapSize_)) &&
+           ((address % 8U) == 0U)) {
+    flash_operation_ = FlashOperation::kProgram;
+    flash_address_ = address;
+    flash_data_ = data;
+    flash_complete_cycle_ = cycles_ + cost_model_.flash_program;
+    return_value = HAL_OK;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef Mcu::StartFlashErase(const uint32_t page,
+                                       const uint32_t count) {
+  HAL_StatusTypeDef return_value = HAL_ERROR;
+  const uint32_t address = FLASH_BASE + (page * FLASH_PAGE_SIZE);
+
+  Charge(cost_model_.hal_call);
+  if (flash_operation_ != FlashOperation::kNone) {
+    return_value = HAL_BUSY;
+  }
+  else if ((!is_flash_locked_) && (count > 0U) &&
+           (address >= kFlashMapBase_) &&
+           ((address + (count * FLASH_PAGE_SIZE)) <=
+            (kFlashMapBase_ + kFlashMapSize_))) {
+    flash_operation_ = FlashOperation::kErase;
+    flash_address_ = address;
+    flash_erase_size_ = count * FLASH_PAGE_SIZE;
+    flash_complete_cycle_ = cycles_ + (static_cast<uint64_t>(count) *
+                                       cost_model_.flash_erase);
+    return_value = HAL_OK;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::GetFlashError() {
+  return flash_error_;
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::GetPrimask() {
+  return is_primask_set_ ? 1U : 0U;
+}
+//------------------------------------------------------------------------------
+void Mcu::SetPrimask(const uint32_t primask) {
+  is_primask_set_ = (primask & 1U) != 0U;
+  if (!is_primask_set_) {
+    Poll();  // interrupts that became pending in the meantime
+  }
+}
+//------------------------------------------------------------------------------
+uint32_t Mcu::GetBasepri() {
+  return basepri_;
+}
+//------------------------------------------------------------------------------
+void Mcu::SetBasepri(const uint32_t basepri, const bool is_max) {
+  const uint32_t value = basepri & 0xF0U;
+  if (!is_max) {
+    const bool is_lowered = (value == 0U) || ((basepri_ != 0U) &&
+                                              (value > basepri_));
+    basepri_ = value;
+    if (is_lowered) {
+      Poll();
+    }
+  }
+  else if ((value != 0U) && ((basepri_ == 0U) || (value < basepri_))) {
+    basepri_ = value;
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::Advance(const uint64_t cycles) {
+  cycles_ += cycles;
+  uwTick = static_cast<uint32_t>(cycles_ / (kCoreClock / 1000U));
+}
+//------------------------------------------------------------------------------
+void Mcu::Poll() {
+  bool is_dispatched = true;
+
+  while (is_dispatched) {
+    is_dispatched = false;
+    ApplyInputs();
+
+    // the highest pending priority wins, NVIC order within one priority
+    Source source = Source::kNone;
+    uint32_t priority = running_priority_;
+    Timer* due_timer = nullptr;
+    if ((exti_pending_ != 0U) && IsEnabled(InterruptTiers::kGateCapture)) {
+      source = Source::kExti;
+      priority = InterruptTiers::kGateCapture;
+    }
+    if ((dma_handle_ != nullptr) && (dma_complete_cycle_ <= cycles_) &&
+        (InterruptTiers::kTransfer < priority) &&
+        IsEnabled(InterruptTiers::kTransfer)) {
+      source = Source::kSpiDma;
+      priority = InterruptTiers::kTransfer;
+    }
+    for (Timer& timer : timers_) {
+      if ((timer.handle != nullptr) && (timer.next_cycle <= cycles_) &&
+          (timer.priority < priority) && IsEnabled(timer.priority)) {
+        source = Source::kTimer;
+        priority = timer.priority;
+        due_timer = &timer;
+      }
+    }
+    if ((flash_operation_ != FlashOperation::kNone) &&
+        (flash_complete_cycle_ <= cycles_) &&
+        (InterruptTiers::kFlash < priority) &&
+        IsEnabled(InterruptTiers::kFlash)) {
+      source = Source::kFlash;
+      priority = InterruptTiers::kFlash;
+      due_timer = nullptr;
+    }
+    if ((source == Source::kNone) && is_pendsv_pending_ &&
+        IsEnabled(InterruptTiers::kGateWork)) {
+      source = Source::kPendSv;
+      priority = InterruptTiers::kGateWork;
+    }
+    if (source != Source::kNone) {
+      Dispatch(source, priority, due_timer);
+      is_dispatched = true;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::GetNextEventCycle() {
+  uint64_t next = UINT64_MAX;
+
+  if (!inputs_.empty()) {
+    next = inputs_.front().cycle;
+  }
+  if ((exti_pending_ != 0U) && IsEnabled(InterruptTiers::kGateCapture)) {
+    next = std::min(next, cycles_);
+  }
+  if ((dma_handle_ != nullptr) && IsEnabled(InterruptTiers::kTransfer)) {
+    next = std::min(next, dma_complete_cycle_);
+  }
+  for (const Timer& timer : timers_) {
+    if ((timer.handle != nullptr) && IsEnabled(timer.priority)) {
+      next = std::min(next, timer.next_cycle);
+    }
+  }
+  if ((flash_operation_ != FlashOperation::kNone) &&
+      IsEnabled(InterruptTiers::kFlash)) {
+    next = std::min(next, flash_complete_cycle_);
+  }
+  if (is_pendsv_pending_ && IsEnabled(InterruptTiers::kGateWork)) {
+    next = std::min(next, cycles_);
+  }
+
+  return next;
+}
+//------------------------------------------------------------------------------
+bool Mcu::IsEnabled(const uint32_t priority) {
+  const uint32_t shifted = priority << (8U - __NVIC_PRIO_BITS);
+  return (!is_primask_set_) && (priority < running_priority_) &&
+         ((basepri_ == 0U) || (shifted < basepri_));
+}
+//------------------------------------------------------------------------------
+void Mcu::ApplyInputs() {
+  while ((!inputs_.empty()) && (inputs_.front().cycle <= cycles_)) {
+    const InputEdge edge = inputs_.front();
+    inputs_.pop_front();
+    const uint32_t previous = edge.port->IDR;
+    uint32_t level = previous & ~static_cast<uint32_t>(edge.pin);
+    if (edge.is_high) {
+      level = level | edge.pin;
+    }
+    edge.port->IDR = level;
+    if ((level != previous) && ((exti_mask_ & edge.pin) != 0U)) {
+      exti_pending_ = exti_pending_ | edge.pin;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::Dispatch(const Source source, const uint32_t priority,
+                   Timer* const timer) {
+  const uint32_t preempted_priority = running_priority_;
+  running_priority_ = priority;
+  Advance(cost_model_.interrupt_entry);
+  // edges during the entry reach the pins the handler reads, an edge of a
+  // line that is pending already merges into its pending bit
+  ApplyInputs();
+
+  switch (source) {
+    case Source::kExti: {
+      // one line per handler run, the lowest line first
+      const uint16_t pin =
+          static_cast<uint16_t>(exti_pending_ & (~exti_pending_ + 1U));
+      exti_pending_ = exti_pending_ & static_cast<uint16_t>(~pin);
+      HAL_GPIO_EXTI_Callback(pin);
+      break;
+    }
+    case Source::kSpiDma: {
+      SPI_HandleTypeDef* const handle = dma_handle_;
+      dma_handle_ = nullptr;
+      HAL_SPI_TxCpltCallback(handle);
+      break;
+    }
+    case Source::kTimer: {
+      // update events that were missed meanwhile merge into this one
+      const uint64_t period = GetTimerPeriod(timer->handle);
+      while (timer->next_cycle <= cycles_) {
+        timer->next_cycle += period;
+      }
+      CountTimerUpdate(timer->handle->Instance);
+      HAL_TIM_PeriodElapsedCallback(timer->handle);
+      break;
+    }
+    case Source::kFlash:
+      CompleteFlashOperation();
+      break;
+    case Source::kPendSv:
+      is_pendsv_pending_ = false;
+      PendSV_Callback();
+      break;
+    default:
+      break;
+  }
+
+  Advance(cost_model_.interrupt_exit);
+  running_priority_ = preempted_priority;
+}
+//------------------------------------------------------------------------------
+void Mcu::ShiftSpi() {
+  // a disabled SPI keeps its TX FIFO
+  while ((!spi_tx_.empty()) && (spi_tx_.front().cycle <= cycles_) &&
+         (!is_spi_stalled_) && ((SPI1->CR1 & SPI_CR1_SPE) != 0U)) {
+    dac_.ShiftIn(&spi_tx_.front().data, 1U);
+    spi_tx_.pop_front();
+    ReceiveSpi(1U);
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::ReceiveSpi(const uint32_t count) {
+  spi_rx_level_ += count;
+  if (spi_rx_level_ > kSpiFifoSize_) {
+    spi_rx_level_ = kSpiFifoSize_;
+    is_spi_overrun_ = true;
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::CompleteFlashOperation() {
+  const FlashOperation operation = flash_operation_;
+  flash_operation_ = FlashOperation::kNone;
+  uint64_t* const target = reinterpret_cast<uint64_t*>(flash_address_);
+  bool is_failed = false;
+
+  ++flash_operations_;
+  if ((flash_failure_period_ != 0U) &&
+      ((flash_operations_ % flash_failure_period_) == 0U)) {
+    is_failed = true;
+    if (operation == FlashOperation::kProgram) {
+      *target &= flash_data_ | 0xFFFFFFFF00000000U;
+    }
+  }
+  else if (operation == FlashOperation::kErase) {
+    std::memset(reinterpret_cast<void*>(flash_address_), 0xFF,
+                flash_erase_size_);
+  }
+  else if (operation == FlashOperation::kProgram) {
+    // a double word can be programmed once after each erase
+    is_failed = (*target != UINT64_MAX);
+    if (!is_failed) {
+      *target = flash_data_;
+    }
+  }
+
+  if (is_failed) {
+    FLASH->SR |= FLASH_FLAG_PROGERR;
+    flash_error_ |= FLASH_FLAG_PROGERR;
+    HAL_FLASH_OperationErrorCallback(flash_address_);
+  }
+  else {
+    HAL_FLASH_EndOfOperationCallback(
+        (operation == FlashOperation::kErase) ? 0xFFFFFFFFU : flash_address_);
+  }
+}
+//------------------------------------------------------------------------------
+void Mcu::CountTimerUpdate(const TIM_TypeDef* const instance) {
+  for (TimerUpdates& updates : timer_updates_) {
+    if ((updates.instance == instance) || (updates.instance == nullptr)) {
+      updates.instance = instance;
+      updates.count = updates.count + 1U;
+      break;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::GetFrameCycles(const SPI_TypeDef* const instance,
+                             const uint16_t size) {
+  // the SPI clock is PCLK2 = HCLK divided by 2 << BR
+  const uint32_t divider =
+      2U << ((instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos);
+  return ToReferenceCycles(static_cast<uint64_t>(size) * 8U * divider);
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::GetTimerPeriod(const TIM_HandleTypeDef* const handle) {
+  return ToReferenceCycles(
+      (static_cast<uint64_t>(handle->Instance->PSC) + 1U) *
+      (static_cast<uint64_t>(handle->Instance->ARR) + 1U));
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::ToReferenceCycles(const uint64_t bus_cycles) {
+  const uint64_t hclk = ClockTree::GetHclk();
+  return ((bus_cycles * kCoreClock) + (hclk / 2U)) / hclk;
+}
+//------------------------------------------------------------------------------
+uint64_t Mcu::GetRngWordCycles() {
+  const uint64_t msi = ClockTree::GetMsiClock();
+  return ((static_cast<uint64_t>(cost_model_.rng_word) * kCoreClock) +
+          (msi / 2U)) / msi;
+}
+
+}  // namespace sim
+}  // namespace tkrandom
@@ -0,0 +1,283 @@
+//! \brief     Command line tool that replays gate traces on the simulated MCU.
+//! \details   Injects gate and switch edges, logs the virtual DAC and reports
+//!            the simulation throughput.
+//! \file      random_sim.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+//
+//  usage: random_sim [options]
+//    --trace FILE       replays a trace, lines "<time in us> <input> <value>"
+//                       with input in1 or in2 (value 1 opens the gate) or sw
+//                       (value is the switch mask, bit 0 is output 1)
+//    --clock HZ         clocks IN_1 with 50 % duty cycle instead of a trace
+//    --start-ms MS      start of the clock, default 1000
+//    --duration-ms MS   simulated time, default end of the trace + 10 ms
+//    --seed N           seed of the simulated RNG, default 1
+//    --random-seed N    seed of the deterministic mode of the Generator, as
+//                       stored in the settings journal, default 0 (RNG)
+//    --rng-file FILE    raw 32-bit words for the simulated RNG
+//    --dac-log FILE     writes "cycle,channel,value" per DAC update
+
+// INCLUDES --------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "board.hpp"
+#include "firmware.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace {
+
+using tkrandom::sim::Mcu;
+
+//! command line options
+struct Options {
+  const char* trace_path = nullptr;
+  const char* rng_path = nullptr;
+  const char* dac_log_path = nullptr;
+  uint64_t clock_rate = 0U;
+  uint64_t start_ms = 1000U;
+  uint64_t duration_ms = 0U;
+  uint64_t seed = 1U;
+  uint16_t random_seed = 0U;
+};
+
+//! counters of the run
+struct Counters {
+  uint64_t gates = 0U;
+  uint64_t last_cycle = 0U;
+};
+
+//! schedules the level of a gate input (IN_1 PB1, IN_2 PA10), an open gate is
+//! a low level
+void ScheduleGate(const uint64_t cycle, const uint32_t input,
+                  const bool is_open) {
+  if (input == 1U) {
+    Mcu::ScheduleInput(cycle, tkrandom::PortB::Regs(),
+                       tkrandom::board::Gate1::kMask, !is_open);
+  }
+  else {
+    Mcu::ScheduleInput(cycle, tkrandom::PortA::Regs(),
+                       tkrandom::board::Gate2::kMask, !is_open);
+  }
+}
+
+//! schedules the levels of the distribution switches
+void ScheduleSwitches(const uint64_t cycle, const uint32_t mask) {
+  using Switches = tkrandom::board::DistributionSwitches;
+  for (uint32_t index = 0U; index < 4U; ++index) {
+    const uint16_t pin = static_cast<uint16_t>(1U << (index + 4U));
+    Mcu::ScheduleInput(cycle, tkrandom::PortB::Regs(), pin,
+                       (mask & (1U << index)) != 0U);
+  }
+  static_assert(Switches::kMask == 0x00F0U, "switches are PB4 .. PB7");
+}
+
+//! loads a trace file
+//! \return false if the file cannot be read or has a malformed line
+bool LoadTrace(const char* const path, Counters* const counters) {
+  bool return_value = true;
+  std::FILE* const file = std::fopen(path, "r");
+
+  if (file == nullptr) {
+    std::fprintf(stderr, "cannot open %s\n", path);
+    return_value = false;
+  }
+  else {
+    char line[128];
+    uint32_t line_number = 0U;
+    while (return_value && (std::fgets(line, sizeof(line), file) != nullptr)) {
+      line_number++;
+      unsigned long long time_us = 0U;
+      char input[8] = {};
+      long value = 0;
+      if ((line[0] == '#') || (line[0] == '\n') || (line[0] == '\r')) {
+        continue;
+      }
+      if (std::sscanf(line, "%llu %7s %li", &time_us, input, &value) != 3) {
+        std::fprintf(stderr, "%s:%u: malformed line\n", path, line_number);
+        return_value = false;
+        break;
+      }
+      const uint64_t cycle = Mcu::ToCycles(time_us);
+      if (std::strcmp(input, "in1") == 0) {
+        ScheduleGate(cycle, 1U, value != 0);
+        counters->gates += (value != 0) ? 1U : 0U;
+      }
+      else if (std::strcmp(input, "in2") == 0) {
+        ScheduleGate(cycle, 2U, value != 0);
+        counters->gates += (value != 0) ? 1U : 0U;
+      }
+      else if (std::strcmp(input, "sw") == 0) {
+        ScheduleSwitches(cycle, static_cast<uint32_t>(value));
+      }
+      else {
+        std::fprintf(stderr, "%s:%u: unknown input %s\n", path, line_number,
+                     input);
+        return_value = false;
+      }
+      if (cycle > counters->last_cycle) {
+        counters->last_cycle = cycle;
+      }
+    }
+    std::fclose(file);
+  }
+
+  return return_value;
+}
+
+//! schedules a steady clock on IN_1
+void ScheduleClock(const Options& options, const uint64_t end_cycle,
+                   Counters* const counters) {
+  const uint64_t period = Mcu::kCoreClock / options.clock_rate;
+  uint64_t cycle = Mcu::ToCycles(options.start_ms * 1000U);
+  while ((cycle + period) <= end_cycle) {
+    ScheduleGate(cycle, 1U, true);
+    ScheduleGate(cycle + (period / 2U), 1U, false);
+    counters->gates++;
+    cycle += period;
+  }
+}
+
+//! writes every DAC update to the log file
+void LogDacUpdate(const tkrandom::sim::DacUpdate& update, void* context) {
+  std::fprintf(static_cast<std::FILE*>(context), "%llu,%u,%u\n",
+               static_cast<unsigned long long>(update.cycle), update.channel,
+               update.value);
+}
+
+//! parses the command line
+//! \return false on unknown or incomplete options
+bool ParseOptions(const int argc, char** const argv, Options* const options) {
+  bool return_value = true;
+
+  for (int i = 1; (i < argc) && return_value; ++i) {
+    const char* const option = argv[i];
+    const char* const value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr) {
+      return_value = false;
+    }
+    else if (std::strcmp(option, "--trace") == 0) {
+      options->trace_path = value;
+    }
+    else if (std::strcmp(option, "--rng-file") == 0) {
+      options->rng_path = value;
+    }
+    else if (std::strcmp(option, "--dac-log") == 0) {
+      options->dac_log_path = value;
+    }
+    else if (std::strcmp(option, "--clock") == 0) {
+      options->clock_rate = std::strtoull(value, nullptr, 0);
+    }
+    else if (std::strcmp(option, "--start-ms") == 0) {
+      options->start_ms = std::strtoull(value, nullptr, 0);
+    }
+    else if (std::strcmp(option, "--duration-ms") == 0) {
+      options->duration_ms = std::strtoull(value, nullptr, 0);
+    }
+    else if (std::strcmp(option, "--seed") == 0) {
+      options->seed = std::strtoull(value, nullptr, 0);
+    }
+    else if (std::strcmp(option, "--random-seed") == 0) {
+      options->random_seed =
+          static_cast<uint16_t>(std::strtoul(value, nullptr, 0));
+    }
+    else {
+      return_value = false;
+    }
+    i++;
+  }
+  if (!return_value) {
+    std::fprintf(stderr, "usage: random_sim [--trace FILE | --clock HZ] "
+                         "[--start-ms MS] [--duration-ms MS] [--seed N] "
+                         "[--random-seed N] [--rng-file FILE] "
+                         "[--dac-log FILE]\n");
+  }
+
+  return return_value;
+}
+
+}  // namespace
+
+// MAIN ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Options options;
+  Counters counters;
+  std::FILE* dac_log = nullptr;
+
+  if (!ParseOptions(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  Mcu::GetRngSource().Seed(options.seed);
+  if ((options.rng_path != nullptr) &&
+      !Mcu::GetRngSource().Open(options.rng_path)) {
+    std::fprintf(stderr, "cannot read RNG words from %s\n", options.rng_path);
+    return EXIT_FAILURE;
+  }
+  if (options.dac_log_path != nullptr) {
+    dac_log = std::fopen(options.dac_log_path, "w");
+    if (dac_log == nullptr) {
+      std::fprintf(stderr, "cannot write %s\n", options.dac_log_path);
+      return EXIT_FAILURE;
+    }
+    Mcu::GetDac().SetListener(&LogDacUpdate, dac_log);
+  }
+  tkrandom::sim::InitFirmware(options.random_seed);
+
+  uint64_t end_cycle = Mcu::ToCycles(options.duration_ms * 1000U);
+  if (options.trace_path != nullptr) {
+    if (!LoadTrace(options.trace_path, &counters)) {
+      return EXIT_FAILURE;
+    }
+    if (options.duration_ms == 0U) {
+      end_cycle = counters.last_cycle + Mcu::ToCycles(10000U);
+    }
+  }
+  else if (options.clock_rate > 0U) {
+    if (options.duration_ms == 0U) {
+      end_cycle = Mcu::ToCycles((options.start_ms + 1000U) * 1000U);
+    }
+    ScheduleClock(options, end_cycle, &counters);
+  }
+  else if (options.duration_ms == 0U) {
+    end_cycle = Mcu::ToCycles(1000000U);
+  }
+
+  const auto host_start = std::chrono::steady_clock::now();
+  tkrandom::sim::RunFirmware(end_cycle);
+  const std::chrono::duration<double> host_time =
+      std::chrono::steady_clock::now() - host_start;
+
+  if (dac_log != nullptr) {
+    std::fclose(dac_log);
+  }
+
+  const tkrandom::sim::VirtualDac& dac = Mcu::GetDac();
+  const double simulated_s =
+      static_cast<double>(Mcu::GetCycles()) / Mcu::kCoreClock;
+  std::printf("simulated time   %.3f s\n", simulated_s);
+  std::printf("host time        %.3f s (%.1fx real time)\n", host_time.count(),
+              simulated_s / host_time.count());
+  std::printf("gates            %llu (%.0f gates/s host)\n",
+              static_cast<unsigned long long>(counters.gates),
+              static_cast<double>(counters.gates) / host_time.count());
+  std::printf("DAC updates      %llu\n",
+              static_cast<unsigned long long>(dac.GetUpdateCount()));
+  std::printf("DAC frame errors %llu\n",
+              static_cast<unsigned long long>(dac.GetFrameErrorCount()));
+  std::printf("DAC outputs      %u %u %u %u\n", dac.GetValue(0U),
+              dac.GetValue(1U), dac.GetValue(2U), dac.GetValue(3U));
+
+  int return_value = EXIT_SUCCESS;
+  if ((dac.GetFrameErrorCount() != 0U) || (dac.GetUpdateCount() == 0U)) {
+    return_value = EXIT_FAILURE;
+  }
+  return return_value;
+}
@@ -0,0 +1,318 @@
+//! \brief     Command line tool that tests the statistical quality of the
+//!            generator output streams.
+//! \details   Streams samples of the Generator and RngHandler paths on the
+//!            simulated MCU through the TestBattery and reports pass or fail
+//!            per source, optionally exports the raw samples.
+//! \file      rng_battery.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+//
+//  usage: rng_battery [options]
+//    --samples N      samples per source, default 1000000
+//    --source NAME    tests one source only, see kSources
+//    --seed N         seed of the simulated RNG, default 1
+//    --random-seed N  seed of the deterministic mode of the Generator,
+//                     default 0 (simulated RNG)
+//    --rng-file FILE  raw 32-bit words for the simulated RNG, e.g. a capture
+//                     of the hardware RNG
+//    --export FILE    writes the samples of --source as raw 16-bit little
+//                     endian words, "-" for stdout (the report goes to stderr)
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#include "firmware.hpp"
+#include "statistics.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace {
+
+using tkrandom::Distribution;
+using tkrandom::Output;
+using tkrandom::sim::Mcu;
+using tkrandom::sim::SampleModel;
+using tkrandom::sim::SampleModelKind;
+using tkrandom::sim::TestBattery;
+using tkrandom::sim::TestResult;
+
+//! enum type for the sample paths
+enum class Path : uint8_t {
+  kSingle,   //!< GetUniformRandomNumber() or GetNormalRandomNumber()
+  kBlock,    //!< Generator::Fill() as used by the RngHandler buffers
+  kOutputs   //!< DAC values of outputs 1 .. 4 set by SetOutputsLeds()
+};
+
+//! sample source
+struct Source {
+  const char* name;             //!< name in the report
+  Path path;                    //!< sample path
+  Distribution distribution;    //!< distribution of the generator
+  SampleModelKind model;        //!< expected distribution of the samples
+};
+
+//! sources of the report
+const Source kSources[] = {
+    {"uniform", Path::kSingle, Distribution::kUniform,
+     SampleModelKind::kUniform},
+    {"normal", Path::kSingle, Distribution::kNormal,
+     SampleModelKind::kNormalSum},
+    {"uniform-block", Path::kBlock, Distribution::kUniform,
+     SampleModelKind::kUniform},
+    {"normal-block", Path::kBlock, Distribution::kNormal,
+     SampleModelKind::kNormalPairwise},
+    {"uniform-outputs", Path::kOutputs, Distribution::kUniform,
+     SampleModelKind::kUniform},
+    {"normal-outputs", Path::kOutputs, Distribution::kNormal,
+     SampleModelKind::kNormalPairwise}};
+
+//! command line options
+struct Options {
+  uint64_t sample_count = 1000000U;
+  const char* source = nullptr;
+  uint64_t seed = 1U;
+  uint16_t random_seed = 0U;
+  const char* rng_path = nullptr;
+  const char* export_path = nullptr;
+};
+
+//! receiver of the samples: battery and exporter
+class Sink {
+ public:
+  Sink(TestBattery& battery, std::FILE* const file)
+      : battery_(battery), file_(file), buffer_{}, size_(0U) {}
+
+  ~Sink(void) { Flush(); }
+
+  Sink(const Sink&) = delete;
+  Sink& operator=(Sink const&) = delete;
+
+  void Add(const uint16_t sample) {
+    battery_.Add(sample);
+    if (file_ != nullptr) {
+      buffer_[size_] = static_cast<uint8_t>(sample);
+      buffer_[size_ + 1U] = static_cast<uint8_t>(sample >> 8U);
+      size_ += 2U;
+      if (size_ == sizeof(buffer_)) {
+        Flush();
+      }
+    }
+  }
+
+  uint64_t GetCount(void) const { return battery_.GetCount(); }
+
+ private:
+  void Flush(void) {
+    if ((file_ != nullptr) && (size_ > 0U)) {
+      std::fwrite(buffer_, 1U, size_, file_);
+      size_ = 0U;
+    }
+  }
+
+  TestBattery& battery_;
+  std::FILE* const file_;
+  uint8_t buffer_[8192];
+  size_t size_;
+};
+
+//! feeds the DAC values of outputs 1 .. 4 into the sink
+void OnDacUpdate(const tkrandom::sim::DacUpdate& update, void* context) {
+  if (update.channel <= static_cast<uint8_t>(Output::kOutput4)) {
+    static_cast<Sink*>(context)->Add(update.value);
+  }
+}
+
+//! streams the samples of a source
+//! \return false if the generator reported an error
+bool Stream(const Source& source, const uint64_t sample_count,
+            Sink* const sink) {
+  bool return_value = true;
+  const tkrandom::Generator& generator = tkrandom::sim::generator;
+
+  switch (source.path) {
+    case Path::kSingle:
+      while (return_value && (sink->GetCount() < sample_count)) {
+        uint16_t sample = 0U;
+        const tkrandom::GeneratorStatus status =
+            (source.distribution == Distribution::kNormal)
+                ? generator.GetNormalRandomNumber(&sample)
+                : generator.GetUniformRandomNumber(&sample);
+        return_value = status == tkrandom::GeneratorStatus::kSuccess;
+        sink->Add(sample);
+      }
+      break;
+    case Path::kBlock: {
+      uint16_t block[64];
+      while (return_value && (sink->GetCount() < sample_count)) {
+        return_value = generator.Fill(block, std::size(block),
+                                      source.distribution) ==
+                       tkrandom::GeneratorStatus::kSuccess;
+        for (const uint16_t sample : block) {
+          if (sink->GetCount() < sample_count) {
+            sink->Add(sample);
+          }
+        }
+      }
+      break;
+    }
+    case Path::kOutputs: {
+      // the gate work of both inputs, called directly with the loop stopped
+      tkrandom::RngHandler& rng_handler = tkrandom::sim::rng_handler;
+      uint8_t output = static_cast<uint8_t>(Output::kOutput1);
+      while (output <= static_cast<uint8_t>(Output::kOutput4)) {
+        rng_handler.SetDistribution(static_cast<Output>(output),
+                                    source.distribution);
+        output++;
+      }
+      Mcu::GetDac().SetListener(&OnDacUpdate, sink);
+      while (return_value && (sink->GetCount() < sample_count)) {
+        return_value = rng_handler.SetOutputsLeds(true, true) ==
+                       tkrandom::RngHandlerStatus::kSuccess;
+      }
+      Mcu::GetDac().SetListener(nullptr, nullptr);
+      break;
+    }
+    default:
+      break;
+  }
+
+  return return_value;
+}
+
+//! parses the command line
+//! \return false on unknown or incomplete options
+bool ParseOptions(const int argc, char** const argv, Options* const options) {
+  bool return_value = true;
+
+  for (int i = 1; (i < argc) && return_value; ++i) {
+    const char* const option = argv[i];
+    const char* const value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (value == nullptr) {
+      return_value = false;
+    }
+    else if (std::strcmp(option, "--samples") == 0) {
+      options->sample_count = std::strtoull(value, nullptr, 0);
+    }
+    else if (std::strcmp(option, "--source") == 0) {
+      options->source = value;
+    }
+    else if (std::strcmp(option, "--seed") == 0) {
+      options->seed = std::strtoull(value, nullptr, 0);
+    }
+    else if (std::strcmp(option, "--random-seed") == 0) {
+      options->random_seed =
+          static_cast<uint16_t>(std::strtoul(value, nullptr, 0));
+    }
+    else if (std::strcmp(option, "--rng-file") == 0) {
+      options->rng_path = value;
+    }
+    else if (std::strcmp(option, "--export") == 0) {
+      options->export_path = value;
+    }
+    else {
+      return_value = false;
+    }
+    i++;
+  }
+  if ((options->export_path != nullptr) && (options->source == nullptr)) {
+    std::fprintf(stderr, "--export needs --source\n");
+    return_value = false;
+  }
+  if (!return_value) {
+    std::fprintf(stderr, "usage: rng_battery [--samples N] [--source NAME] "
+                         "[--seed N] [--random-seed N] [--rng-file FILE] "
+                         "[--export FILE]\n");
+  }
+
+  return return_value;
+}
+
+}  // namespace
+
+// MAIN ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Options options;
+  std::FILE* export_file = nullptr;
+  std::FILE* report = stdout;
+  bool is_passed = true;
+  bool has_source = false;
+
+  if (!ParseOptions(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+  if (options.export_path != nullptr) {
+    if (std::strcmp(options.export_path, "-") == 0) {
+      export_file = stdout;
+      report = stderr;
+    }
+    else {
+      export_file = std::fopen(options.export_path, "wb");
+      if (export_file == nullptr) {
+        std::fprintf(stderr, "cannot write %s\n", options.export_path);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  for (const Source& source : kSources) {
+    if ((options.source != nullptr) &&
+        (std::strcmp(options.source, source.name) != 0)) {
+      continue;
+    }
+    has_source = true;
+    Mcu::GetRngSource().Seed(options.seed);
+    if ((options.rng_path != nullptr) &&
+        !Mcu::GetRngSource().Open(options.rng_path)) {
+      std::fprintf(stderr, "cannot read RNG words from %s\n",
+                   options.rng_path);
+      return EXIT_FAILURE;
+    }
+    tkrandom::sim::InitFirmware(options.random_seed);
+
+    const SampleModel model(source.model);
+    TestBattery battery(model);
+    bool is_source_passed = true;
+    {
+      Sink sink(battery, export_file);
+      if (!Stream(source, options.sample_count, &sink)) {
+        std::fprintf(report, "%s: generator error\n", source.name);
+        is_source_passed = false;
+      }
+    }
+
+    TestResult results[TestBattery::kTestCount];
+    battery.Evaluate(results);
+    std::fprintf(report, "%s, %llu samples\n", source.name,
+                 static_cast<unsigned long long>(battery.GetCount()));
+    for (const TestResult& result : results) {
+      if (!result.is_applicable) {
+        std::fprintf(report, "  %-20s %12s %10s  skipped\n", result.name, "-",
+                     "-");
+        continue;
+      }
+      const bool is_test_passed = result.p_value >= TestBattery::kAlpha;
+      std::fprintf(report, "  %-20s %12.4f %10.4g  %s\n", result.name,
+                   result.statistic, result.p_value,
+                   is_test_passed ? "pass" : "FAIL");
+      is_source_passed = is_source_passed && is_test_passed;
+    }
+    std::fprintf(report, "%s: %s\n\n", source.name,
+                 is_source_passed ? "PASS" : "FAIL");
+    is_passed = is_passed && is_source_passed;
+  }
+
+  if ((export_file != nullptr) && (export_file != stdout)) {
+    std::fclose(export_file);
+  }
+  if (!has_source) {
+    std::fprintf(stderr, "unknown source %s\n", options.source);
+    is_passed = false;
+  }
+  return is_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+//! \brief     Class definition of the entropy source of the simulated RNG.
+//! \details   Delivers 32-bit words from a seeded SplitMix64 generator or
+//!            from a file, e.g. a capture of the hardware RNG.
+//! \file      rng_source.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "rng_source.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+namespace sim {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+RngSource::~RngSource() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+//------------------------------------------------------------------------------
+void RngSource::Seed(const uint64_t seed) {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+  state_ = seed;
+  has_spare_ = false;
+}
+//------------------------------------------------------------------------------
+bool RngSource::Open(const char* const path) {
+  bool return_value = false;
+  std::FILE* const file = std::fopen(path, "rb");
+
+  if (file != nullptr) {
+    uint8_t bytes[4];
+    if (std::fread(bytes, 1U, sizeof(bytes), file) == sizeof(bytes)) {
+      std::rewind(file);
+      Seed(0U);
+      file_ = file;
+      return_value = true;
+    }
+    else {
+      std::fclose(file);
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t RngSource::Next() {
+  uint32_t return_value = 0U;
+
+  if (file_ != nullptr) {
+    uint8_t bytes[4];
+    if (std::fread(bytes, 1U, sizeof(bytes), file_) != sizeof(bytes)) {
+      std::rewind(file_);
+      static_cast<void>(std::fread(bytes, 1U, sizeof(bytes), file_));
+    }
+    return_value = static_cast<uint32_t>(bytes[0]) |
+                   (static_cast<uint32_t>(bytes[1]) << 8U) |
+                   (static_cast<uint32_t>(bytes[2]) << 16U) |
+                   (static_cast<uint32_t>(bytes[3]) << 24U);
+  }
+  else if (has_spare_) {
+    has_spare_ = false;
+    return_value = spare_;
+  }
+  else {
+    // SplitMix64, two words per step
+    state_ += 0x9E3779B97F4A7C15U;
+    uint64_t z = state_;
+    z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9U;
+    z = (z ^ (z >> 27U)) * 0x94D049BB133111EBU;
+    z = z ^ (z >> 31U);
+    spare_ = static_cast<uint32_t>(z >> 32U);
+    has_spare_ = true;
+    return_value = static_cast<uint32_t>(z);
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void RngSource::SetFault(const bool has_fault) {
+  has_fault_ = has_fault;
+}
+//------------------------------------------------------------------------------
+bool RngSource::HasFault() const {
+  return has_fault_;
+}
+
+}  // namespace sim
+}  // namespace tkrandom
@@ -0,0 +1,284 @@
+//! \brief     Stand-in HAL functions, intrinsics and register proxies.
+//! \details   Forwards everything with side effects to the simulated MCU.
+//! \file      sim_hal.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+
+#include "stm32l4xx_hal.h"
+#include "clock_tree.hpp"
+#include "mcu.hpp"
+
+// MICS ------------------------------------------------------------------------
+using tkrandom::sim::ClockTree;
+using tkrandom::sim::Mcu;
+
+__IO uint32_t uwTick = 0U;
+
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+SCB_Type sim_scb;
+RCC_TypeDef sim_rcc;
+IWDG_TypeDef sim_iwdg;
+FLASH_TypeDef sim_flash;
+ADC_TypeDef sim_adc1;
+ADC_Common_TypeDef sim_adc12_common;
+DMA_Channel_TypeDef sim_dma1_channel1;
+DMA_Request_TypeDef sim_dma1_cselr;
+RNG_TypeDef sim_rng;
+SPI_TypeDef sim_spi1;
+TIM_TypeDef sim_tim6;
+TIM_TypeDef sim_tim15;
+TIM_TypeDef sim_tim16;
+
+// REGISTER PROXIES ------------------------------------------------------------
+uint32_t SimReadRngStatus() {
+  return Mcu::ReadRngStatus();
+}
+
+uint32_t SimReadRngData() {
+  return Mcu::ReadRngData();
+}
+
+uint32_t SimReadSpiStatus() {
+  return Mcu::ReadSpiStatus();
+}
+
+uint32_t SimReadSpiData(const uint32_t size) {
+  return Mcu::ReadSpiData(size);
+}
+
+void SimWriteSpiData(const uint32_t value, const uint32_t size) {
+  Mcu::WriteSpiData(value, size);
+}
+
+uint32_t SimReadCycleCounter() {
+  return Mcu::ReadCycleCounter();
+}
+
+void SimWriteCycleCounter(const uint32_t value) {
+  Mcu::WriteCycleCounter(value);
+}
+
+uint32_t SimReadInterruptControl() {
+  return Mcu::ReadInterruptControl();
+}
+
+void SimWriteInterruptControl(const uint32_t value) {
+  Mcu::WriteInterruptControl(value);
+}
+
+SimGpioSetResetRegister& SimGpioSetResetRegister::operator=(
+    const uint32_t value) {
+  GPIO_TypeDef* const port = reinterpret_cast<GPIO_TypeDef*>(
+      reinterpret_cast<uintptr_t>(this) - offsetof(GPIO_TypeDef, BSRR));
+  Mcu::WriteGpio(port, value);
+  return *this;
+}
+
+// CMSIS INTRINSICS ------------------------------------------------------------
+uint32_t __get_PRIMASK() {
+  return Mcu::GetPrimask();
+}
+
+void __set_PRIMASK(const uint32_t primask) {
+  Mcu::SetPrimask(primask);
+}
+
+void __disable_irq() {
+  Mcu::SetPrimask(1U);
+}
+
+void __enable_irq() {
+  Mcu::SetPrimask(0U);
+}
+
+uint32_t __get_BASEPRI() {
+  return Mcu::GetBasepri();
+}
+
+void __set_BASEPRI(const uint32_t basepri) {
+  Mcu::SetBasepri(basepri, false);
+}
+
+void __set_BASEPRI_MAX(const uint32_t basepri) {
+  Mcu::SetBasepri(basepri, true);
+}
+
+void NVIC_SystemReset() {
+  std::fprintf(stderr, "sim: NVIC_SystemReset() at cycle %llu\n",
+               static_cast<unsigned long long>(Mcu::GetCycles()));
+  std::abort();
+}
+
+// HAL FUNCTIONS ---------------------------------------------------------------
+uint32_t HAL_GetTick() {
+  // timeout loops poll the tick, so every call takes some time
+  Mcu::Charge(Mcu::GetCostModel().register_access);
+  return uwTick;
+}
+
+uint32_t HAL_RCC_GetHCLKFreq() {
+  return ClockTree::GetHclk();
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq() {
+  return ClockTree::GetHclk();
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* const osc_init) {
+  Mcu::Charge(Mcu::GetCostModel().hal_call);
+  return ClockTree::ConfigureOscillators(osc_init);
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* const clk_init,
+                                      const uint32_t flash_latency) {
+  Mcu::Charge(Mcu::GetCostModel().hal_call);
+  return ClockTree::ConfigureClocks(clk_init, flash_latency);
+}
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(
+    const uint32_t voltage_scaling) {
+  Mcu::Charge(Mcu::GetCostModel().hal_call);
+  return ClockTree::SetVoltageScaling(voltage_scaling);
+}
+
+HAL_StatusTypeDef HAL_RNG_Init(RNG_HandleTypeDef* const hrng) {
+  hrng->ErrorCode = 0U;
+  Mcu::ResetRng();
+  Mcu::Charge(Mcu::GetCostModel().hal_call);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RNG_DeInit(RNG_HandleTypeDef* const hrng) {
+  static_cast<void>(hrng);
+  Mcu::Charge(Mcu::GetCostModel().hal_call);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef* const hrng,
+                                               uint32_t* const random32bit) {
+  const HAL_StatusTypeDef hal_status = Mcu::GenerateRandomNumber(random32bit);
+  if (hal_status != HAL_OK) {
+    hrng->ErrorCode = 1U;
+  }
+  return hal_status;
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* const hspi) {
+  MODIFY_REG(hspi->Instance->CR1, SPI_CR1_BR, hspi->Init.BaudRatePrescaler);
+  hspi->ErrorCode = 0U;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef* const hspi) {
+  hspi->Instance->CR1 &= ~SPI_CR1_SPE;
+  Mcu::Charge(Mcu::GetCostModel().hal_call);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* const hspi,
+                                   uint8_t* const pData, const uint16_t Size,
+                                   const uint32_t Timeout) {
+  static_cast<void>(Timeout);
+  hspi->Instance->CR1 |= SPI_CR1_SPE;
+  return Mcu::TransmitSpi(hspi, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* const hspi,
+                                       uint8_t* const pData,
+                                       const uint16_t Size) {
+  hspi->Instance->CR1 |= SPI_CR1_SPE;
+  return Mcu::StartSpiDma(hspi, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* const hspi) {
+  static_cast<void>(hspi);
+  Mcu::AbortSpi();
+  return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(
+    SPI_HandleTypeDef* const hspi) {
+  static_cast<void>(hspi);
+}
+
+__attribute__((weak)) void HAL_SPI_ErrorCallback(
+    SPI_HandleTypeDef* const hspi) {
+  static_cast<void>(hspi);
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* const htim) {
+  htim->Instance->PSC = htim->Init.Prescaler;
+  htim->Instance->ARR = htim->Init.Period;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* const htim) {
+  return Mcu::StartTimer(htim);
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* const htim) {
+  Mcu::StopTimer(htim);
+  return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(
+    TIM_HandleTypeDef* const htim) {
+  static_cast<void>(htim);
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(const uint16_t GPIO_Pin) {
+  static_cast<void>(GPIO_Pin);
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock() {
+  Mcu::SetFlashLock(false);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock() {
+  Mcu::SetFlashLock(true);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program_IT(const uint32_t TypeProgram,
+                                       const uint32_t Address,
+                                       const uint64_t Data) {
+  HAL_StatusTypeDef return_value = HAL_ERROR;
+  if (TypeProgram == FLASH_TYPEPROGRAM_DOUBLEWORD) {
+    return_value = Mcu::StartFlashProgram(Address, Data);
+  }
+  return return_value;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(
+    FLASH_EraseInitTypeDef* const pEraseInit) {
+  HAL_StatusTypeDef return_value = HAL_ERROR;
+  if ((pEraseInit->TypeErase == FLASH_TYPEERASE_PAGES) &&
+      (pEraseInit->Banks == FLASH_BANK_1)) {
+    return_value = Mcu::StartFlashErase(pEraseInit->Page, pEraseInit->NbPages);
+  }
+  return return_value;
+}
+
+uint32_t HAL_FLASH_GetError() {
+  return Mcu::GetFlashError();
+}
+
+__attribute__((weak)) void HAL_FLASH_EndOfOperationCallback(
+    const uint32_t ReturnValue) {
+  static_cast<void>(ReturnValue);
+}
+
+__attribute__((weak)) void HAL_FLASH_OperationErrorCallback(
+    const uint32_t ReturnValue) {
+  static_cast<void>(ReturnValue);
+}
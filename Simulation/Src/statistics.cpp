@@ -0,0 +1,445 @@
+//! \brief     Class definitions of the statistical test battery.
+//! \details   Streaming tests of 16-bit random samples against the exact
+//!            distribution of the Generator paths, in constant memory.
+//! \file      statistics.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+namespace sim {
+
+namespace {
+
+//! exact counts of sums, up to 2^64 for four 16-bit numbers
+using Counts = std::vector<__int128>;
+
+//! counts of f + g for piecewise linear counts g
+//! \details the second difference of g has a few entries only, so the second
+//!          difference of the result is a few shifted copies of f
+Counts Convolve(const Counts& f, const Counts& g) {
+  const size_t size = f.size() + g.size() - 1U;
+  Counts result(size + 2U, 0);
+
+  for (size_t k = 0U; k < g.size() + 2U; ++k) {
+    __int128 difference = (k < g.size()) ? g[k] : 0;
+    difference -= ((k >= 1U) && (k - 1U < g.size())) ? 2 * g[k - 1U] : 0;
+    difference += ((k >= 2U) && (k - 2U < g.size())) ? g[k - 2U] : 0;
+    if (difference != 0) {
+      for (size_t i = 0U; i < f.size(); ++i) {
+        result[i + k] += f[i] * difference;
+      }
+    }
+  }
+  for (uint32_t pass = 0U; pass < 2U; ++pass) {
+    for (size_t i = 1U; i < result.size(); ++i) {
+      result[i] += result[i - 1U];
+    }
+  }
+  result.resize(size);
+  return result;
+}
+
+//! regularized upper incomplete gamma function Q(a, x)
+double GammaQ(const double a, const double x) {
+  double return_value = 1.0;
+  const double log_prefactor = -x + (a * std::log(x)) - std::lgamma(a);
+
+  if ((x <= 0.0) || (a <= 0.0)) {
+    return_value = 1.0;
+  }
+  else if (x < a + 1.0) {
+    // series of P(a, x)
+    double term = 1.0 / a;
+    double sum = term;
+    for (double n = a + 1.0; std::fabs(term) > std::fabs(sum) * 1e-16;
+         n += 1.0) {
+      term *= x / n;
+      sum += term;
+    }
+    return_value = 1.0 - (sum * std::exp(log_prefactor));
+  }
+  else {
+    // continued fraction of Q(a, x), modified Lentz
+    const double tiny = 1e-300;
+    double b = x + 1.0 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i < 10000; ++i) {
+      const double an = -i * (i - a);
+      b += 2.0;
+      d = (an * d) + b;
+      d = (std::fabs(d) < tiny) ? tiny : d;
+      c = b + (an / c);
+      c = (std::fabs(c) < tiny) ? tiny : c;
+      d = 1.0 / d;
+      const double delta = d * c;
+      h *= delta;
+      if (std::fabs(delta - 1.0) < 1e-16) {
+        break;
+      }
+    }
+    return_value = std::exp(log_prefactor) * h;
+  }
+
+  return std::clamp(return_value, 0.0, 1.0);
+}
+
+//! Kolmogorov distribution P(K > lambda)
+double KolmogorovQ(const double lambda) {
+  double return_value = 1.0;
+
+  if (lambda > 0.2) {
+    double sum = 0.0;
+    double sign = 1.0;
+    for (int k = 1; k <= 100; ++k) {
+      const double term = sign * std::exp(-2.0 * k * k * lambda * lambda);
+      sum += term;
+      if (std::fabs(term) < 1e-16) {
+        break;
+      }
+      sign = -sign;
+    }
+    return_value = std::clamp(2.0 * sum, 0.0, 1.0);
+  }
+
+  return return_value;
+}
+
+//! two-sided p-value of a standard normal statistic
+double NormalP(const double z) {
+  return std::erfc(std::fabs(z) / std::sqrt(2.0));
+}
+
+//! chi-square test of classes, neighbours are merged to >= 5 expected
+//! \param[in] observed observed counts per class
+//! \param[in] expected expected counts per class
+//! \param[in] name name of the test
+TestResult ChiSquare(const std::vector<double>& observed,
+                     const std::vector<double>& expected,
+                     const char* const name) {
+  TestResult result = {name, 0.0, 1.0, false};
+  std::vector<double> merged_observed;
+  std::vector<double> merged_expected;
+  double observed_sum = 0.0;
+  double expected_sum = 0.0;
+
+  for (size_t i = 0U; i < observed.size(); ++i) {
+    observed_sum += observed[i];
+    expected_sum += expected[i];
+    if (expected_sum >= 5.0) {
+      merged_observed.push_back(observed_sum);
+      merged_expected.push_back(expected_sum);
+      observed_sum = 0.0;
+      expected_sum = 0.0;
+    }
+  }
+  if (!merged_expected.empty()) {
+    merged_observed.back() += observed_sum;
+    merged_expected.back() += expected_sum;
+  }
+  if (merged_expected.size() >= 2U) {
+    for (size_t i = 0U; i < merged_expected.size(); ++i) {
+      const double difference = merged_observed[i] - merged_expected[i];
+      result.statistic += (difference * difference) / merged_expected[i];
+    }
+    const double freedom = static_cast<double>(merged_expected.size() - 1U);
+    result.p_value = GammaQ(freedom / 2.0, result.statistic / 2.0);
+    result.is_applicable = true;
+  }
+  return result;
+}
+
+}  // namespace
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+SampleModel::SampleModel(const SampleModelKind kind)
+    : kind_(kind),
+      probabilities_(kValueCount, 1.0 / kValueCount),
+      cdf_(kValueCount, 0.0) {
+  if (kind_ != SampleModelKind::kUniform) {
+    const Counts uniform(kValueCount, 1);
+    const Counts pair = Convolve(uniform, uniform);
+    if (kind_ == SampleModelKind::kNormalSum) {
+      // sum of four, divided by 4
+      const Counts sum = Convolve(pair, pair);
+      for (uint32_t value = 0U; value < kValueCount; ++value) {
+        __int128 count = 0;
+        for (uint32_t i = 0U; i < 4U; ++i) {
+          count += ((4U * value) + i < sum.size()) ? sum[(4U * value) + i] : 0;
+        }
+        probabilities_[value] = std::ldexp(static_cast<double>(count), -64);
+      }
+    }
+    else {
+      // two halved pair sums, halved again
+      Counts half(kValueCount, 0);
+      for (uint32_t value = 0U; value < kValueCount; ++value) {
+        half[value] = pair[2U * value];
+        half[value] += ((2U * value) + 1U < pair.size()) ?
+                       pair[(2U * value) + 1U] : 0;
+      }
+      const Counts sum = Convolve(half, half);
+      for (uint32_t value = 0U; value < kValueCount; ++value) {
+        __int128 count = sum[2U * value];
+        count += ((2U * value) + 1U < sum.size()) ? sum[(2U * value) + 1U] : 0;
+        probabilities_[value] = std::ldexp(static_cast<double>(count), -64);
+      }
+    }
+  }
+  long double cumulated = 0.0L;
+  for (uint32_t value = 0U; value < kValueCount; ++value) {
+    cumulated += probabilities_[value];
+    cdf_[value] = static_cast<double>(cumulated);
+  }
+  cdf_[kValueCount - 1U] = 1.0;
+}
+//------------------------------------------------------------------------------
+double SampleModel::GetProbability(const uint32_t value) const {
+  return (value < kValueCount) ? probabilities_[value] : 0.0;
+}
+//------------------------------------------------------------------------------
+double SampleModel::GetCdf(const uint32_t value) const {
+  return (value < kValueCount) ? cdf_[value] : 1.0;
+}
+//------------------------------------------------------------------------------
+uint32_t SampleModel::GetQuantile(const double probability) const {
+  const auto position = std::lower_bound(cdf_.begin(), cdf_.end(),
+                                         probability);
+  return static_cast<uint32_t>(
+      std::min<std::ptrdiff_t>(position - cdf_.begin(), kValueCount - 1U));
+}
+//------------------------------------------------------------------------------
+SampleModelKind SampleModel::GetKind() const {
+  return kind_;
+}
+//------------------------------------------------------------------------------
+TestBattery::TestBattery(const SampleModel& model)
+    : model_(model),
+      is_uniform_(model.GetKind() == SampleModelKind::kUniform),
+      count_(0U),
+      histogram_(SampleModel::kValueCount, 0U),
+      run_threshold_(model.GetQuantile(0.5)),
+      runs_(0U),
+      was_above_(false),
+      sum_(0U),
+      sum_squares_(0U),
+      sum_products_(0U),
+      first_(0U),
+      previous_(0U),
+      birthdays_(kBirthdays_, 0U),
+      spacings_(kBirthdays_, 0U),
+      birthday_count_(0U),
+      has_birthday_half_(false),
+      birthday_classes_{},
+      gap_low_(model.GetQuantile(0.4)),
+      gap_high_(model.GetQuantile(0.6)),
+      gap_length_(-1),
+      gap_classes_{} {}
+//------------------------------------------------------------------------------
+void TestBattery::Add(const uint16_t sample) {
+  const bool is_above = sample > run_threshold_;
+
+  histogram_[sample]++;
+  if (count_ == 0U) {
+    first_ = sample;
+    runs_ = 1U;
+  }
+  else {
+    runs_ += (is_above != was_above_) ? 1U : 0U;
+    sum_products_ += static_cast<uint32_t>(previous_) * sample;
+  }
+  count_++;
+  was_above_ = is_above;
+  previous_ = sample;
+  sum_ += sample;
+  sum_squares_ += static_cast<uint32_t>(sample) * sample;
+
+  if ((sample >= gap_low_) && (sample <= gap_high_)) {
+    if (gap_length_ >= 0) {
+      gap_classes_[std::min<int64_t>(gap_length_, kGapClasses_ - 1U)]++;
+    }
+    gap_length_ = 0;
+  }
+  else if (gap_length_ >= 0) {
+    gap_length_++;
+  }
+
+  if (is_uniform_) {
+    if (!has_birthday_half_) {
+      birthdays_[birthday_count_] = static_cast<uint32_t>(sample) << 16U;
+      has_birthday_half_ = true;
+    }
+    else {
+      birthdays_[birthday_count_] |= sample;
+      has_birthday_half_ = false;
+      birthday_count_++;
+      if (birthday_count_ == kBirthdays_) {
+        CountBirthdaySpacings();
+      }
+    }
+  }
+}
+//------------------------------------------------------------------------------
+uint64_t TestBattery::GetCount() const {
+  return count_;
+}
+//------------------------------------------------------------------------------
+void TestBattery::Evaluate(TestResult* const results) const {
+  results[0U] = EvaluateChiSquare();
+  results[1U] = EvaluateKolmogorovSmirnov();
+  results[2U] = EvaluateRuns();
+  results[3U] = EvaluateSerialCorrelation();
+  results[4U] = EvaluateBirthdaySpacings();
+  results[5U] = EvaluateGaps();
+}
+//------------------------------------------------------------------------------
+TestResult TestBattery::EvaluateChiSquare() const {
+  std::vector<double> observed(256U, 0.0);
+  std::vector<double> expected(256U, 0.0);
+
+  for (uint32_t value = 0U; value < SampleModel::kValueCount; ++value) {
+    observed[value >> 8U] += static_cast<double>(histogram_[value]);
+    expected[value >> 8U] += static_cast<double>(count_) *
+                             model_.GetProbability(value);
+  }
+  return ChiSquare(observed, expected, "chi-square");
+}
+//------------------------------------------------------------------------------
+TestResult TestBattery::EvaluateKolmogorovSmirnov() const {
+  TestResult result = {"kolmogorov-smirnov", 0.0, 1.0, false};
+
+  if (count_ > 0U) {
+    const double n = static_cast<double>(count_);
+    uint64_t cumulated = 0U;
+    for (uint32_t value = 0U; value < SampleModel::kValueCount; ++value) {
+      cumulated += histogram_[value];
+      const double distance =
+          std::fabs((static_cast<double>(cumulated) / n) -
+                    model_.GetCdf(value));
+      result.statistic = std::max(result.statistic, distance);
+    }
+    // conservative for discrete distributions
+    const double root = std::sqrt(n);
+    result.p_value =
+        KolmogorovQ((root + 0.12 + (0.11 / root)) * result.statistic);
+    result.is_applicable = true;
+  }
+  return result;
+}
+//------------------------------------------------------------------------------
+TestResult TestBattery::EvaluateRuns() const {
+  TestResult result = {"runs", 0.0, 1.0, false};
+  const double p = 1.0 - model_.GetCdf(run_threshold_);
+  const double q = 1.0 - p;
+
+  if (count_ > 2U) {
+    // R = 1 + number of class changes, neighbouring changes are correlated
+    const double n = static_cast<double>(count_);
+    const double change = 2.0 * p * q;
+    const double mean = 1.0 + ((n - 1.0) * change);
+    const double variance = ((n - 1.0) * change * (1.0 - change)) +
+                            (2.0 * (n - 2.0) * ((p * q) - (change * change)));
+    result.statistic = (static_cast<double>(runs_) - mean) /
+                       std::sqrt(variance);
+    result.p_value = NormalP(result.statistic);
+    result.is_applicable = true;
+  }
+  return result;
+}
+//------------------------------------------------------------------------------
+TestResult TestBattery::EvaluateSerialCorrelation() const {
+  TestResult result = {"serial-correlation", 0.0, 1.0, false};
+
+  if (count_ > 2U) {
+    const long double n = static_cast<long double>(count_);
+    const long double mean = static_cast<long double>(sum_) / n;
+    const long double variance =
+        (static_cast<long double>(sum_squares_) / n) - (mean * mean);
+    // circular lag-1 products
+    const long double products =
+        static_cast<long double>(sum_products_) +
+        (static_cast<long double>(previous_) * first_);
+    if (variance > 0.0L) {
+      const long double correlation =
+          ((products / n) - (mean * mean)) / variance;
+      result.statistic = static_cast<double>(correlation * std::sqrt(n));
+      result.p_value = NormalP(result.statistic);
+      result.is_applicable = true;
+    }
+  }
+  return result;
+}
+//------------------------------------------------------------------------------
+TestResult TestBattery::EvaluateBirthdaySpacings() const {
+  TestResult result = {"birthday-spacings", 0.0, 1.0, false};
+
+  if (is_uniform_) {
+    double blocks = 0.0;
+    for (const uint64_t count : birthday_classes_) {
+      blocks += static_cast<double>(count);
+    }
+    std::vector<double> observed(kBirthdayClasses_, 0.0);
+    std::vector<double> expected(kBirthdayClasses_, 0.0);
+    double probability = std::exp(-kBirthdayLambda_);
+    double tail = 1.0;
+    for (uint32_t j = 0U; j < kBirthdayClasses_; ++j) {
+      observed[j] = static_cast<double>(birthday_classes_[j]);
+      expected[j] = blocks * ((j + 1U < kBirthdayClasses_) ? probability
+                                                           : tail);
+      tail -= probability;
+      probability *= kBirthdayLambda_ / (j + 1U);
+    }
+    result = ChiSquare(observed, expected, "birthday-spacings");
+  }
+  return result;
+}
+//------------------------------------------------------------------------------
+TestResult TestBattery::EvaluateGaps() const {
+  const double p = model_.GetCdf(gap_high_) -
+                   ((gap_low_ > 0U) ? model_.GetCdf(gap_low_ - 1U) : 0.0);
+  double gaps = 0.0;
+  for (const uint64_t count : gap_classes_) {
+    gaps += static_cast<double>(count);
+  }
+  std::vector<double> observed(kGapClasses_, 0.0);
+  std::vector<double> expected(kGapClasses_, 0.0);
+  double miss = 1.0;
+  for (uint32_t length = 0U; length < kGapClasses_; ++length) {
+    observed[length] = static_cast<double>(gap_classes_[length]);
+    expected[length] = gaps * ((length + 1U < kGapClasses_) ? (p * miss)
+                                                            : miss);
+    miss *= 1.0 - p;
+  }
+  return ChiSquare(observed, expected, "gaps");
+}
+//------------------------------------------------------------------------------
+void TestBattery::CountBirthdaySpacings() {
+  std::sort(birthdays_.begin(), birthdays_.end());
+  spacings_[0U] = birthdays_[0U];
+  for (uint32_t i = 1U; i < kBirthdays_; ++i) {
+    spacings_[i] = birthdays_[i] - birthdays_[i - 1U];
+  }
+  std::sort(spacings_.begin(), spacings_.end());
+  uint32_t duplicates = 0U;
+  for (uint32_t i = 1U; i < kBirthdays_; ++i) {
+    duplicates += (spacings_[i] == spacings_[i - 1U]) ? 1U : 0U;
+  }
+  birthday_classes_[std::min(duplicates, kBirthdayClasses_ - 1U)]++;
+  birthday_count_ = 0U;
+}
+
+}  // namespace sim
+}  // namespace tkrandom
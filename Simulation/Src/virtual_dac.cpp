@@ -0,0 +1,96 @@
+//! \brief     Class definition of the simulated 8-channel DAC.
+//! \details   Decodes the SPI frames of the Transmitter into timestamped
+//!            channel updates, latched by the rising edge of NSS.
+//! \file      virtual_dac.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "virtual_dac.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+namespace sim {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void VirtualDac::Clear() {
+  for (uint16_t& value : values_) {
+    value = 0U;
+  }
+  shift_register_ = 0U;
+  shifted_bits_ = 0U;
+  update_count_ = 0U;
+  frame_error_count_ = 0U;
+}
+//------------------------------------------------------------------------------
+void VirtualDac::SetListener(const DacListener listener, void* const context) {
+  listener_ = listener;
+  listener_context_ = context;
+}
+//------------------------------------------------------------------------------
+void VirtualDac::SetNss(const bool is_high, const uint64_t cycle) {
+  if (!is_high && !is_selected_) {
+    shift_register_ = 0U;
+    shifted_bits_ = 0U;
+  }
+  if (is_high && is_selected_ && !is_reset_) {
+    const uint32_t command = (shift_register_ >> 20U) & 0xFU;
+    const uint32_t channel = (shift_register_ >> 16U) & 0xFU;
+    if ((shifted_bits_ == kFrameBits_) && (command == kWriteUpdateCommand_) &&
+        (channel < kChannelCount)) {
+      const DacUpdate update = {cycle, static_cast<uint8_t>(channel),
+                                static_cast<uint16_t>(shift_register_)};
+      values_[channel] = update.value;
+      update_count_++;
+      if (listener_ != nullptr) {
+        listener_(update, listener_context_);
+      }
+    }
+    else {
+      frame_error_count_++;
+    }
+  }
+  is_selected_ = !is_high;
+}
+//------------------------------------------------------------------------------
+void VirtualDac::SetReset(const bool is_high) {
+  is_reset_ = !is_high;
+  if (is_reset_) {
+    // power-on reset to zero scale
+    for (uint16_t& value : values_) {
+      value = 0U;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void VirtualDac::ShiftIn(const uint8_t* const data, const uint16_t size) {
+  if (is_selected_) {
+    for (uint16_t i = 0U; i < size; ++i) {
+      shift_register_ = (shift_register_ << 8U) | data[i];
+      shifted_bits_ += 8U;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+uint16_t VirtualDac::GetValue(const uint8_t channel) const {
+  uint16_t return_value = 0U;
+  if (channel < kChannelCount) {
+    return_value = values_[channel];
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint64_t VirtualDac::GetUpdateCount() const {
+  return update_count_;
+}
+//------------------------------------------------------------------------------
+uint64_t VirtualDac::GetFrameErrorCount() const {
+  return frame_error_count_;
+}
+
+}  // namespace sim
+}  // namespace tkrandom
@@ -1,5 +1,6 @@
 //! \brief     Class declaration for frontpanel LED animation.
-//! \details   Declaration of function members for LED switching patterns.
+//! \details   Declaration of function members for table-driven LED keyframe
+//!            animations.
 //! \file      animation.hpp
 //! \author    André Niederlein
 //! \date      2020-07-29
@@ -12,7 +13,9 @@
 #define ANIMATION_HPP_
 
 // INCLUDES --------------------------------------------------------------------
-#include "transmitter.hpp"
+#include <span>
+
+#include "led_refresher.hpp"
 #include "stm32l4xx_hal.h"
 
 namespace tkrandom {
@@ -21,19 +24,53 @@ namespace tkrandom {
 //! enum type for Animation member function return values
 enum class AnimationStatus {
   kCompleted,  //!< animation completed successfully
-  kOngoing,    //!< animation not completed yet
-  kError       //!< an error occurred
+  kOngoing     //!< animation not completed yet
+};
+
+//! enum type for the transition from a keyframe to the next one
+enum class Interpolation {
+  kStep,   //!< holds the keyframe until the next one
+  kLinear  //!< fades linearly to the next keyframe
 };
 
+//! brightness of the front panel LEDs at one point of an animation
+struct Keyframe {
+  uint16_t brightness[4];       //!< brightness of LED 1 .. 4
+  uint16_t duration;            //!< ms until the next keyframe
+  Interpolation interpolation;  //!< transition to the next keyframe
+};
+
+//! power-up animation: one light runs from LED 1 to LED 4 and back
+static const uint32_t kStartAnimationLength = 8U;
+static const Keyframe kStartAnimation[kStartAnimationLength] = {
+    {{0xFFFFU, 0x0000U, 0x0000U, 0x0000U}, 60U, Interpolation::kLinear},
+    {{0x0000U, 0xFFFFU, 0x0000U, 0x0000U}, 60U, Interpolation::kLinear},
+    {{0x0000U, 0x0000U, 0xFFFFU, 0x0000U}, 60U, Interpolation::kLinear},
+    {{0x0000U, 0x0000U, 0x0000U, 0xFFFFU}, 60U, Interpolation::kLinear},
+    {{0x0000U, 0x0000U, 0xFFFFU, 0x0000U}, 60U, Interpolation::kLinear},
+    {{0x0000U, 0xFFFFU, 0x0000U, 0x0000U}, 60U, Interpolation::kLinear},
+    {{0xFFFFU, 0x0000U, 0x0000U, 0x0000U}, 60U, Interpolation::kLinear},
+    {{0x0000U, 0x0000U, 0x0000U, 0x0000U}, 60U, Interpolation::kStep}};
+
 // CLASS DECLARATION -----------------------------------------------------------
 //! Animation class declaration
+//! \details plays a keyframe table as overlay of the LedRefresher, so the gate
+//!          work keeps running and the DAC frames are queued by the refresh.
+//!          Every keyframe is shown for its duration, the last one included,
+//!          then the LEDs show the values of the gate work again.
 class Animation {
  public:
   //! constructor
-  Animation(Transmitter& transmitter);
+  //! \param[in] led_refresher LedRefresher reference for the LED values
+  constexpr explicit Animation(LedRefresher& led_refresher)
+      : led_refresher_(led_refresher),
+        keyframes_(),
+        index_(0U),
+        elapsed_(0U),
+        is_running_(false) {}
 
   //! destructor
-  ~Animation(void) {}
+  ~Animation(void) = default;
 
   //! no copy constructor allowed since there is only one instance
   Animation(const Animation&) = delete;
@@ -41,35 +78,39 @@ class Animation {
   //! no assignment operator allowed since there is only one instance
   Animation& operator=(Animation const&) = delete;
 
-  //! clocks a short LED animation (after module is powered up)
-  //! \return kCompleted if animation completed successfully
-  AnimationStatus ClockAnimation(void);
+  //! starts an animation, a running one is replaced
+  //! \param[in] keyframes keyframe table, must outlive the animation
+  void Start(const std::span<const Keyframe> keyframes);
+
+  //! advances the running animation and sets the LED overlay
+  //! \details called by a periodic task ahead of LedRefresher::ProcessTick()
+  //! \param[in] elapsed ms since the last call
+  //! \return kCompleted if no animation is running (anymore)
+  AnimationStatus ProcessTick(const uint32_t elapsed);
 
  private:
-  //! enum type for the states of the internal LED animation state machine
-  enum class AnimationState {
-    kStateNone,     //!< animation not started or done
-    kState1,        //!< front panel LED 1 switched on
-    kState2,        //!< front panel LED 2 switched on
-    kState3,        //!< front panel LED 3 switched on
-    kState4,        //!< front panel LED 4 switched on
-    kState5,        //!< front panel LED 3 switched on
-    kState6,        //!< front panel LED 2 switched on
-    kState7,        //!< front panel LED 1 switched on
-    kStateComplete  //!< animation completed
-  };
-
-  //! switches one front panel LED on and one front panel LED off
-  //! \param[in] led_on LED that is switched on
-  //! \param[in] led_off LED that is switched off
-  //! \return kSuccess if no error occurs
-  TransmitterStatus SwitchLeds(const Led led_on, const Led led_off) const;
-
-  //! state of the internal state machine for the LED animation
-  AnimationState state_;
-
-  //! pointer to Transmitter instance for SPI transfers
-  Transmitter& transmitter_;
+  //! brightness of an LED between the current keyframe and the next one
+  //! \param[in] led index of the LED, 0 is LED 1
+  //! \return interpolated brightness
+  uint16_t Interpolate(const uint32_t led) const;
+
+  //! number of front panel LEDs
+  static const uint32_t kLedCount_ = 4U;
+
+  //! LedRefresher reference for the LED values
+  LedRefresher& led_refresher_;
+
+  //! keyframe table of the running animation
+  std::span<const Keyframe> keyframes_;
+
+  //! index of the current keyframe
+  uint32_t index_;
+
+  //! ms since the current keyframe started
+  uint32_t elapsed_;
+
+  //! true while an animation is running
+  bool is_running_;
 };
 
 }  // namespace tkrandom
@@ -0,0 +1,116 @@
+//! \brief     Compile-time description of the pins of the module PCB.
+//! \details   Pins are types, so every access compiles to one register access.
+//! \file      board.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef BOARD_HPP_
+#define BOARD_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! GPIO port given by the base address of its register block
+//! \tparam kBase peripheral base address, e.g. GPIOA_BASE
+template <uint32_t kBase>
+struct GpioPort {
+  //! getter for the register block of the port
+  //! \return pointer to the GPIO registers, resolved at compile time
+  static TKRANDOM_INLINE GPIO_TypeDef* Regs(void) {
+    return reinterpret_cast<GPIO_TypeDef*>(kBase);
+  }
+
+  //! reads the input levels of all 16 pins of the port with one access
+  //! \return content of the input data register
+  static TKRANDOM_INLINE uint32_t Read(void) {
+    return Regs()->IDR;
+  }
+};
+
+//! single GPIO pin given by its port type and pin number
+//! \tparam Port GpioPort the pin belongs to
+//! \tparam kNumber pin number within the port (0 .. 15)
+template <typename Port, uint32_t kNumber>
+struct GpioPin {
+  static_assert(kNumber < 16U, "a GPIO port has 16 pins");
+
+  //! bit mask of the pin, equals the HAL GPIO_PIN_x value
+  static constexpr uint16_t kMask = static_cast<uint16_t>(1U << kNumber);
+
+  //! drives the pin high by one BSRR write
+  static TKRANDOM_INLINE void Set(void) {
+    Port::Regs()->BSRR = kMask;
+  }
+
+  //! drives the pin low by one BSRR write
+  static TKRANDOM_INLINE void Reset(void) {
+    Port::Regs()->BSRR = static_cast<uint32_t>(kMask) << 16U;
+  }
+
+  //! inverts the output level of the pin
+  static TKRANDOM_INLINE void Toggle(void) {
+    GPIO_TypeDef* const regs = Port::Regs();
+    if ((regs->ODR & kMask) != 0U) {
+      regs->BSRR = static_cast<uint32_t>(kMask) << 16U;
+    }
+    else {
+      regs->BSRR = kMask;
+    }
+  }
+
+  //! reads the input level of the pin
+  //! \return true if the pin level is high
+  static TKRANDOM_INLINE bool IsSet(void) {
+    return (Port::Read() & kMask) != 0U;
+  }
+};
+
+//! group of neighboring pins of one port, read with a single IDR access
+//! \tparam Port GpioPort the pins belong to
+//! \tparam kFirst pin number of the lowest pin of the group
+//! \tparam kCount number of pins in the group
+template <typename Port, uint32_t kFirst, uint32_t kCount>
+struct GpioBank {
+  static_assert((kFirst + kCount) <= 16U, "a GPIO port has 16 pins");
+
+  //! mask of the group in the port register, equals the ORed GPIO_PIN_x values
+  static constexpr uint16_t kMask =
+      static_cast<uint16_t>(((1U << kCount) - 1U) << kFirst);
+
+  //! reads the input levels of all pins of the group
+  //! \return pin levels, bit 0 is the lowest pin of the group
+  static TKRANDOM_INLINE uint32_t Read(void) {
+    return (Port::Read() >> kFirst) & ((1U << kCount) - 1U);
+  }
+};
+
+//! GPIO ports used by the module
+using PortA = GpioPort<GPIOA_BASE>;
+using PortB = GpioPort<GPIOB_BASE>;
+
+// BOARD PINS ------------------------------------------------------------------
+//! pin assignment of the module PCB, must match the CubeMX configuration
+namespace board {
+
+using DacNss = GpioPin<PortA, 4U>;     //!< SPI NSS of the DAC (soft NSS)
+using DacReset = GpioPin<PortA, 6U>;   //!< reset line of the DAC, low active
+using StatusLed = GpioPin<PortB, 0U>;  //!< PCB status LED
+using Gate1 = GpioPin<PortB, 1U>;      //!< IN_1, low level is an open gate
+using Gate2 = GpioPin<PortA, 10U>;     //!< IN_2, low level is an open gate
+
+//! distribution switches 1 .. 4 on PB4 .. PB7, high level is normal
+using DistributionSwitches = GpioBank<PortB, 4U, 4U>;
+
+}  // namespace board
+
+}  // namespace tkrandom
+
+#endif  // BOARD_HPP_
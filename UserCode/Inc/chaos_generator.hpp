@@ -0,0 +1,145 @@
+//! \brief     Class declaration for deterministic chaotic number generation.
+//! \details   Logistic map, Lorenz attractor and Henon map in fixed point.
+//! \file      chaos_generator.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef CHAOS_GENERATOR_HPP_
+#define CHAOS_GENERATOR_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <stdint.h>
+
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the chaotic system iterated by ChaosGenerator
+enum class ChaosMap {
+  kLogistic,  //!< logistic map x' = r x (1 - x), Q0.32
+  kLorenz,    //!< Lorenz attractor, midpoint (RK2) integration, Q16.16
+  kHenon      //!< Henon map x' = 1 - a x^2 + y, y' = b x, Q3.28
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! ChaosGenerator class declaration
+//! \details integer arithmetic only, products are calculated with 64 bits
+class ChaosGenerator {
+ public:
+  //! constructor
+  //! \details starts with the initial states of SetMap(ChaosMap::kLogistic)
+  constexpr ChaosGenerator(void)
+      : map_(ChaosMap::kLogistic),
+        logistic_x_(kLogisticSeed_),
+        lorenz_x_(1 << 16),
+        lorenz_y_(1 << 16),
+        lorenz_z_(1 << 16),
+        henon_x_(1 << 25),
+        henon_y_(1 << 25) {}
+
+  //! destructor
+  ~ChaosGenerator(void) = default;
+
+  //! no copy constructor allowed since every output has its own instance
+  ChaosGenerator(const ChaosGenerator&) = delete;
+
+  //! no assignment operator allowed since every output has its own instance
+  ChaosGenerator& operator=(ChaosGenerator const&) = delete;
+
+  //! selects the chaotic system and resets it to its initial state
+  //! \param[in] map chaotic system that is iterated
+  void SetMap(const ChaosMap map);
+
+  //! getter for the selected chaotic system
+  //! \return chaotic system that is iterated
+  ChaosMap GetMap(void) const;
+
+  //! iterates the chaotic system by one step
+  //! \param[in] perturbation signed offset added to the state in 2^-16 units
+  void Step(const int32_t perturbation);
+
+  //! getter for the current state mapped to the DAC range
+  //! \return 16-bit value of the current state
+  uint16_t GetValue(void) const;
+
+ private:
+  //! one iteration of the logistic map
+  //! \param[in] perturbation signed offset in 2^-16 units
+  void StepLogistic(const int32_t perturbation);
+
+  //! one midpoint integration step of the Lorenz system
+  //! \param[in] perturbation signed offset in 2^-16 units
+  void StepLorenz(const int32_t perturbation);
+
+  //! one iteration of the Henon map
+  //! \param[in] perturbation signed offset in 2^-16 units
+  void StepHenon(const int32_t perturbation);
+
+  //! calculates the derivatives of the Lorenz system (Q16.16)
+  //! \param[in] x, y, z state of the Lorenz system
+  //! \param[out] dx, dy, dz derivatives of the state
+  static void LorenzDerivatives(const int32_t x, const int32_t y,
+                                const int32_t z, int32_t* const dx,
+                                int32_t* const dy, int32_t* const dz);
+
+  //! Q16.16 multiplication
+  static int32_t MultiplyQ16(const int32_t a, const int32_t b);
+
+  //! Q3.28 multiplication
+  static int32_t MultiplyQ28(const int32_t a, const int32_t b);
+
+  //! chaotic system that is iterated
+  ChaosMap map_;
+
+  //! logistic map state (Q0.32)
+  uint32_t logistic_x_;
+
+  //! logistic map parameter r = 3.99 (Q2.30)
+  static const uint32_t kLogisticR_ = 4284229878U;
+
+  //! logistic map restart value if the state collapsed to a fixed point
+  static const uint32_t kLogisticSeed_ = 0x5A5A5A5AU;
+
+  //! Lorenz state (Q16.16)
+  int32_t lorenz_x_;
+  int32_t lorenz_y_;
+  int32_t lorenz_z_;
+
+  //! Lorenz parameter sigma = 10 (integer)
+  static const int32_t kLorenzSigma_ = 10;
+
+  //! Lorenz parameter rho = 28 (Q16.16)
+  static const int32_t kLorenzRho_ = 28 << 16;
+
+  //! Lorenz parameter beta = 8/3 (Q16.16)
+  static const int32_t kLorenzBeta_ = 174763;
+
+  //! Lorenz step width dt = 2^-7 as right shift
+  static const uint32_t kLorenzDtShift_ = 7U;
+
+  //! Lorenz integration steps per Step() call
+  static const uint32_t kLorenzSubsteps_ = 4U;
+
+  //! Henon state (Q3.28)
+  int32_t henon_x_;
+  int32_t henon_y_;
+
+  //! Henon parameter a = 1.4 (Q3.28)
+  static const int32_t kHenonA_ = 375809638;
+
+  //! Henon parameter b = 0.3 (Q3.28)
+  static const int32_t kHenonB_ = 80530637;
+
+  //! Henon x magnitude that indicates an escape from the attractor (2.5),
+  //! the attractor stays within +-1.5 and x^2 up to 6.25 fits into Q3.28
+  static const int32_t kHenonLimit_ = 5 << 27;
+};
+
+}  // namespace tkrandom
+
+#endif  // CHAOS_GENERATOR_HPP_
@@ -0,0 +1,287 @@
+//! \brief     Class declarations for the stackless coroutine runtime.
+//! \details   C++20 coroutines with statically allocated frames and awaitables
+//!            for timer ticks, gate edges, DMA completion and RNG words.
+//! \file      coroutine.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef COROUTINE_HPP_
+#define COROUTINE_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <coroutine>
+#include <cstddef>
+
+#include "stm32l4xx_hal.h"
+#include "generator.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the events a coroutine can wait for
+enum class CoroutineEvent : uint8_t {
+  kGate1Opened,       //!< opening edge of IN_1
+  kGate2Opened,       //!< opening edge of IN_2
+  kTransferComplete,  //!< SPI DMA frame sent
+  kRandomWord,        //!< RNG data register holds a new word
+  kCount              //!< number of events, no valid event
+};
+
+//! enum type for CoroutineExecutor member function return values
+enum class CoroutineStatus {
+  kSuccess,  //!< successful execution
+  kIdle,     //!< no coroutine was ready
+  kError     //!< no free slot or frame
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! Coroutine class declaration
+//! \details return type of a coroutine function, owns the frame until the
+//!          coroutine is handed to CoroutineExecutor::Spawn(). Coroutines
+//!          start suspended. Frames come from a static pool of kFrameCount
+//!          frames of kFrameSize bytes, a larger frame or an exhausted pool
+//!          returns an empty Coroutine instead of using the heap.
+class Coroutine {
+ public:
+  //! promise type required by the compiler
+  struct promise_type {
+    //! executor slot of the coroutine, set by CoroutineExecutor::Spawn()
+    uint8_t slot = 0U;
+
+    Coroutine get_return_object(void) noexcept {
+      return Coroutine(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    static Coroutine get_return_object_on_allocation_failure(void) noexcept {
+      return Coroutine(nullptr);
+    }
+    std::suspend_always initial_suspend(void) noexcept { return {}; }
+    std::suspend_always final_suspend(void) noexcept { return {}; }
+    void return_void(void) noexcept {}
+    void unhandled_exception(void) noexcept {}
+
+    //! takes a frame of the static pool
+    //! \param[in] size frame size requested by the compiler
+    //! \return frame or nullptr if no frame is free or size is too large
+    static void* operator new(const std::size_t size) noexcept;
+
+    //! returns a frame to the static pool
+    //! \param[in] frame frame taken by operator new
+    static void operator delete(void* const frame) noexcept;
+  };
+
+  //! handle type of the coroutine frame
+  using Handle = std::coroutine_handle<promise_type>;
+
+  //! number of frames of the static pool
+  static const uint32_t kFrameCount = 4U;
+
+  //! bytes of one frame of the static pool
+  static const uint32_t kFrameSize = 256U;
+
+  //! constructor
+  //! \param[in] handle frame handle, nullptr if the allocation failed
+  constexpr explicit Coroutine(const Handle handle) : handle_(handle) {}
+
+  //! move constructor, the frame changes its owner
+  Coroutine(Coroutine&& other) noexcept : handle_(other.handle_) {
+    other.handle_ = nullptr;
+  }
+
+  //! destructor, destroys the frame unless it was spawned
+  ~Coroutine(void) {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  //! no copy constructor allowed since a frame has only one owner
+  Coroutine(const Coroutine&) = delete;
+
+  //! no assignment operator allowed since a frame has only one owner
+  Coroutine& operator=(Coroutine const&) = delete;
+
+  //! hands the frame over, e.g. to the executor
+  //! \return frame handle, nullptr if the allocation failed
+  Handle Release(void) {
+    const Handle handle = handle_;
+    handle_ = nullptr;
+    return handle;
+  }
+
+ private:
+  //! frame handle, nullptr if released or not allocated
+  Handle handle_;
+};
+
+//! CoroutineExecutor class declaration
+//! \details RunReady() is called by the main loop and resumes only coroutines
+//!          whose awaited event has fired, nothing is polled per coroutine.
+//!          Interrupts fire events by ProcessTick() and Signal(). Events are
+//!          not latched: a coroutine waits for the next event after it
+//!          suspended. The RNG has no interrupt, RunReady() checks its ready
+//!          flag once per pass while a coroutine waits for a word.
+class CoroutineExecutor {
+ public:
+  //! awaitable that suspends for a number of 1 kHz ticks
+  class SleepAwaiter {
+   public:
+    constexpr SleepAwaiter(CoroutineExecutor& executor, const uint32_t ticks)
+        : executor_(executor), ticks_(ticks) {}
+    bool await_ready(void) const noexcept { return ticks_ == 0U; }
+    void await_suspend(const Coroutine::Handle handle) noexcept {
+      executor_.RegisterSleep(handle.promise().slot, ticks_);
+    }
+    void await_resume(void) const noexcept {}
+
+   private:
+    CoroutineExecutor& executor_;
+    const uint32_t ticks_;
+  };
+
+  //! awaitable that suspends until an event fires
+  class EventAwaiter {
+   public:
+    constexpr EventAwaiter(CoroutineExecutor& executor,
+                           const CoroutineEvent event)
+        : executor_(executor), event_(event) {}
+    bool await_ready(void) const noexcept { return false; }
+    void await_suspend(const Coroutine::Handle handle) noexcept {
+      executor_.RegisterWait(handle.promise().slot, event_);
+    }
+    void await_resume(void) const noexcept {}
+
+   private:
+    CoroutineExecutor& executor_;
+    const CoroutineEvent event_;
+  };
+
+  //! awaitable that suspends until the RNG holds a word and reads it
+  class WordAwaiter {
+   public:
+    constexpr WordAwaiter(CoroutineExecutor& executor, uint32_t* const word)
+        : executor_(executor), word_(word) {}
+    bool await_ready(void) const noexcept {
+      return executor_.generator_.IsWordReady();
+    }
+    void await_suspend(const Coroutine::Handle handle) noexcept {
+      executor_.RegisterWait(handle.promise().slot,
+                             CoroutineEvent::kRandomWord);
+    }
+    GeneratorStatus await_resume(void) const noexcept {
+      return executor_.generator_.GetRandomWord(word_);
+    }
+
+   private:
+    CoroutineExecutor& executor_;
+    uint32_t* const word_;
+  };
+
+  //! constructor
+  //! \param[in] generator Generator reference for WaitForWord()
+  constexpr explicit CoroutineExecutor(const Generator& generator)
+      : generator_(generator),
+        handles_{},
+        deadlines_{},
+        waiting_{},
+        sleeping_(0U),
+        ready_(0U),
+        used_(0U),
+        tick_(0U) {}
+
+  //! destructor, returns the frames of the spawned coroutines to the pool
+  ~CoroutineExecutor(void);
+
+  //! no copy constructor allowed since there is only one instance
+  CoroutineExecutor(const CoroutineExecutor&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  CoroutineExecutor& operator=(CoroutineExecutor const&) = delete;
+
+  //! takes over a coroutine, it runs with the next RunReady()
+  //! \param[in] coroutine coroutine returned by a coroutine function
+  //! \return kError if the frame allocation failed or all slots are used
+  CoroutineStatus Spawn(Coroutine&& coroutine);
+
+  //! resumes the coroutines whose event has fired since the last call
+  //! \details thread mode only, finished coroutines release their frame
+  //! \return kIdle if no coroutine was ready
+  CoroutineStatus RunReady(void);
+
+  //! wakes the sleeping coroutines that are due, called by the 1 kHz timer
+  void ProcessTick(void);
+
+  //! fires an event, can be called from interrupt context
+  //! \param[in] event event that has occurred
+  void Signal(const CoroutineEvent event);
+
+  //! awaitable: co_await executor.Sleep(ms) suspends for ms ticks
+  //! \param[in] ticks 1 kHz ticks, 0 does not suspend
+  //! \return awaitable
+  SleepAwaiter Sleep(const uint32_t ticks) { return {*this, ticks}; }
+
+  //! awaitable: co_await executor.NextTick() suspends until the next tick
+  //! \return awaitable
+  SleepAwaiter NextTick(void) { return {*this, 1U}; }
+
+  //! awaitable: co_await executor.WaitFor(event) suspends until the event
+  //! \param[in] event awaited gate edge or DMA completion
+  //! \return awaitable
+  EventAwaiter WaitFor(const CoroutineEvent event) { return {*this, event}; }
+
+  //! awaitable: co_await executor.WaitForWord(&word) reads the next RNG word
+  //! \details the co_await expression yields the GeneratorStatus of the read
+  //! \param[out] word 32-bit random word
+  //! \return awaitable
+  WordAwaiter WaitForWord(uint32_t* const word) { return {*this, word}; }
+
+ private:
+  //! registers a suspended coroutine for the wake-up tick
+  //! \param[in] slot slot of the coroutine
+  //! \param[in] ticks ticks from now
+  void RegisterSleep(const uint8_t slot, const uint32_t ticks);
+
+  //! registers a suspended coroutine for an event
+  //! \param[in] slot slot of the coroutine
+  //! \param[in] event awaited event
+  void RegisterWait(const uint8_t slot, const CoroutineEvent event);
+
+  //! maximum number of spawned coroutines, one bit per slot in the masks
+  static const uint32_t kSlotCount_ = Coroutine::kFrameCount;
+
+  //! number of events
+  static const uint32_t kEventCount_ =
+      static_cast<uint32_t>(CoroutineEvent::kCount);
+
+  //! Generator reference for the RNG ready flag
+  const Generator& generator_;
+
+  //! frame handles per slot
+  Coroutine::Handle handles_[kSlotCount_];
+
+  //! wake-up tick per sleeping slot
+  uint32_t deadlines_[kSlotCount_];
+
+  //! bit mask of the waiting slots per event
+  volatile uint32_t waiting_[kEventCount_];
+
+  //! bit mask of the sleeping slots
+  volatile uint32_t sleeping_;
+
+  //! bit mask of the slots to resume with the next RunReady()
+  volatile uint32_t ready_;
+
+  //! bit mask of the used slots
+  uint32_t used_;
+
+  //! 1 kHz ticks since the start
+  volatile uint32_t tick_;
+};
+
+}  // namespace tkrandom
+
+#endif  // COROUTINE_HPP_
@@ -0,0 +1,135 @@
+//! \brief     Class declaration for the CV inputs of the random parameters.
+//! \details   Continuous ADC scan of the CV inputs by circular DMA with
+//!            hardware oversampling and fixed-point smoothing.
+//! \file      cv_inputs.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef CV_INPUTS_HPP_
+#define CV_INPUTS_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the parameters controlled by a CV input
+//! \details enum integer value equals the position in the ADC scan. 0 V and
+//!          an unpatched jack give the neutral value of every parameter, so
+//!          spread and probability fall with a rising CV, and the mean input
+//!          is bipolar with 0 V at half the ADC range.
+enum class CvParameter : uint8_t {
+  kSpread,       //!< PA0 (ADC1_IN5), range around the mean, 0 is constant
+  kMean,         //!< PA1 (ADC1_IN6), center of the output range
+  kProbability,  //!< PA2 (ADC1_IN7), chance that a gate sets a new value
+  kMorph,        //!< PA3 (ADC1_IN8), crossfade to the other distribution
+  kCount         //!< number of parameters, no valid parameter
+};
+
+//! enum type for CvInputs member function return values
+enum class CvInputsStatus {
+  kSuccess,  //!< successful execution
+  kError     //!< ADC calibration or enable timed out
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! CvInputs class declaration
+//! \details ADC1 converts the four CV inputs continuously with 16x hardware
+//!          oversampling, i.e. 16-bit values, and DMA1 channel 1 writes them
+//!          to a circular buffer without any interrupt. ProcessTick() smooths
+//!          the buffer by a one-pole low-pass in 24.8 fixed point and stores
+//!          16-bit parameters that the gate work reads by single loads, so
+//!          neither side waits for the other. Until Start() the parameters
+//!          keep their neutral values, which leave the outputs unchanged.
+//!          The ADC and DMA are driven by register access since the HAL ADC
+//!          module is not part of the project.
+class CvInputs {
+ public:
+  //! constructor
+  constexpr CvInputs(void)
+      : dma_buffer_{},
+        states_{kZeroVoltReadings_[0] << kFractionBits_,
+                kZeroVoltReadings_[1] << kFractionBits_,
+                kZeroVoltReadings_[2] << kFractionBits_,
+                kZeroVoltReadings_[3] << kFractionBits_},
+        parameters_{kNeutralSpread, kNeutralMean, kNeutralProbability,
+                    kNeutralMorph},
+        is_running_(false) {}
+
+  //! destructor
+  ~CvInputs(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  CvInputs(const CvInputs&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  CvInputs& operator=(CvInputs const&) = delete;
+
+  //! calibrates the ADC and starts the continuous scan
+  //! \details called once after MX_DMA_Init(), blocks for about 2 ms
+  //! \return kError if the ADC did not calibrate or enable in time
+  CvInputsStatus Start(void);
+
+  //! smooths the latest scan into the parameters, called by the 1 kHz timer
+  //! \details no-op until Start() succeeded
+  void ProcessTick(void);
+
+  //! getter for a smoothed parameter, lock-free on the gate path
+  //! \param[in] parameter requested parameter
+  //! \return parameter value (0 .. 2^16-1)
+  TKRANDOM_INLINE uint16_t GetParameter(const CvParameter parameter) const {
+    return parameters_[static_cast<uint32_t>(parameter)];
+  }
+
+  //! neutral spread at 0 V, the full output range
+  static const uint32_t kNeutralSpread = 0xFFFFU;
+
+  //! neutral mean at 0 V, the center of the output range
+  static const uint32_t kNeutralMean = 0x8000U;
+
+  //! neutral probability at 0 V, every gate sets a new value
+  static const uint32_t kNeutralProbability = 0xFFFFU;
+
+  //! neutral morph at 0 V, the distribution of the switch only
+  static const uint32_t kNeutralMorph = 0x0000U;
+
+ private:
+  //! number of CV inputs
+  static const uint32_t kInputCount_ =
+      static_cast<uint32_t>(CvParameter::kCount);
+
+  //! fraction bits of the smoothing states
+  static const uint32_t kFractionBits_ = 8U;
+
+  //! ADC readings at 0 V in scan order, mid-scale for the bipolar mean input
+  static constexpr uint32_t kZeroVoltReadings_[kInputCount_] = {
+      0x0000U, kNeutralMean, 0x0000U, 0x0000U};
+
+  //! smoothing shift, time constant of 2^4 ticks = 16 ms (10 Hz cutoff)
+  static const uint32_t kSmoothingShift_ = 4U;
+
+  //! ms until calibration and enable of the ADC are an error
+  static const uint32_t kTimeout_ = 10U;
+
+  //! latest oversampled scan, written by DMA
+  volatile uint16_t dma_buffer_[kInputCount_];
+
+  //! low-pass states of the ADC readings in 24.8 fixed point
+  uint32_t states_[kInputCount_];
+
+  //! smoothed parameters read by the gate work
+  volatile uint16_t parameters_[kInputCount_];
+
+  //! set to true after Start() succeeded
+  bool is_running_;
+};
+
+}  // namespace tkrandom
+
+#endif  // CV_INPUTS_HPP_
@@ -0,0 +1,48 @@
+//! \brief     Class declaration for measuring CPU cycles.
+//! \details   Uses the DWT cycle counter of the Cortex-M4 core.
+//! \file      cycle_counter.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef CYCLE_COUNTER_HPP_
+#define CYCLE_COUNTER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! CycleCounter class declaration
+//! \details static only since the core has exactly one DWT cycle counter
+class CycleCounter {
+ public:
+  //! no instances, all member functions are static
+  CycleCounter(void) = delete;
+
+  //! enables the trace unit and starts the DWT cycle counter
+  //! \details idempotent, may be called by every module that measures cycles
+  static void Enable(void);
+
+  //! getter for the current value of the free-running cycle counter
+  //! \return CPU cycles since Enable(), wraps around after 2^32 cycles
+  static TKRANDOM_INLINE uint32_t Now(void) {
+    return DWT->CYCCNT;
+  }
+
+  //! getter for the cycles elapsed since a previous Now() value
+  //! \param[in] start value returned by Now() at the start of the measurement
+  //! \return CPU cycles since start, correct across one wrap-around
+  static TKRANDOM_INLINE uint32_t Since(const uint32_t start) {
+    return DWT->CYCCNT - start;
+  }
+};
+
+}  // namespace tkrandom
+
+#endif  // CYCLE_COUNTER_HPP_
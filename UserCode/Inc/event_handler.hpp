@@ -12,31 +12,44 @@
 #define EVENT_HANDLER_HPP_
 
 // INCLUDES --------------------------------------------------------------------
-#include "pcb_status_led.hpp"
+#include "supervisor.hpp"
 #include "animation.hpp"
 #include "rng_handler.hpp"
+#include "noise_handler.hpp"
+#include "switch_debouncer.hpp"
+#include "scheduler.hpp"
+#include "interrupt_tiers.hpp"
+#include "latency_probes.hpp"
+#include "trace_log.hpp"
+#include "board.hpp"
+#include "cycle_counter.hpp"
+#include "ram_code.hpp"
 
 namespace tkrandom {
 
 // TYPE DECLARATIONS -----------------------------------------------------------
-//! struct with all pins required by EventHandler
-struct DistributionPins {
-  GPIO_TypeDef* gpio_port_distribution_1;  //!< GPIO port for distribution 1
-  uint16_t pin_distribution_1;             //!< pin number of distribution 1
-  GPIO_TypeDef* gpio_port_distribution_2;  //!< GPIO port for distribution 2
-  uint16_t pin_distribution_2;             //!< pin number of distribution 2
-  GPIO_TypeDef* gpio_port_distribution_3;  //!< GPIO port for distribution 3
-  uint16_t pin_distribution_3;             //!< pin number of distribution 3
-  GPIO_TypeDef* gpio_port_distribution_4;  //!< GPIO port for distribution 4
-  uint16_t pin_distribution_4;             //!< pin number of distribution 4
+enum class Event {
+  kTimerElapsed,         // 1 kHz timer tick
+  kGate1Triggered,       // EXTI line interrupt of IN_1, opening edge
+  kGate2Triggered,       // EXTI line interrupt of IN_2, opening edge
+  kGate1Released,        // EXTI line interrupt of IN_1, closing edge, a full
+                         // pulse if the opening edge was not seen
+  kGate2Released,        // EXTI line interrupt of IN_2, closing edge, a full
+                         // pulse if the opening edge was not seen
+  kTrackTick             // track timer tick
 };
 
-enum class Event {
-  kTimerElapsed,         // timer tick
-  kDistributionChanged,  // EXTI line interrupt of the distribution switches
-  kGate1Triggered,       // EXTI line interrupt of IN_1
-  kGate2Triggered,       // EXTI line interrupt of IN_2
-  kErrorOccurred         // an error occurred
+//! enum type for the behavior of the outputs of a gate input
+enum class HoldMode {
+  kSampleAndHold,  //!< one new value per opening edge of the gate
+  kTrackAndHold    //!< new values at track rate until the closing edge
+};
+
+//! counters of the opening edges of both gate inputs
+struct GateStatistics {
+  uint32_t captured;  //!< opening edges seen by the gate interrupts
+  uint32_t merged;    //!< opening edges captured before the previous one of
+                      //!< the same input was processed, no own output value
 };
 
 // CLASS DECLARATION -----------------------------------------------------------
@@ -44,15 +57,42 @@ enum class Event {
 class EventHandler {
  public:
   //! constructor
-  //! \param[in] pcb_status_led reference to control the PCB status LED
+  //! \param[in] supervisor Supervisor reference to report faults
   //! \param[in] rng_handler RngHandler reference to set output values
-  //! \param[in] animation Animation reference to trigger LED start animation
-  //! \param[in] distribution_pins struct with all required pins
-  EventHandler(PcbStatusLed& pcb_status_led, RngHandler& rng_handler,
-               Animation& animation, DistributionPins& distribution_pins);
+  //! \param[in] animation Animation reference to play the LED start animation
+  //! \param[in] noise_handler NoiseHandler reference to render noise samples
+  //! \param[in] switch_debouncer SwitchDebouncer of the distribution switches
+  //! \param[in] scheduler Scheduler reference to run the periodic tasks
+  //! \param[in] track_timer_handle timer handle with 1 MHz counter clock
+  constexpr EventHandler(Supervisor& supervisor,
+                         RngHandler& rng_handler,
+                         Animation& animation,
+                         NoiseHandler& noise_handler,
+                         SwitchDebouncer& switch_debouncer,
+                         Scheduler& scheduler,
+                         TIM_HandleTypeDef* const track_timer_handle)
+      : supervisor_(supervisor),
+        rng_handler_(rng_handler),
+        animation_(animation),
+        noise_handler_(noise_handler),
+        switch_debouncer_(switch_debouncer),
+        scheduler_(scheduler),
+        track_timer_handle_(track_timer_handle),
+        has_distribution_changed_(false),
+        is_gate_1_(false),
+        is_gate_2_(false),
+        is_gate_1_open_(false),
+        is_gate_2_open_(false),
+        has_track_tick_(false),
+        is_track_timer_running_(false),
+        hold_mode_1_(HoldMode::kSampleAndHold),
+        hold_mode_2_(HoldMode::kSampleAndHold),
+        gate_timestamp_(0U),
+        gate_path_cycles_(0U),
+        gate_statistics_{0U, 0U} {}
 
   //! destructor
-  ~EventHandler(void) {}
+  ~EventHandler(void) = default;
 
   //! no copy constructor allowed since there is only one instance
   EventHandler(const EventHandler&) = delete;
@@ -66,45 +106,83 @@ class EventHandler {
   void SignalEvent(const Event event);
 
   //! reiteratively called in main() to process signaled events
+  //! \details background work only, preempted by ProcessGates()
   void Run(void);
 
+  //! processes captured gate edges and track ticks
+  //! \details called by PendSV, which is pended by SignalEvent()
+  void ProcessGates(void);
+
   //! initializes dependencies: Transmitter instance
   void Init(void);
 
+  //! sets the hold mode of the outputs of both gate inputs
+  //! \param[in] gate_1_mode hold mode of outputs 1, 2, 3 (IN_1)
+  //! \param[in] gate_2_mode hold mode of output 4 (IN_2)
+  void SetHoldModes(const HoldMode gate_1_mode, const HoldMode gate_2_mode);
+
+  //! getter for the CPU cycles from the EXTI of the last gate to the end of
+  //! its PendSV gate work
+  //! \details includes the output and LED frames, compare with a
+  //!          TKRANDOM_FLASH_CODE build
+  //! \return CPU cycles of the last processed gate
+  uint32_t GetGatePathCycles(void) const;
+
+  //! getter for the counters of the opening edges
+  //! \return copy of the counters since the start or ResetGateStatistics()
+  GateStatistics GetGateStatistics(void) const;
+
+  //! clears the counters of the opening edges
+  void ResetGateStatistics(void);
+
+  //! sets the rate new values are written while tracking
+  //! \param[in] rate track rate in Hz, limited to 10 Hz .. 8 kHz
+  void SetTrackRate(const uint32_t rate);
+
  private:
-  //! enum type for the states of the internal event handling state machine
-  enum class EventHandlerState {
-    kAnimation,  //!< animation not completed yet
-    kWorking,    //!< normal working mode
-    kError       //!< an error occurred
-  };
-
-  //! reads state of distribution switches, calls Transmitter::SetDistribution()
+  //! applies the debounced distribution switches, calls SetDistribution()
   void ProcessDistribution(void);
 
-  //! switches mode of PCB status LED to kErrorMode
-  void HandleError(void);
+  //! streams new values to the outputs of tracking gates at track rate
+  //! \details starts the track timer while at least one gate is tracking
+  void ProcessTracking(void);
+
+  //! periodic task: advances the LED animation ahead of the LED refresh
+  //! \param[in] context pointer to the EventHandler instance
+  static void AnimationTask(void* const context);
 
-  //! state of the internal state machine for the event handling
-  EventHandlerState state_;
+  //! periodic task: steps the chaos generator and resets the RNG
+  //! \param[in] context pointer to the EventHandler instance
+  static void RngTickTask(void* const context);
 
-  //! reference to PcbStatusLed instance in order to control the PCB status LED
-  PcbStatusLed& pcbStatusLed_;
+  //! periodic task: sends the LED values of the gate work to the DAC
+  //! \param[in] context pointer to the EventHandler instance
+  static void LedRefreshTask(void* const context);
+
+  //! reports a fault to the Supervisor, which recovers it in the main loop
+  //! \param[in] fault fault that has occurred
+  void HandleError(const Fault fault);
+
+  //! Supervisor reference to report faults
+  Supervisor& supervisor_;
 
   //! RngBuffers reference to handle buffers with random numbers
   RngHandler& rng_handler_;
 
-  //! Animation reference to trigger and control LED start animation
+  //! Animation reference to play the LED start animation
   Animation& animation_;
 
-  //! struct with all pins required by EventHandler
-  DistributionPins& distribution_pins_;
+  //! NoiseHandler reference to render samples while noise is streamed
+  NoiseHandler& noise_handler_;
+
+  //! SwitchDebouncer reference, sampled by the 1 kHz timer tick
+  SwitchDebouncer& switch_debouncer_;
 
-  //! set to true if timer tick occurred
-  bool has_timer_elapsed_;
+  //! Scheduler reference, released by the 1 kHz timer tick
+  Scheduler& scheduler_;
 
-  //! set to true if an error occured somewhere
-  bool has_error_occurred_;
+  //! handle of the timer that clocks tracking
+  TIM_HandleTypeDef* const track_timer_handle_;
 
   //! set to true if one of the distribution was switched
   bool has_distribution_changed_;
@@ -115,11 +193,50 @@ class EventHandler {
   //! set to true if gate 2 was triggered (IN_2)
   bool is_gate_2_;
 
-  //! number of timer ticks already waiting to debounce distribution switches
-  uint32_t debounce_counter_;
+  //! true between opening and closing edge of gate 1 (IN_1)
+  bool is_gate_1_open_;
+
+  //! true between opening and closing edge of gate 2 (IN_2)
+  bool is_gate_2_open_;
+
+  //! set to true if track timer tick occurred
+  bool has_track_tick_;
+
+  //! true while the track timer is running
+  bool is_track_timer_running_;
+
+  //! hold mode of outputs 1, 2, 3 (IN_1)
+  HoldMode hold_mode_1_;
+
+  //! hold mode of output 4 (IN_2)
+  HoldMode hold_mode_2_;
+
+  //! counter clock of the track timer in Hz
+  static const uint32_t kTrackTimerClock_ = 1000000U;
+
+  //! lowest track rate in Hz
+  static const uint32_t kMinTrackRate_ = 10U;
+
+  //! highest track rate in Hz, limited by the DAC frames per track tick
+  static const uint32_t kMaxTrackRate_ = 8000U;
+
+  //! cycle counter value of the last gate interrupt
+  volatile uint32_t gate_timestamp_;
+
+  //! CPU cycles of the last processed gate, see GetGatePathCycles()
+  uint32_t gate_path_cycles_;
+
+  //! counters of the opening edges, written by the gate interrupts
+  GateStatistics gate_statistics_;
+
+  //! cycle budget of AnimationTask(), interpolation of the four LEDs
+  static const uint32_t kAnimationBudget_ = 960U;
+
+  //! cycle budget of RngTickTask()
+  static const uint32_t kRngTickBudget_ = 2400U;
 
-  //! number of timer ticks that is waited to debounce distribution switches
-  const uint32_t kDebounceDelay_;
+  //! cycle budget of LedRefreshTask(), four queued DAC frames
+  static const uint32_t kLedRefreshBudget_ = 1200U;
 };
 
 }  // namespace tkrandom
@@ -0,0 +1,136 @@
+//! \brief     Class declaration for replaying gate scenarios on the target.
+//! \details   Signals the edges of the reference GateScenario traces to the
+//!            EventHandler and collects gate counters and DWT latencies.
+//! \file      gate_replay.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef GATE_REPLAY_HPP_
+#define GATE_REPLAY_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "event_handler.hpp"
+#include "gate_scenario.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! result of one replayed scenario
+struct GateReplayResult {
+  uint32_t injected;             //!< signaled opening edges
+  GateStatistics gates;          //!< counters of the EventHandler
+  LatencyStatistics gate_path;   //!< kGatePath cycles, needs
+                                 //!< TKRANDOM_LATENCY_PROBES
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! GateReplay class declaration
+//! \details bench build only (TKRANDOM_GATE_BENCH in main.c): edges are
+//!          signaled from the main loop like the gate interrupts do, so the
+//!          inputs stay unconnected. The results are read by the debugger.
+class GateReplay {
+ public:
+  //! constructor
+  //! \param[in] event_handler EventHandler the edges are signaled to
+  constexpr explicit GateReplay(EventHandler& event_handler)
+      : event_handler_(event_handler),
+        scenario_(),
+        edge_{0U, 0U, false},
+        has_edge_(false),
+        scenario_index_(kGateScenarioCount),
+        rate_(0U),
+        gate_count_(0U),
+        core_clock_(0U),
+        last_cycles_(0U),
+        now_(0U),
+        origin_(0U),
+        end_(0U),
+        results_{} {}
+
+  //! destructor
+  ~GateReplay(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  GateReplay(const GateReplay&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  GateReplay& operator=(GateReplay const&) = delete;
+
+  //! replays all reference scenarios one after another
+  //! \details the first scenario starts 100 ms after the call, when the
+  //!          distribution switches have been debounced
+  //! \param[in] rate gate rate in Hz
+  //! \param[in] gate_count gates per input and scenario
+  //! \param[in] core_clock HCLK in Hz
+  void Start(const uint32_t rate, const uint32_t gate_count,
+             const uint32_t core_clock);
+
+  //! signals the due edges, reiteratively called in main()
+  void Process(void);
+
+  //! getter for the replay state
+  //! \return true until the last scenario has been evaluated
+  bool IsRunning(void) const;
+
+  //! getter for the result of a scenario
+  //! \param[in] scenario index in kGateScenarios
+  //! \return result, complete once the scenario has ended
+  const GateReplayResult& GetResult(const uint32_t scenario) const;
+
+ private:
+  //! starts the scenario scenario_index_ at the current time
+  void StartScenario(void);
+
+  //! extends the cycle counter to 64 bits
+  void UpdateTime(void);
+
+  //! signals an edge like HAL_GPIO_EXTI_Callback() in main.c
+  void Signal(const GateEdge& edge);
+
+  //! EventHandler the edges are signaled to
+  EventHandler& event_handler_;
+
+  //! trace of the running scenario
+  GateScenario scenario_;
+
+  //! next edge of the running scenario
+  GateEdge edge_;
+
+  //! true if edge_ is valid
+  bool has_edge_;
+
+  //! index of the running scenario, kGateScenarioCount if idle
+  uint32_t scenario_index_;
+
+  //! gate rate in Hz
+  uint32_t rate_;
+
+  //! gates per input and scenario
+  uint32_t gate_count_;
+
+  //! HCLK in Hz
+  uint32_t core_clock_;
+
+  //! cycle counter value at the last UpdateTime()
+  uint32_t last_cycles_;
+
+  //! 64-bit cycle counter
+  uint64_t now_;
+
+  //! start of the running scenario
+  uint64_t origin_;
+
+  //! evaluation time of the running scenario, relative to origin_
+  uint64_t end_;
+
+  //! results per scenario
+  GateReplayResult results_[kGateScenarioCount];
+};
+
+}  // namespace tkrandom
+
+#endif  // GATE_REPLAY_HPP_
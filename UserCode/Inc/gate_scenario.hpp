@@ -0,0 +1,132 @@
+//! \brief     Class declaration for synthetic gate traces.
+//! \details   Deterministic edge sequences of steady, burst, jittered and
+//!            dual-input clocks, shared by the host benchmark and GateReplay.
+//! \file      gate_scenario.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef GATE_SCENARIO_HPP_
+#define GATE_SCENARIO_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include <cstdint>
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the gate patterns
+enum class GatePattern : uint8_t {
+  kSteady,  //!< IN_1 clocked at rate
+  kBurst,   //!< IN_1 bursts of burst_length gates at rate, then a pause
+  kJitter,  //!< IN_1 at rate, opening edges delayed by up to jitter
+  kDual,    //!< IN_1 and IN_2 at rate, IN_2 delayed by phase
+  kShort    //!< IN_1 at rate, pulses of kShortPulseCycles, duty is ignored
+};
+
+//! length of the kShort pulses in core cycles, shorter than the interrupt
+//! entry, so the EXTI handler reads the closed level only
+static const uint32_t kShortPulseCycles = 8U;
+
+//! parameters of a gate trace, percentages refer to the period 1 / rate
+struct GateScenarioConfig {
+  GatePattern pattern;    //!< gate pattern
+  uint32_t rate;          //!< gate rate in Hz
+  uint32_t gate_count;    //!< gates per input
+  uint8_t duty;           //!< gate length in percent, 1 .. 99
+  uint8_t jitter;         //!< kJitter: largest delay in percent
+  uint8_t phase;          //!< kDual: delay of IN_2 in percent, 0 at once
+  uint16_t burst_length;  //!< kBurst: gates per burst
+  uint16_t burst_pause;   //!< kBurst: periods without gates after a burst
+};
+
+//! one edge of a gate trace
+struct GateEdge {
+  uint64_t cycle;  //!< core cycles since the start of the trace
+  uint8_t input;   //!< gate input 1 (IN_1) or 2 (IN_2)
+  bool is_open;    //!< true for the opening edge
+};
+
+//! reference scenarios, the rate is set by the benchmark
+static const uint32_t kGateScenarioCount = 5U;
+static const GateScenarioConfig kGateScenarios[kGateScenarioCount] = {
+    {GatePattern::kSteady, 0U, 0U, 50U, 0U, 0U, 0U, 0U},
+    {GatePattern::kBurst, 0U, 0U, 50U, 0U, 0U, 8U, 8U},
+    {GatePattern::kJitter, 0U, 0U, 25U, 50U, 0U, 0U, 0U},
+    {GatePattern::kDual, 0U, 0U, 50U, 0U, 0U, 0U, 0U},
+    {GatePattern::kShort, 0U, 0U, 50U, 0U, 0U, 0U, 0U}};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! GateScenario class declaration
+//! \details generates the edges in time order without any memory but a few
+//!          members, jitter comes from a fixed-seed xorshift generator so that
+//!          host and target replay the very same trace
+class GateScenario {
+ public:
+  //! constructor, empty trace until Init()
+  constexpr GateScenario(void)
+      : config_{GatePattern::kSteady, 0U, 0U, 50U, 0U, 0U, 0U, 0U},
+        period_(0U),
+        gate_(0U),
+        pending_{},
+        pending_count_(0U),
+        pending_index_(0U),
+        random_state_(kSeed_) {}
+
+  //! destructor
+  ~GateScenario(void) = default;
+
+  //! starts a trace
+  //! \details duty, jitter and phase are limited so that no gate reaches
+  //!          into the next period
+  //! \param[in] config parameters of the trace
+  //! \param[in] core_clock core clock in Hz, the unit of GateEdge::cycle
+  void Init(const GateScenarioConfig& config, const uint32_t core_clock);
+
+  //! getter for the next edge
+  //! \param[out] edge next edge in time order
+  //! \return false after the last edge
+  bool Next(GateEdge* const edge);
+
+  //! getter for the number of opening edges of the whole trace
+  //! \return opening edges of both inputs
+  uint32_t GetGateCount(void) const;
+
+ private:
+  //! generates the edges of the next gate period
+  void GenerateSlot(void);
+
+  //! seed of the jitter generator
+  static const uint32_t kSeed_ = 0x9E3779B9U;
+
+  //! most edges per period: both edges of both inputs
+  static const uint32_t kSlotEdges_ = 4U;
+
+  //! parameters of the trace
+  GateScenarioConfig config_;
+
+  //! gate period in core cycles
+  uint64_t period_;
+
+  //! index of the next gate per input
+  uint32_t gate_;
+
+  //! edges of the current period, sorted
+  GateEdge pending_[kSlotEdges_];
+
+  //! number of edges in pending_
+  uint32_t pending_count_;
+
+  //! next edge in pending_
+  uint32_t pending_index_;
+
+  //! xorshift32 state
+  uint32_t random_state_;
+};
+
+}  // namespace tkrandom
+
+#endif  // GATE_SCENARIO_HPP_
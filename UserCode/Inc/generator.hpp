@@ -12,11 +12,21 @@
 #define GENERATOR_HPP_
 
 // INCLUDES --------------------------------------------------------------------
+#include <cstddef>
 #include "stm32l4xx_hal.h"
+#include "interrupt_tiers.hpp"
+#include "trace_log.hpp"
+#include "ram_code.hpp"
 
 namespace tkrandom {
 
 // TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the output voltage distribution
+enum class Distribution {
+  kUniform,  //!< uniform distribution
+  kNormal    //!< normal distribution
+};
+
 //! enum type for Generator member function return values
 enum class GeneratorStatus {
   kSuccess = 0U,  //!< successful execution
@@ -29,10 +39,11 @@ class Generator {
  public:
   //! constructor
   //! \param[in] random_handle pointer to RNG instance of HAL RNG driver
-  Generator(RNG_HandleTypeDef* const random_handle);
+  constexpr explicit Generator(RNG_HandleTypeDef* const random_handle)
+      : random_handle_(random_handle), seed_(0U), key_(0U), counter_(0U) {}
 
   //! deconstructor
-  ~Generator(void) {}
+  ~Generator(void) = default;
 
   //! no copy constructor allowed since there is only one instance
   Generator(const Generator&) = delete;
@@ -50,12 +61,84 @@ class Generator {
     //! \return kSuccess if no error occurred
   GeneratorStatus GetNormalRandomNumber(uint16_t* number) const;
 
+  //! Getter for a raw 32-bit random word of the STM32 RNG
+  //! \param[out] word 32-bit random word and 0U if an error occurred
+  //! \return kSuccess if no error occurred
+  GeneratorStatus GetRandomWord(uint32_t* word) const;
+
+  //! getter for the ready flag of the random word source
+  //! \return true if GetRandomWord() returns without waiting for the RNG
+  bool IsWordReady(void) const;
+
+  //! fills a whole block with 16-bit random numbers of the given distribution
+  //! \details reads the RNG data register directly and builds two samples per
+  //!          instruction with the Cortex-M4 SIMD instructions if available
+  //!          and takes a plain pointer, as std::span is not inlined at -O0
+  //! \param[out] samples block that is filled, 0U for samples after an error
+  //! \param[in] count number of samples of the block
+  //! \param[in] distribution distribution of the random numbers
+  //! \return kSuccess if no error occurred
+  GeneratorStatus Fill(uint16_t* const samples, const size_t count,
+                       const Distribution distribution) const;
+
   //! Reinitializes STM32 RNG in order to fully recover from a seed error
   void ResetRng(void);
 
+  //! selects the source of the random words
+  //! \details seed 0 selects the STM32 RNG, any other seed a counter-based
+  //!          SplitMix64 sequence that starts over with the same words after
+  //!          every call, e.g. to repeat a recording. Must not be called while
+  //!          the gate work or the noise output draws random numbers.
+  //! \param[in] seed seed of the deterministic sequence, 0 for the STM32 RNG
+  void SetSeed(const uint16_t seed);
+
+  //! getter for the deterministic mode
+  //! \return seed of the deterministic sequence, 0 if the STM32 RNG is used
+  uint16_t GetSeed(void) const;
+
  private:
+  //! getter for the next random word of the selected source
+  //! \details HAL_RNG_GenerateRandomNumber() for the STM32 RNG
+  //! \param[out] word 32-bit random word and 0U if an error occurred
+  //! \return kSuccess if no error occurred
+  GeneratorStatus GenerateWord(uint32_t* word) const;
+
+  //! getter for the next word of the deterministic sequence
+  //! \return SplitMix64 output of the key and the next counter value
+  uint32_t NextSeededWord(void) const;
+
+  //! reads one 32-bit random word of the selected source
+  //! \details the next word of the deterministic sequence if a seed is set,
+  //!          otherwise the RNG data register as a lightweight replacement of
+  //!          HAL_RNG_GenerateRandomNumber() for bulk generation, without
+  //!          locking, state handling and SysTick
+  //! \param[out] word 32-bit random word and 0U if an error occurred
+  //! \return kSuccess if no error occurred
+  GeneratorStatus ReadWord(uint32_t* word) const;
+
   //! pointer to RNG instance of HAL RNG driver
   RNG_HandleTypeDef* const random_handle_;
+
+  //! seed of the deterministic sequence, 0 if the STM32 RNG is used
+  uint16_t seed_;
+
+  //! key of the deterministic sequence, derived from seed_
+  uint64_t key_;
+
+  //! index of the next word of the deterministic sequence
+  //! \details mutable like the data register of the STM32 RNG it replaces
+  mutable uint64_t counter_;
+
+  //! increment of the SplitMix64 state per counter value
+  static const uint64_t kGoldenGamma_ = 0x9E3779B97F4A7C15U;
+
+  //! number of status register polls until a missing random word is an error
+  //! \details a new word is ready every 42 RNG clock cycles. The RNG runs on
+  //!          MSI, so in the standard and low-clock profiles a word takes 42
+  //!          HCLK cycles (0.9 us at 48 MHz, 10.5 us at 4 MHz) and in the
+  //!          turbo profile 70. The limit counts polls of several cycles
+  //!          each and holds in every profile.
+  static const uint32_t kReadyTimeout_ = 1000U;
 };
 
 }  // namespace tkrandom
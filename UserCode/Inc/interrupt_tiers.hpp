@@ -0,0 +1,75 @@
+//! \brief     Declaration of the NVIC priority tiers.
+//! \details   Gate capture has the highest priority, the gate-to-DAC work runs
+//!            in PendSV below all interrupts and above the main loop.
+//! \file      interrupt_tiers.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef INTERRUPT_TIERS_HPP_
+#define INTERRUPT_TIERS_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! InterruptTiers class declaration
+//! \details preemption priorities with NVIC_PRIORITYGROUP_4, the numbers are
+//!          used by the CubeMX generated code in random.ioc and have to be
+//!          kept in sync
+class InterruptTiers {
+ public:
+  //! no instances, all members are static
+  InterruptTiers(void) = delete;
+
+  //! gate EXTI lines, capture timestamp and flags, pend the gate work
+  static const uint32_t kGateCapture = 0U;
+
+  //! noise sample timer, one DAC frame per sample
+  static const uint32_t kAudio = 1U;
+
+  //! SPI DMA completion, chains the queued DAC frames
+  static const uint32_t kTransfer = 2U;
+
+  //! SysTick, HAL_GetTick() timeouts must advance inside the gate work
+  static const uint32_t kSysTick = 3U;
+
+  //! 1 kHz tick and track timer, release periodic work
+  static const uint32_t kTimer = 4U;
+
+  //! flash programming of the settings journal
+  static const uint32_t kFlash = 5U;
+
+  //! PendSV, gate-to-DAC work, preempts the main loop only
+  static const uint32_t kGateWork = 15U;
+
+  //! requests the gate work, runs as soon as no interrupt is active
+  static TKRANDOM_INLINE void PendGateWork(void) {
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+  }
+
+  //! masks the gate work, e.g. while thread mode sends a DAC frame
+  //! \details nests, higher tiers stay enabled
+  //! \return previous mask for UnmaskGateWork()
+  static TKRANDOM_INLINE uint32_t MaskGateWork(void) {
+    const uint32_t basepri = __get_BASEPRI();
+    __set_BASEPRI_MAX(kGateWork << (8U - __NVIC_PRIO_BITS));
+    return basepri;
+  }
+
+  //! restores the mask returned by MaskGateWork()
+  //! \param[in] basepri previous mask
+  static TKRANDOM_INLINE void UnmaskGateWork(const uint32_t basepri) {
+    __set_BASEPRI(basepri);
+  }
+};
+
+}  // namespace tkrandom
+
+#endif  // INTERRUPT_TIERS_HPP_
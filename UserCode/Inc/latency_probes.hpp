@@ -0,0 +1,119 @@
+//! \brief     Class declaration for the gate-to-output latency probes.
+//! \details   Optional DWT cycle counter probes with min/max/mean and log2
+//!            histograms per stage of the gate path.
+//! \file      latency_probes.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef LATENCY_PROBES_HPP_
+#define LATENCY_PROBES_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "cycle_counter.hpp"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the measured stages, all relative to the gate interrupt
+enum class LatencyStage : uint8_t {
+  kDispatch,  //!< gate work entered in PendSV
+  kFrame,     //!< each blocking DAC frame completed
+  kRefill,    //!< random buffers refilled
+  kGatePath,  //!< gate work completed, outputs and LEDs written
+  kCount      //!< number of stages, no valid stage
+};
+
+//! statistics of one stage in CPU cycles
+struct LatencyStatistics {
+  uint32_t min;            //!< shortest latency, 0xFFFFFFFF if count is 0
+  uint32_t max;            //!< longest latency
+  uint32_t count;          //!< number of samples
+  uint64_t sum;            //!< sum of all samples, mean = sum / count
+  uint32_t histogram[33];  //!< bucket n counts latencies of 2^(n-1) .. 2^n-1
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! LatencyProbes class declaration
+//! \details static only, the statistics are kept in one RAM structure that a
+//!          debugger can read, see statistics_. Probes are compiled in with
+//!          TKRANDOM_LATENCY_PROBES only, see the TKRANDOM_PROBE_x macros.
+class LatencyProbes {
+ public:
+  //! no instances, all members are static
+  LatencyProbes(void) = delete;
+
+  //! stamps the gate interrupt and arms the stage probes
+  static TKRANDOM_INLINE void Start(void) {
+    start_ = CycleCounter::Now();
+    is_armed_ = true;
+  }
+
+  //! adds the cycles since Start() to the statistics of a stage
+  //! \details ignored while disarmed, e.g. for frames of the LED animation
+  //! \param[in] stage measured stage
+  static TKRANDOM_INLINE void Record(const LatencyStage stage) {
+    if (is_armed_) {
+      const uint32_t cycles = CycleCounter::Since(start_);
+      LatencyStatistics& statistics =
+          statistics_[static_cast<uint32_t>(stage)];
+      statistics.min = (cycles < statistics.min) ? cycles : statistics.min;
+      statistics.max = (cycles > statistics.max) ? cycles : statistics.max;
+      statistics.count++;
+      statistics.sum += cycles;
+      statistics.histogram[32U - __CLZ(cycles)]++;
+    }
+  }
+
+  //! records the last stage and disarms the probes until the next gate
+  static TKRANDOM_INLINE void Stop(void) {
+    Record(LatencyStage::kGatePath);
+    is_armed_ = false;
+  }
+
+  //! clears the statistics of all stages
+  static void Reset(void);
+
+  //! getter for a copy of the statistics of a stage
+  //! \param[in] stage measured stage
+  //! \param[out] statistics copy of the statistics
+  static void GetStatistics(const LatencyStage stage,
+                            LatencyStatistics* const statistics);
+
+ private:
+  //! number of stages
+  static const uint32_t kStageCount_ =
+      static_cast<uint32_t>(LatencyStage::kCount);
+
+  //! cycle counter value of the last gate interrupt
+  static volatile uint32_t start_;
+
+  //! true between Start() and Stop()
+  static volatile bool is_armed_;
+
+  //! statistics per stage
+  static LatencyStatistics statistics_[kStageCount_];
+};
+
+}  // namespace tkrandom
+
+// MACROS ----------------------------------------------------------------------
+//! probes of the gate path, a few cycles each if TKRANDOM_LATENCY_PROBES is
+//! defined and no code at all otherwise
+#if defined(TKRANDOM_LATENCY_PROBES)
+#define TKRANDOM_PROBE_START() tkrandom::LatencyProbes::Start()
+#define TKRANDOM_PROBE(stage) \
+  tkrandom::LatencyProbes::Record(tkrandom::LatencyStage::stage)
+#define TKRANDOM_PROBE_STOP() tkrandom::LatencyProbes::Stop()
+#else
+#define TKRANDOM_PROBE_START()
+#define TKRANDOM_PROBE(stage)
+#define TKRANDOM_PROBE_STOP()
+#endif
+
+#endif  // LATENCY_PROBES_HPP_
@@ -0,0 +1,116 @@
+//! \brief     Class declaration for the rate-limited front panel LED refresh.
+//! \details   Keeps the LED brightness as shadow state that the gate work
+//!            writes and a periodic task sends to the DAC.
+//! \file      led_refresher.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef LED_REFRESHER_HPP_
+#define LED_REFRESHER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "transmitter.hpp"
+#include "interrupt_tiers.hpp"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! LedRefresher class declaration
+//! \details SetBrightness() only stores the value, so the gate work sends the
+//!          output frames alone. ProcessTick() runs at the refresh rate in
+//!          thread mode and queues one DMA frame per LED whose displayed value
+//!          changed, faster LED changes are invisible anyway. With decay, the
+//!          displayed value jumps to every new value and fades out, so that
+//!          short gates stay visible. An overlay, e.g. of the Animation, hides
+//!          the values of the gate work until it is released.
+class LedRefresher {
+ public:
+  //! constructor
+  //! \param[in] transmitter Transmitter reference for the DMA frames
+  constexpr explicit LedRefresher(Transmitter& transmitter)
+      : transmitter_(transmitter),
+        shadow_{},
+        displayed_{},
+        sent_{},
+        overlay_{},
+        updated_leds_(0U),
+        decay_shift_(0U),
+        is_overlay_active_(false) {}
+
+  //! destructor
+  ~LedRefresher(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  LedRefresher(const LedRefresher&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  LedRefresher& operator=(LedRefresher const&) = delete;
+
+  //! sets the brightness of a front panel LED for the next refresh
+  //! \details called by the gate work, must not be preempted by itself
+  //! \param[in] led LED whose brightness is set
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  void SetBrightness(const Led led, const uint16_t value);
+
+  //! sends the changed LED values to the DAC, called at the refresh rate
+  //! \details frames rejected by a full queue are sent with the next refresh
+  void ProcessTick(void);
+
+  //! sets the fade-out of the LEDs
+  //! \param[in] shift 0 holds the value, otherwise the displayed value loses
+  //!            1/2^shift per refresh, e.g. 3 fades out in about 250 ms at
+  //!            100 Hz
+  void SetDecay(const uint8_t shift);
+
+  //! shows an overlay value instead of the values of the gate work
+  //! \details thread mode only, like ProcessTick()
+  //! \param[in] led LED whose overlay brightness is set
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  void SetOverlay(const Led led, const uint16_t value);
+
+  //! removes the overlay, the LEDs show the latest values of the gate work
+  void ReleaseOverlay(void);
+
+  //! refresh rate in Hz the task of ProcessTick() is registered with
+  static const uint32_t kRefreshRate = 100U;
+
+ private:
+  //! number of front panel LEDs
+  static const uint32_t kLedCount_ = 4U;
+
+  //! highest decay shift, slower fades are not visible
+  static const uint8_t kMaxDecayShift_ = 8U;
+
+  //! Transmitter reference for the DMA frames
+  Transmitter& transmitter_;
+
+  //! latest brightness per LED set by the gate work
+  volatile uint16_t shadow_[kLedCount_];
+
+  //! brightness per LED after the decay of the last refresh
+  uint16_t displayed_[kLedCount_];
+
+  //! brightness per LED of the last queued frame
+  uint16_t sent_[kLedCount_];
+
+  //! brightness per LED while the overlay is active
+  uint16_t overlay_[kLedCount_];
+
+  //! bit mask of the LEDs set since the last refresh, bit 0 is LED 1
+  volatile uint8_t updated_leds_;
+
+  //! fade-out per refresh, 0 holds the value
+  uint8_t decay_shift_;
+
+  //! true while overlay_ is shown
+  bool is_overlay_active_;
+};
+
+}  // namespace tkrandom
+
+#endif  // LED_REFRESHER_HPP_
@@ -0,0 +1,137 @@
+//! \brief     Class declaration for the microbenchmarks of the hot functions.
+//! \details   Calls each hot function of the gate path N times with the
+//!            interrupts masked and reports the clock ticks per call as JSON.
+//! \file      micro_bench.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef MICRO_BENCH_HPP_
+#define MICRO_BENCH_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "rng_handler.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the measured functions
+enum class BenchFunction : uint8_t {
+  kSetLedBrightness,       //!< Transmitter::SetLedBrightness(), LED 1
+  kTransmitValue,          //!< Transmitter::TransmitValue(), output 1
+  kGetNormalRandomNumber,  //!< Generator::GetNormalRandomNumber()
+  kFillBuffers,            //!< RngHandler::FillBuffers(), both buffers empty
+  kRefreshLeds,            //!< LedRefresher::ProcessTick(), all LEDs changed
+  kCount                   //!< number of functions, no valid function
+};
+
+//! ticks per call of one function
+struct BenchResult {
+  uint32_t calls;  //!< number of measured calls
+  uint32_t min;    //!< fastest call, 0xFFFFFFFF if calls is 0
+  uint32_t max;    //!< slowest call
+  uint64_t sum;    //!< sum of all calls, mean = sum / calls
+};
+
+//! free-running clock of the measurement
+//! \return ticks, wraps around after 2^32 ticks
+using BenchClock = uint32_t (*)(void);
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! MicroBench class declaration
+//! \details Run() must be called in thread mode with the DMA queue of the
+//!          Transmitter idle, e.g. ahead of EventHandler::Init(). The clock is
+//!          CycleCounter::Now() on the target, the overhead of reading it is
+//!          subtracted from every call. Friend of Transmitter and RngHandler
+//!          to reach their private hot paths.
+class MicroBench {
+ public:
+  //! constructor
+  //! \param[in] transmitter Transmitter under test
+  //! \param[in] generator Generator under test
+  //! \param[in] rng_handler RngHandler under test
+  //! \param[in] clock clock of the measurement
+  //! \param[in] clock_rate ticks per second of clock
+  constexpr MicroBench(Transmitter& transmitter, Generator& generator,
+                       RngHandler& rng_handler, const BenchClock clock,
+                       const uint32_t clock_rate)
+      : transmitter_(transmitter),
+        generator_(generator),
+        rng_handler_(rng_handler),
+        clock_(clock),
+        clock_rate_(clock_rate),
+        overhead_(0U),
+        results_{} {}
+
+  //! destructor
+  ~MicroBench(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  MicroBench(const MicroBench&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  MicroBench& operator=(MicroBench const&) = delete;
+
+  //! measures all functions
+  //! \details restores the buffers of the RngHandler, writes arbitrary values
+  //!          to output 1 and LED 1
+  //! \param[in] iterations calls per function
+  void Run(const uint32_t iterations);
+
+  //! getter for the result of a function
+  //! \param[in] function measured function
+  //! \return ticks per call
+  const BenchResult& GetResult(const BenchFunction function) const;
+
+  //! getter for the name of a function
+  //! \param[in] function measured function
+  //! \return qualified name, e.g. "Transmitter::TransmitValue"
+  static const char* GetName(const BenchFunction function);
+
+  //! writes the results as one JSON object
+  //! \details {"clock_hz":..,"overhead":..,"results":[{"function":..,
+  //!          "calls":..,"min":..,"mean":..,"max":..},..]}, ticks per call
+  //! \param[out] text buffer, always zero-terminated
+  //! \param[in] size size of text
+  //! \return length of the JSON text, size or more if truncated
+  uint32_t WriteJson(char* const text, const uint32_t size) const;
+
+ private:
+  //! number of functions
+  static const uint32_t kFunctionCount_ =
+      static_cast<uint32_t>(BenchFunction::kCount);
+
+  //! measures one call of a function
+  //! \param[in] function function to call
+  //! \param[in] iteration index of the call, varies the arguments
+  //! \return ticks of the call including the clock overhead
+  uint32_t Measure(const BenchFunction function, const uint32_t iteration);
+
+  //! Transmitter under test
+  Transmitter& transmitter_;
+
+  //! Generator under test
+  Generator& generator_;
+
+  //! RngHandler under test
+  RngHandler& rng_handler_;
+
+  //! clock of the measurement
+  const BenchClock clock_;
+
+  //! ticks per second of clock_
+  const uint32_t clock_rate_;
+
+  //! ticks between two back-to-back clock reads
+  uint32_t overhead_;
+
+  //! results per function
+  BenchResult results_[kFunctionCount_];
+};
+
+}  // namespace tkrandom
+
+#endif  // MICRO_BENCH_HPP_
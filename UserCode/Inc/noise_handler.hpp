@@ -0,0 +1,178 @@
+//! \brief     Class declaration for audio-rate noise streaming.
+//! \details   Streams white, pink or brown noise to one front panel output.
+//! \file      noise_handler.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef NOISE_HANDLER_HPP_
+#define NOISE_HANDLER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "transmitter.hpp"
+#include "generator.hpp"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the spectral color of the streamed noise
+enum class NoiseColor {
+  kWhite,  //!< flat spectrum, taken directly from the RNG
+  kPink,   //!< -3 dB/octave, Voss-McCartney multi-rate sum
+  kBrown   //!< -6 dB/octave, leaky integrator
+};
+
+//! enum type for NoiseHandler member function return values
+enum class NoiseHandlerStatus {
+  kSuccess,  //!< successful execution
+  kErrorRng  //!< error with random number generation
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! NoiseHandler class declaration
+//! \details samples are rendered ahead in thread mode by FillSamples() and sent
+//!          one per sample timer interrupt by ProcessSampleTick()
+class NoiseHandler {
+ public:
+  //! constructor
+  //! \param[in] generator Generator reference for random words
+  //! \param[in] transmitter Transmitter reference for DMA transfers to DAC
+  //! \param[in] timer_handle pointer to the HAL handle of the sample timer
+  constexpr NoiseHandler(Generator& generator, Transmitter& transmitter,
+                         TIM_HandleTypeDef* const timer_handle)
+      : generator_(generator),
+        transmitter_(transmitter),
+        timer_handle_(timer_handle),
+        output_(Output::kOutput4),
+        color_(NoiseColor::kWhite),
+        is_streaming_(false),
+        ring_{},
+        write_index_(0U),
+        read_index_(0U),
+        last_sample_(0x8000U),
+        underrun_count_(0U),
+        pink_rows_{},
+        pink_sum_(0),
+        pink_counter_(0U),
+        brown_state_(0) {}
+
+  //! destructor
+  ~NoiseHandler(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  NoiseHandler(const NoiseHandler&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  NoiseHandler& operator=(NoiseHandler const&) = delete;
+
+  //! starts streaming noise to the given output
+  //! \details the output is no longer written by gate events while streamed
+  //! \param[in] output output the noise is streamed to
+  //! \param[in] color spectral color of the noise
+  void Start(const Output output, const NoiseColor color);
+
+  //! stops streaming and hands the output back to gate events
+  void Stop(void);
+
+  //! getter for the streaming state
+  //! \return true if noise is currently streamed
+  bool IsStreaming(void) const;
+
+  //! renders noise samples until the sample ring is full
+  //! \details reiteratively called in thread mode
+  //! \return kSuccess if no error occurred
+  NoiseHandlerStatus FillSamples(void);
+
+  //! sends the next sample to the DAC, called by the sample timer interrupt
+  void ProcessSampleTick(void);
+
+ private:
+  //! filters one white noise sample according to color_
+  //! \param[in] white signed white noise sample
+  //! \return signed filtered noise sample
+  int32_t RenderSample(const int32_t white);
+
+  //! Voss-McCartney pink noise: rows updated at octave-spaced rates
+  //! \param[in] white signed white noise sample
+  //! \return signed pink noise sample
+  int32_t RenderPink(const int32_t white);
+
+  //! brown noise: leaky integration of white noise
+  //! \param[in] white signed white noise sample
+  //! \return signed brown noise sample
+  int32_t RenderBrown(const int32_t white);
+
+  //! resets the filter states of pink and brown noise
+  void ResetFilters(void);
+
+  //! Generator reference for random words
+  Generator& generator_;
+
+  //! Transmitter reference for DMA transfers to DAC
+  Transmitter& transmitter_;
+
+  //! pointer to the HAL handle of the sample timer
+  TIM_HandleTypeDef* const timer_handle_;
+
+  //! output the noise is streamed to
+  Output output_;
+
+  //! spectral color of the streamed noise
+  NoiseColor color_;
+
+  //! set to true while noise is streamed
+  volatile bool is_streaming_;
+
+  //! size of the sample ring (power of two, 128 samples = 2.7 ms at 48 kHz)
+  static const uint32_t kRingSize_ = 128U;
+
+  //! rendered samples waiting to be sent (DAC values)
+  uint16_t ring_[kRingSize_];
+
+  //! free-running write index of ring_[], only written by FillSamples()
+  volatile uint32_t write_index_;
+
+  //! free-running read index of ring_[], only written by ProcessSampleTick()
+  volatile uint32_t read_index_;
+
+  //! last sample sent, repeated on ring underrun
+  uint16_t last_sample_;
+
+  //! number of sample ticks without a rendered sample
+  volatile uint32_t underrun_count_;
+
+  //! number of pink noise rows (octaves below the sample rate)
+  static const uint32_t kPinkRows_ = 8U;
+
+  //! right shift applied to white noise before it is summed as pink row
+  static const uint32_t kPinkRowShift_ = 3U;
+
+  //! current values of the pink noise rows
+  int32_t pink_rows_[kPinkRows_];
+
+  //! running sum of pink_rows_[]
+  int32_t pink_sum_;
+
+  //! sample counter selecting the pink noise row to update
+  uint32_t pink_counter_;
+
+  //! leak of the brown noise integrator as right shift (1/64)
+  static const uint32_t kBrownLeakShift_ = 6U;
+
+  //! right shift applied to white noise before it is integrated
+  static const uint32_t kBrownInputShift_ = 4U;
+
+  //! fractional bits of the brown noise integrator state
+  static const uint32_t kBrownFractionBits_ = 8U;
+
+  //! brown noise integrator state (Q23.8)
+  int32_t brown_state_;
+};
+
+}  // namespace tkrandom
+
+#endif  // NOISE_HANDLER_HPP_
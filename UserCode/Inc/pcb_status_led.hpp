@@ -13,6 +13,9 @@
 
 // INCLUDES --------------------------------------------------------------------
 #include "stm32l4xx_hal.h"
+#include "board.hpp"
+#include "trace_log.hpp"
+#include "coroutine.hpp"
 
 namespace tkrandom {
 
@@ -29,12 +32,15 @@ enum class PcbStatusLedMode {
 class PcbStatusLed {
  public:
   //! constructor
-  //! \param[in] gpio_port_led pionter to GPIO port for PCB LED
-  //! \param[in] pin_led pin number of PCB LED
-  PcbStatusLed(GPIO_TypeDef* const gpio_port_led, const uint16_t pin_led);
+  //! \details the LED pin is taken from board.hpp
+  constexpr PcbStatusLed(void)
+      : mode_(PcbStatusLedMode::kNormalMode),
+        kErrorTime_(375U),
+        kNormalTimeOff_(3000U),
+        kNormalTimeOn_(125U) {}
 
   //! deconstructor
-  ~PcbStatusLed(void) {}
+  ~PcbStatusLed(void) = default;
 
   //! no copy constructor allowed since there is only one instance
   PcbStatusLed(const PcbStatusLed&) = delete;
@@ -46,31 +52,24 @@ class PcbStatusLed {
   //! /param[in] mode PCB status LED operation mode that is switched to
   void SetLedMode(const PcbStatusLedMode mode);
 
-  //! uses timer interrupt to switch internal state machine
-  void ProcessTick(void);
+  //! blinks the PCB LED according to the operation mode
+  //! \details coroutine, spawned once by CoroutineExecutor::Spawn()
+  //! \param[in] executor executor that resumes the coroutine
+  //! \return coroutine, empty if no frame was available
+  Coroutine Run(CoroutineExecutor& executor);
 
  private:
-  //! current state of the internal state machine
-  PcbStatusLedMode mode_;
+  //! current operation mode
+  volatile PcbStatusLedMode mode_;
 
-  //! incremented and processed by ProcessTick()
-  uint32_t tick_counter_;
+  //! ms between two toggles in error mode
+  const uint32_t kErrorTime_;
 
-  //! number of processed ticks when PCB LED is toggled in error mode
-  const uint32_t kErrorCount_;
-
-  //! number of processed ticks when PCB LED is switched on in normal mode
-  const uint32_t kNormalCountOn_;
-
-  //! number of processed ticks when PCB LED is switched off in normal mode
-  const uint32_t kNormalCountOff_;
-
-  //! pionter to GPIO port for PCB LED
-  GPIO_TypeDef* const gpio_port_led_;
-
-  //! pin_dac pin number of DAC PCB LED
-  const uint16_t kPinLed_;
+  //! ms the PCB LED is switched off in normal mode
+  const uint32_t kNormalTimeOff_;
 
+  //! ms the PCB LED is switched on in normal mode
+  const uint32_t kNormalTimeOn_;
 };
 
 }  // namespace tkrandom
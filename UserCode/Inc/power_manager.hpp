@@ -0,0 +1,136 @@
+//! \brief     Class declaration for switching the system clock at runtime.
+//! \details   Selects between the 80 MHz PLL turbo profile, the 48 MHz MSI
+//!            standard profile and a 4 MHz low-clock profile.
+//! \file      power_manager.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef POWER_MANAGER_HPP_
+#define POWER_MANAGER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "transmitter.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the selectable performance profiles
+enum class PerformanceProfile {
+  kStandard,  //!< 48 MHz MSI, voltage scale 1, as configured at startup
+  kTurbo,     //!< 80 MHz PLL from MSI, voltage scale 1, for audio-rate modes
+  kLowClock   //!< 4 MHz MSI, voltage scale 2, for plain sample-and-hold use,
+              //!< run mode, the low-power run mode is not entered, too slow
+              //!< for the noise output
+};
+
+//! enum type for PowerManager member function return values
+enum class PowerManagerStatus {
+  kSuccess,  //!< successful execution
+  kError     //!< error while reconfiguring regulator or clock tree
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! PowerManager class declaration
+//! \details the RNG keeps its MSI kernel clock in every profile, SPI and timer
+//!          dividers are recomputed from HCLK after each switch so that tick
+//!          rates and the SPI clock stay unchanged
+class PowerManager {
+ public:
+  //! constructor
+  //! \param[in] transmitter Transmitter reference to adapt the SPI clock
+  //! \param[in] tick_timer_handle HAL handle of the 1 kHz state machine timer
+  //! \param[in] sample_timer_handle HAL handle of the 48 kHz noise timer
+  //! \param[in] track_timer_handle HAL handle of the 1 MHz track timer
+  constexpr PowerManager(Transmitter& transmitter,
+                         TIM_HandleTypeDef* const tick_timer_handle,
+                         TIM_HandleTypeDef* const sample_timer_handle,
+                         TIM_HandleTypeDef* const track_timer_handle)
+      : transmitter_(transmitter),
+        tick_timer_handle_(tick_timer_handle),
+        sample_timer_handle_(sample_timer_handle),
+        track_timer_handle_(track_timer_handle),
+        profile_(PerformanceProfile::kStandard),
+        kMaxSpiClock_(24000000U),
+        kTickRate_(1000U),
+        kTickPeriod_(1000U),
+        kSampleRate_(48000U),
+        kTrackTimerClock_(1000000U) {}
+
+  //! destructor
+  ~PowerManager(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  PowerManager(const PowerManager&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  PowerManager& operator=(PowerManager const&) = delete;
+
+  //! switches the system clock to another performance profile
+  //! \details must be called from thread mode, the SPI clock is lowered before
+  //!          HCLK rises so that the DAC limit is never exceeded
+  //! \param[in] profile performance profile that is switched to
+  //! \return returns kSuccess if no error occurs
+  PowerManagerStatus SetProfile(const PerformanceProfile profile);
+
+  //! getter for the active performance profile
+  //! \return active performance profile
+  PerformanceProfile GetProfile(void) const;
+
+ private:
+  //! reconfigures regulator, oscillators and bus clocks
+  //! \param[in] profile performance profile that is switched to
+  //! \return returns kSuccess if no error occurs
+  PowerManagerStatus ConfigureClocks(const PerformanceProfile profile);
+
+  //! recomputes the prescalers of the tick, sample and track timers
+  //! \param[in] hclk current AHB clock frequency in Hz
+  void RetuneTimers(const uint32_t hclk);
+
+  //! getter for the HCLK frequency of a performance profile
+  //! \param[in] profile performance profile
+  //! \return HCLK frequency in Hz
+  uint32_t GetProfileClock(const PerformanceProfile profile) const;
+
+  //! smallest SPI divider that keeps the SPI clock within the DAC limit
+  //! \param[in] pclk SPI1 bus clock frequency in Hz
+  //! \return SPI_BAUDRATEPRESCALER_x value of the HAL SPI driver
+  uint32_t GetSpiPrescaler(const uint32_t pclk) const;
+
+  //! transmitter to adapt the SPI clock
+  Transmitter& transmitter_;
+
+  //! HAL handle of the state machine tick timer
+  TIM_HandleTypeDef* const tick_timer_handle_;
+
+  //! HAL handle of the noise sample timer
+  TIM_HandleTypeDef* const sample_timer_handle_;
+
+  //! HAL handle of the track timer
+  TIM_HandleTypeDef* const track_timer_handle_;
+
+  //! active performance profile
+  PerformanceProfile profile_;
+
+  //! highest SPI clock frequency in Hz accepted by the DAC
+  const uint32_t kMaxSpiClock_;
+
+  //! rate of the state machine tick timer in Hz
+  const uint32_t kTickRate_;
+
+  //! auto-reload period of the state machine tick timer
+  const uint32_t kTickPeriod_;
+
+  //! rate of the noise sample timer in Hz
+  const uint32_t kSampleRate_;
+
+  //! counter clock frequency of the track timer in Hz
+  const uint32_t kTrackTimerClock_;
+};
+
+}  // namespace tkrandom
+#endif  // POWER_MANAGER_HPP_
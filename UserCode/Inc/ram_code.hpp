@@ -0,0 +1,28 @@
+//! \brief     Attribute for placing time-critical functions in SRAM2.
+//! \details   Functions are copied to RAM2 by the startup code and run there
+//!            without flash wait states, see STM32L412K8TX_FLASH.ld.
+//! \file      ram_code.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef RAM_CODE_HPP_
+#define RAM_CODE_HPP_
+
+// MACROS ----------------------------------------------------------------------
+//! places a function in section .ram2_text, define TKRANDOM_FLASH_CODE to keep
+//! all code in flash, e.g. to compare the cycles of the gate path
+#if defined(TKRANDOM_FLASH_CODE)
+#define TKRANDOM_RAM_CODE
+#else
+#define TKRANDOM_RAM_CODE __attribute__((section(".ram2_text")))
+#endif
+
+//! inlines a header helper at every optimization level, RAM2 code would
+//! otherwise call an out-of-line copy in .text in the -O0 Debug build
+#define TKRANDOM_INLINE inline __attribute__((always_inline))
+
+#endif  // RAM_CODE_HPP_
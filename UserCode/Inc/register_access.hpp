@@ -0,0 +1,45 @@
+//! \brief     Narrow access to 32-bit peripheral registers.
+//! \details   The access width of some registers has a meaning, e.g. the SPI
+//!            data register takes one FIFO byte per 8-bit and two per 16-bit
+//!            access with data packing.
+//! \file      register_access.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef REGISTER_ACCESS_HPP_
+#define REGISTER_ACCESS_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// FUNCTIONS -------------------------------------------------------------------
+//! writes the lowest bytes of a register with an access of their width
+//! \details the host simulation overloads it for its register proxies
+//! \tparam T access width, uint8_t or uint16_t
+//! \param[in] reg register, e.g. SPI1->DR
+//! \param[in] value value to be written
+template <typename T>
+TKRANDOM_INLINE void WriteRegister(volatile uint32_t& reg, const T value) {
+  *reinterpret_cast<volatile T*>(&reg) = value;
+}
+
+//! reads the lowest bytes of a register with an access of their width
+//! \details the host simulation overloads it for its register proxies
+//! \tparam T access width, uint8_t or uint16_t
+//! \param[in] reg register, e.g. SPI1->DR
+//! \return value read
+template <typename T>
+TKRANDOM_INLINE T ReadRegister(volatile uint32_t& reg) {
+  return *reinterpret_cast<volatile T*>(&reg);
+}
+
+}  // namespace tkrandom
+
+#endif  // REGISTER_ACCESS_HPP_
@@ -14,14 +14,27 @@
 // INCLUDES --------------------------------------------------------------------
 #include "transmitter.hpp"
 #include "generator.hpp"
+#include "chaos_generator.hpp"
+#include "cv_inputs.hpp"
+#include "led_refresher.hpp"
+#include "latency_probes.hpp"
+#include "ram_code.hpp"
 
 namespace tkrandom {
 
 // TYPE DECLARATIONS -----------------------------------------------------------
-//! enum type for the output voltage distribution
-enum class Distribution {
-  kUniform,  //!< uniform distribution
-  kNormal    //!< normal distribution
+//! enum type for the source of the random voltage of an output
+enum class Source {
+  kRng,       //!< STM32 RNG with the distribution set by SetDistribution()
+  kLogistic,  //!< logistic map of the output's ChaosGenerator
+  kLorenz,    //!< Lorenz attractor of the output's ChaosGenerator
+  kHenon      //!< Henon map of the output's ChaosGenerator
+};
+
+//! enum type for the clock that iterates the chaotic sources
+enum class ChaosClock {
+  kGate,     //!< one step per gate of the output
+  kInternal  //!< one step per timer tick (ProcessTick())
 };
 
 //! enum type for Calculator member function return values
@@ -38,10 +51,30 @@ class RngHandler {
   //! constructor
   //! \param[in] generator Generator reference for generation of random numbers
   //! \param[in] transmitter Transmitter reference for SPI transfers to DAC
-  RngHandler(Generator& generator, Transmitter& transmitter);
+  //! \param[in] led_refresher LedRefresher reference for the LED values
+  //! \param[in] cv_inputs CvInputs reference for the random parameters
+  constexpr RngHandler(Generator& generator, Transmitter& transmitter,
+                       LedRefresher& led_refresher, const CvInputs& cv_inputs)
+      : generator_(generator),
+        transmitter_(transmitter),
+        led_refresher_(led_refresher),
+        cv_inputs_(cv_inputs),
+        distribution_1_(Distribution::kUniform),
+        distribution_2_(Distribution::kUniform),
+        distribution_3_(Distribution::kUniform),
+        distribution_4_(Distribution::kUniform),
+        index_uniform_(0U),
+        index_normal_(0U),
+        index_draw_(0U),
+        buffer_uniform_{},
+        buffer_normal_{},
+        buffer_draw_{},
+        sources_{Source::kRng, Source::kRng, Source::kRng, Source::kRng},
+        chaos_clock_(ChaosClock::kGate),
+        is_chaos_perturbed_(false) {}
 
   //! destructor
-  ~RngHandler(void) {}
+  ~RngHandler(void) = default;
 
   //! no copy constructor allowed since there is only one instance
   RngHandler(const RngHandler&) = delete;
@@ -53,63 +86,121 @@ class RngHandler {
   void Init(void);
 
   //! sets random voltage for front panel outputs and LEDs 1, 2, 3 and/or 4
+  //! \details the LEDs show the output values with the next RefreshLeds()
   //! \param[in] is_gate_1 outputs and LEDs 1, 2, 3 are set if true
   //! \param[in] is_gate_2 outputs and LEDs 4 are set if true
   //! \return kSuccess if no error occurred
   RngHandlerStatus SetOutputsLeds(const bool is_gate_1, const bool is_gate_2);
 
+  //! streams fresh random values to the outputs and LEDs of open gates
+  //! \details non-blocking counterpart of SetOutputsLeds() for track-and-hold,
+  //!          output frames are queued for DMA, a full queue drops them since
+  //!          the next track tick writes fresh values anyway
+  //! \param[in] is_gate_1 outputs and LEDs 1, 2, 3 are tracked if true
+  //! \param[in] is_gate_2 outputs and LEDs 4 are tracked if true
+  //! \return kSuccess if no error occurred
+  RngHandlerStatus TrackOutputsLeds(const bool is_gate_1, const bool is_gate_2);
+
   //! sets distribution of the random voltage for the given output
   //! \param[in] output output the distribution is set for
   //! \param[in] distribution distribution that is set for output
   void SetDistribution(const Output output, const Distribution distribution);
 
+  //! sets the source of the random voltage for the given output
+  //! \details chaotic sources are used instead of the distribution
+  //! \param[in] output output the source is set for
+  //! \param[in] source source that is set for output
+  void SetSource(const Output output, const Source source);
+
+  //! sets the clock that iterates the chaotic sources
+  //! \param[in] clock clock that is set for all chaotic sources
+  void SetChaosClock(const ChaosClock clock);
+
+  //! enables a small RNG perturbation of the chaotic sources
+  //! \param[in] is_enabled perturbation is added to every step if true
+  void SetChaosPerturbation(const bool is_enabled);
+
+  //! sends the changed LED values to the DAC
+  //! \details called by a periodic task at LedRefresher::kRefreshRate
+  void RefreshLeds(void);
+
+  //! sets the fade-out of the LEDs, see LedRefresher::SetDecay()
+  //! \param[in] shift 0 holds the LED value until the next gate
+  void SetLedDecay(const uint8_t shift);
+
   //! uses timer interrupt to reset STM32 RNG periodically
   //! \details periodical reset since RNG seed error detection is switched off
   void ProcessTick();
 
  private:
+  //! measures the private hot paths, see micro_bench.hpp
+  friend class MicroBench;
+
   //! fills up random buffers with new random numbers
   //! \return kSuccess if no error occurred
   RngHandlerStatus FillBuffers(void);
 
-  //! sets random voltages for front panel outputs 1, 2, 3
+  //! sets random voltages for front panel outputs 1, 2, 3 and their LEDs
   //! \return kSuccess if no error occurred
   TransmitterStatus SetOutputs123(void);
 
-  //! sets random values for front panel LEDs 1, 2, 3
-  //! \return kSuccess if no error occurred
-  TransmitterStatus SetLeds123(void);
-
-  //! sets random voltage for front panel output 4
+  //! sets random voltage for front panel output 4 and its LED
   //! \return kSuccess if no error occurred
   TransmitterStatus SetOutput4(void);
 
-  //! sets random value for front panel LED 4
-  //! \return kSuccess if no error occurred
-  TransmitterStatus SetLed4(void);
+  //! queues random voltages for the outputs from first to last
+  //! \param[in] first first output that is queued
+  //! \param[in] last last output that is queued
+  void QueueOutputsLeds(const Output first, const Output last);
 
-  //! resets buffer index to previous value in order to set LED values
-  //! \details modifies buffer index of buffer_uniform and/or buffer_normal
-  //! \param[in] is_gate_1 adds 3 to buffer index if true
-  //! \param[in] is_gate_2 adds 1 to buffer index if true
-  void RollbackBufferIndexes(const bool is_gate_1, const bool is_gate_2);
+  //! getter for the LED that shows an output
+  //! \param[in] output front panel output
+  //! \return LED of the output
+  static Led GetLed(const Output output);
 
   //! getter for the distribution of the random voltage for the given output
   //! \param[in] output output whose distribution is requested
   //! \return distribution of the random voltage of the given output
   Distribution GetDistribution(const Output output) const;
 
+  //! iterates the chaotic sources of the outputs of the given gates
+  //! \param[in] is_gate_1 chaotic sources of outputs 1, 2, 3 are iterated
+  //! \param[in] is_gate_2 chaotic source of output 4 is iterated
+  void StepChaos(const bool is_gate_1, const bool is_gate_2);
+
+  //! iterates the chaotic source of one output, perturbed if enabled
+  //! \param[in] output output whose chaotic source is iterated
+  void StepChaos(const Output output);
+
   //! returns one random number depending on distribution for given output
+  //! \details modulated by morph, spread and mean of the CV inputs
   //! \param[in] output output the random number is used for
   //! \return one random number from buffer_uniform_[] or buffer_normal_[]
   uint16_t GetRandomNumber(const Output output);
 
-  //! TODO
+  //! takes one random number from the buffer of a distribution
+  //! \param[in] distribution distribution of the random number
+  //! \return one random number from buffer_uniform_[] or buffer_normal_[]
+  uint16_t TakeNumber(const Distribution distribution);
+
+  //! draws whether a gate sets a new value, see CvParameter::kProbability
+  //! \details takes the draw from buffer_draw_[], an empty buffer right after
+  //!          the probability has left full scale sets a new value
+  //! \return true if the output takes a new value, false if it holds
+  bool IsValueDrawn(void);
+
+  //! Generator reference for generation of random numbers
   Generator& generator_;
 
   //! Transmitter reference for SPI transfers to DAC
   Transmitter& transmitter_;
 
+  //! LedRefresher reference, shadow state and refresh of the LEDs
+  LedRefresher& led_refresher_;
+
+  //! CvInputs reference, parameters read lock-free on the gate path
+  const CvInputs& cv_inputs_;
+
   //! random voltage distribution of output 1
   Distribution distribution_1_;
 
@@ -128,6 +219,9 @@ class RngHandler {
   //! current number of random values in buffer with normal distribution
   uint32_t index_normal_;
 
+  //! current number of random values in buffer for the probability draws
+  uint32_t index_draw_;
+
   //! size of buffer with random numbers
   static const uint32_t kBufferSize_ = 4U;
 
@@ -136,6 +230,30 @@ class RngHandler {
 
   //! buffer with generated random numbers
   uint16_t buffer_normal_[kBufferSize_];
+
+  //! buffer with uniform random numbers for the probability draws
+  uint16_t buffer_draw_[kBufferSize_];
+
+  //! number of front panel outputs
+  static const uint32_t kOutputCount_ = 4U;
+
+  //! source of the random voltage of each output
+  Source sources_[kOutputCount_];
+
+  //! chaotic generator of each output
+  ChaosGenerator chaos_[kOutputCount_];
+
+  //! clock that iterates the chaotic sources
+  ChaosClock chaos_clock_;
+
+  //! set to true if the chaotic sources are perturbed by the RNG
+  bool is_chaos_perturbed_;
+
+  //! right shift of a signed 16-bit random number used as perturbation
+  static const uint32_t kPerturbationShift_ = 12U;
+
+  //! probability from which every gate sets a new value, ADC full scale
+  static const uint16_t kAlwaysDrawn_ = 0xFFF0U;
 };
 
 }  // namespace tkrandom
@@ -0,0 +1,120 @@
+//! \brief     Class declaration for the cooperative periodic task scheduler.
+//! \details   Runs registered tasks at their own rate and priority and keeps
+//!            cycle and deadline statistics per task.
+//! \file      scheduler.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef SCHEDULER_HPP_
+#define SCHEDULER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "cycle_counter.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! function type of a periodic task
+//! \param[in] context pointer given to Scheduler::AddTask()
+using TaskFunction = void (*)(void* context);
+
+//! enum type for Scheduler member function return values
+enum class SchedulerStatus {
+  kSuccess,  //!< successful execution
+  kIdle,     //!< no task was due
+  kError     //!< task table full, invalid rate or invalid task id
+};
+
+//! statistics of one periodic task
+struct TaskStatistics {
+  uint32_t last_cycles;       //!< CPU cycles of the last execution
+  uint32_t max_cycles;        //!< highest CPU cycles of all executions
+  uint32_t budget_overruns;   //!< executions that exceeded the cycle budget
+  uint32_t deadline_misses;   //!< releases while the task was still pending
+  uint32_t executions;        //!< number of executions
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! Scheduler class declaration
+//! \details ProcessTick() is called by the 1 kHz timer interrupt and releases
+//!          every task whose phase accumulator overflows, so rates need not
+//!          divide the tick rate. RunNext() runs at most one pending task, the
+//!          one with the highest priority, so the caller can handle gates
+//!          between two tasks. The deadline of a task is its next release.
+class Scheduler {
+ public:
+  //! constructor
+  constexpr Scheduler(void)
+      : tasks_{},
+        task_count_(0U),
+        kTickRate_(1000U) {}
+
+  //! destructor
+  ~Scheduler(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  Scheduler(const Scheduler&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  Scheduler& operator=(Scheduler const&) = delete;
+
+  //! registers a periodic task, called before the timer is started
+  //! \param[in] function task function
+  //! \param[in] context pointer passed to the task function
+  //! \param[in] rate release rate in Hz, 1 .. tick rate
+  //! \param[in] priority 0 is the highest priority
+  //! \param[in] budget CPU cycles one execution should not exceed
+  //! \param[out] task_id id for GetStatistics(), may be nullptr
+  //! \return returns kSuccess if the task has been registered
+  SchedulerStatus AddTask(const TaskFunction function, void* const context,
+                          const uint32_t rate, const uint8_t priority,
+                          const uint32_t budget,
+                          uint32_t* const task_id = nullptr);
+
+  //! releases due tasks, called by the 1 kHz timer interrupt
+  void ProcessTick(void);
+
+  //! runs the pending task with the highest priority
+  //! \return returns kIdle if no task was pending
+  SchedulerStatus RunNext(void);
+
+  //! getter for the statistics of a task
+  //! \param[in] task_id id returned by AddTask()
+  //! \param[out] statistics copy of the task statistics
+  //! \return returns kError for an invalid task id
+  SchedulerStatus GetStatistics(const uint32_t task_id,
+                                TaskStatistics* const statistics) const;
+
+ private:
+  //! entry of the task table
+  struct Task {
+    TaskFunction function;         //!< task function
+    void* context;                 //!< pointer passed to the task function
+    uint32_t rate;                 //!< release rate in Hz
+    uint32_t phase;                //!< phase accumulator, 0 .. tick rate
+    uint32_t budget;               //!< cycle budget of one execution
+    uint8_t priority;              //!< 0 is the highest priority
+    volatile bool is_pending;      //!< released and not executed yet
+    TaskStatistics statistics;     //!< cycle and deadline statistics
+  };
+
+  //! maximum number of tasks
+  static const uint32_t kMaxTasks_ = 8U;
+
+  //! task table, filled by AddTask()
+  Task tasks_[kMaxTasks_];
+
+  //! number of registered tasks
+  uint32_t task_count_;
+
+  //! rate of ProcessTick() calls in Hz
+  const uint32_t kTickRate_;
+};
+
+}  // namespace tkrandom
+#endif  // SCHEDULER_HPP_
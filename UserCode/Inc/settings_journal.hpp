@@ -0,0 +1,253 @@
+//! \brief     Class declaration for the wear-leveled flash settings journal.
+//! \details   Append-only key/value records in the last two flash pages.
+//! \file      settings_journal.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef SETTINGS_JOURNAL_HPP_
+#define SETTINGS_JOURNAL_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the keys of the persistent settings
+enum class SettingKey : uint8_t {
+  kHoldMode1,           //!< HoldMode of gate input 1
+  kHoldMode2,           //!< HoldMode of gate input 2
+  kTrackRate,           //!< track rate in Hz
+  kPerformanceProfile,  //!< PerformanceProfile of the power manager
+  kRandomSeed,          //!< seed of the deterministic mode, 0 for the STM32 RNG
+  kLedDecay,            //!< fade-out shift of the LEDs, 0 holds the value
+  kNoiseOutput,         //!< output streaming noise 1 .. 4, 0 for none
+  kNoiseColor,          //!< NoiseColor of the streamed noise
+  kChaosSources,        //!< Source per output, 2 bits each, output 1 lowest
+  kChaosClock,          //!< ChaosClock of the chaotic sources
+  kChaosPerturbation,   //!< RNG perturbation of the chaotic sources, 0 or 1
+  kCount                //!< number of keys, no valid key
+};
+
+//! enum type for SettingsJournal member function return values
+enum class SettingsJournalStatus {
+  kSuccess,   //!< successful execution
+  kNotFound,  //!< no record of the key in the journal
+  kError      //!< invalid key or flash programming failed
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! SettingsJournal class declaration
+//! \details Each page starts with a header double word (magic, generation)
+//!          followed by 64-bit records (tag, key, value, CRC). New values are
+//!          appended to the active page, a full page is compacted into the
+//!          other one whose header is programmed last, so an interrupted
+//!          compaction leaves the previous page active. Records with a bad CRC
+//!          or an ECC error stem from a torn write and are skipped.
+//!          A failed append skips its double word and keeps the key dirty, a
+//!          failed compaction restarts with the erase. After kMaxRetries_
+//!          failed operations in a row programming stops until the next
+//!          Write().
+//!          Programming is started from Process() and finished by the flash
+//!          interrupt, it stalls flash fetches only, the gate path runs from
+//!          RAM2.
+class SettingsJournal {
+ public:
+  //! constructor
+  constexpr SettingsJournal(void)
+      : values_{},
+        is_valid_{},
+        is_dirty_{},
+        active_page_(kNoPage_),
+        generation_(0U),
+        write_offset_(0U),
+        compaction_page_(kNoPage_),
+        compaction_offset_(0U),
+        compaction_key_(0U),
+        program_key_(0U),
+        program_value_(0U),
+        error_count_(0U),
+        operation_(Operation::kNone),
+        is_busy_(false),
+        has_error_(false) {}
+
+  //! destructor
+  ~SettingsJournal(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  SettingsJournal(const SettingsJournal&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  SettingsJournal& operator=(SettingsJournal const&) = delete;
+
+  //! loads all settings with a single scan of both journal pages
+  void Init(void);
+
+  //! getter for a stored setting
+  //! \param[in] key key of the setting
+  //! \param[out] value stored value, untouched if kNotFound is returned
+  //! \return returns kSuccess if the key has a stored value
+  SettingsJournalStatus Read(const SettingKey key, uint16_t* const value) const;
+
+  //! stores a setting, the flash record is written later by Process()
+  //! \param[in] key key of the setting
+  //! \param[in] value value to be stored
+  //! \return returns kError if the key is invalid
+  SettingsJournalStatus Write(const SettingKey key, const uint16_t value);
+
+  //! starts the next flash operation if the previous one has finished
+  //! \details called cyclically from the main loop, never blocks
+  //! \return returns kError once kMaxRetries_ flash operations in a row have
+  //!         failed, until the next Write()
+  SettingsJournalStatus Process(void);
+
+  //! called by HAL_FLASH_EndOfOperationCallback()
+  void ProcessOperationComplete(void);
+
+  //! called by HAL_FLASH_OperationErrorCallback()
+  void ProcessOperationError(void);
+
+  //! called by NMI_Handler() for a double ECC error
+  //! \details clears ECCD, which would raise the NMI again, and latches the
+  //!          error for ReadDoubleWord() if it is inside the journal pages
+  //! \return true if the error is inside the journal pages, the interrupted
+  //!         read may resume
+  static bool HandleEccError(void);
+
+ private:
+  //! enum type for the flash operation in progress
+  enum class Operation {
+    kNone,         //!< no operation in progress
+    kAppend,       //!< record appended to the active page
+    kErase,        //!< compaction page erased
+    kCopy,         //!< record copied to the compaction page
+    kHeader        //!< header of the compaction page programmed
+  };
+
+  //! scans one page and takes over all valid records
+  //! \param[in] page journal page index
+  void ScanPage(const uint32_t page);
+
+  //! starts the next flash operation of the compaction
+  //! \details erases the compaction page first, then copies the records and
+  //!          programs the page header if all records have been copied
+  void ContinueCompaction(void);
+
+  //! clears the dirty flag of the programmed key if its value is unchanged
+  void ClearDirty(void);
+
+  //! starts double word programming in interrupt mode
+  //! \param[in] address flash address, 8-byte aligned
+  //! \param[in] data double word to be programmed
+  //! \param[in] operation operation that is started
+  void StartProgram(const uint32_t address, const uint64_t data,
+                    const Operation operation);
+
+  //! reads one double word and clears a resulting ECC error
+  //! \param[in] address flash address, 8-byte aligned
+  //! \param[out] data double word read
+  //! \return returns false if the double word has an ECC error
+  bool ReadDoubleWord(const uint32_t address, uint64_t* const data) const;
+
+  //! getter for the flash address of a journal page
+  //! \param[in] page journal page index
+  //! \return address of the first byte of the page
+  uint32_t GetPageAddress(const uint32_t page) const;
+
+  //! builds a record double word
+  //! \param[in] key key index
+  //! \param[in] value value of the setting
+  //! \return record with tag and CRC
+  uint64_t BuildRecord(const uint32_t key, const uint16_t value) const;
+
+  //! CRC-16/CCITT over the lower word of a record
+  //! \param[in] word record word to be protected
+  //! \return CRC value
+  uint16_t ComputeCrc(const uint32_t word) const;
+
+  //! first flash page of the journal, the linker script reserves the last
+  //! 4 KB of the 64 KB flash
+  static const uint32_t kFirstPage_ = 30U;
+
+  //! number of journal pages
+  static const uint32_t kPageCount_ = 2U;
+
+  //! page index that marks no active page
+  static const uint32_t kNoPage_ = 0xFFFFFFFFU;
+
+  //! size of a record or header in bytes
+  static const uint32_t kRecordSize_ = 8U;
+
+  //! magic value in the lower word of a page header
+  static const uint32_t kPageMagic_ = 0x4C4E524AU;
+
+  //! tag in the upper byte of the lower record word
+  static const uint32_t kRecordTag_ = 0x5AU;
+
+  //! failed flash operations in a row that stop programming
+  static const uint32_t kMaxRetries_ = 3U;
+
+  //! value of an erased double word
+  static const uint64_t kErased_ = 0xFFFFFFFFFFFFFFFFU;
+
+  //! number of keys
+  static const uint32_t kKeyCount_ =
+      static_cast<uint32_t>(SettingKey::kCount);
+
+  //! current values of all settings, compared by the flash interrupt
+  volatile uint16_t values_[kKeyCount_];
+
+  //! true if the setting has been loaded or written
+  bool is_valid_[kKeyCount_];
+
+  //! true if the value has not been programmed yet
+  volatile bool is_dirty_[kKeyCount_];
+
+  //! page with the highest valid generation, kNoPage_ if none
+  uint32_t active_page_;
+
+  //! generation of the active page
+  uint32_t generation_;
+
+  //! offset of the next free double word in the active page
+  uint32_t write_offset_;
+
+  //! page that is being compacted into
+  uint32_t compaction_page_;
+
+  //! offset of the next free double word in the compaction page, 0 until
+  //! the page is erased
+  uint32_t compaction_offset_;
+
+  //! next key to be copied during compaction
+  uint32_t compaction_key_;
+
+  //! key of the record being appended or copied
+  uint32_t program_key_;
+
+  //! value of the record being appended or copied
+  uint16_t program_value_;
+
+  //! failed flash operations in a row
+  uint32_t error_count_;
+
+  //! flash operation in progress
+  volatile Operation operation_;
+
+  //! true while a flash operation is in progress
+  volatile bool is_busy_;
+
+  //! set when kMaxRetries_ operations in a row have failed, stops
+  //! programming until the next Write()
+  volatile bool has_error_;
+
+  //! double ECC error inside the journal pages, set by HandleEccError()
+  static volatile bool is_ecc_error_;
+};
+
+}  // namespace tkrandom
+#endif  // SETTINGS_JOURNAL_HPP_
@@ -0,0 +1,161 @@
+//! \brief     Class declaration for applying and changing the persistent
+//!            settings.
+//! \details   Applies the settings journal at startup and handles setting
+//!            commands of the host at runtime.
+//! \file      settings_manager.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef SETTINGS_MANAGER_HPP_
+#define SETTINGS_MANAGER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "event_handler.hpp"
+#include "generator.hpp"
+#include "interrupt_tiers.hpp"
+#include "noise_handler.hpp"
+#include "power_manager.hpp"
+#include "rng_handler.hpp"
+#include "settings_journal.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for SettingsManager member function return values
+enum class SettingsManagerStatus : uint8_t {
+  kSuccess,   //!< setting applied and queued for the journal
+  kRejected,  //!< invalid key or value, nothing changed
+  kError      //!< setting could not be applied or stored
+};
+
+//! mailbox of a setting command
+//! \details the host writes key and value by the debugger, then sets
+//!          is_pending, and polls is_pending until it is cleared
+struct SettingsCommand {
+  volatile uint16_t key;                  //!< SettingKey of the setting
+  volatile uint16_t value;                //!< new value of the setting
+  volatile bool is_pending;               //!< set by the host, cleared when
+                                          //!< the command has been handled
+  volatile SettingsManagerStatus status;  //!< result of the last command
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! SettingsManager class declaration
+//! \details The front panel has no control for the settings, they are changed
+//!          by the host through the command mailbox, which the debugger writes
+//!          at runtime like the gate_replay results are read. Process() in the
+//!          main loop validates a command, applies it to the running firmware
+//!          and writes it to the journal, so it is applied again at the next
+//!          start. It drives the journal programming as well. The seed of the deterministic mode is stored only and takes
+//!          effect at the next start, so that its sequence always starts from
+//!          the beginning.
+class SettingsManager {
+ public:
+  //! constructor
+  //! \param[in] settings_journal SettingsJournal reference to load and store
+  //! \param[in] event_handler EventHandler reference for the gate settings
+  //! \param[in] rng_handler RngHandler reference for the output settings
+  //! \param[in] generator Generator reference for the seed
+  //! \param[in] power_manager PowerManager reference for the clock profile
+  //! \param[in] noise_handler NoiseHandler reference for the noise output
+  constexpr SettingsManager(SettingsJournal& settings_journal,
+                            EventHandler& event_handler,
+                            RngHandler& rng_handler,
+                            Generator& generator,
+                            PowerManager& power_manager,
+                            NoiseHandler& noise_handler)
+      : settings_journal_(settings_journal),
+        event_handler_(event_handler),
+        rng_handler_(rng_handler),
+        generator_(generator),
+        power_manager_(power_manager),
+        noise_handler_(noise_handler),
+        command_{0U, 0U, false, SettingsManagerStatus::kSuccess} {}
+
+  //! destructor
+  ~SettingsManager(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  SettingsManager(const SettingsManager&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  SettingsManager& operator=(SettingsManager const&) = delete;
+
+  //! selects the deterministic sequence if a seed is stored in the journal,
+  //! the STM32 RNG otherwise
+  //! \details called after SettingsJournal::Init() and before the Generator
+  //!          is used by EventHandler::Init()
+  void ApplySeed(void);
+
+  //! applies all settings loaded from the journal, missing or invalid values
+  //! keep the defaults
+  //! \details called once after EventHandler::Init()
+  void ApplySettings(void);
+
+  //! validates a setting, applies it and queues it for the journal
+  //! \details must be called from thread mode
+  //! \param[in] key key of the setting
+  //! \param[in] value new value of the setting
+  //! \return kRejected for an invalid key or value
+  SettingsManagerStatus Apply(const SettingKey key, const uint16_t value);
+
+  //! posts a command to the mailbox, like the debugger does
+  //! \param[in] key key of the setting
+  //! \param[in] value new value of the setting
+  void PostCommand(const SettingKey key, const uint16_t value);
+
+  //! handles a pending command and drives the journal, called cyclically
+  //! from the main loop
+  //! \return kError while the journal fails to store the settings, the
+  //!         status in the mailbox is kError as well
+  SettingsManagerStatus Process(void);
+
+  //! getter for the command mailbox
+  //! \return mailbox, is_pending is false once the last command is handled
+  const SettingsCommand& GetCommand(void) const;
+
+ private:
+  //! bits per output in the kChaosSources value
+  static const uint32_t kSourceBits_ = 2U;
+
+  //! checks a value against the range of its setting
+  //! \details also rejects the low-clock profile while the noise output is
+  //!          set and the noise output while the low-clock profile is set
+  //! \param[in] key key index
+  //! \param[in] value value of the setting
+  //! \return true if the value is valid
+  bool IsValid(const uint32_t key, const uint16_t value) const;
+
+  //! applies one setting as stored in the journal
+  //! \param[in] key key of the setting
+  //! \return kError if the setting could not be applied
+  SettingsManagerStatus ApplyStored(const SettingKey key);
+
+  //! settings journal
+  SettingsJournal& settings_journal_;
+
+  //! event handler for the hold modes and the track rate
+  EventHandler& event_handler_;
+
+  //! RNG handler for the LED decay and the chaotic sources
+  RngHandler& rng_handler_;
+
+  //! generator for the seed
+  Generator& generator_;
+
+  //! power manager for the clock profile
+  PowerManager& power_manager_;
+
+  //! noise handler for the streamed noise
+  NoiseHandler& noise_handler_;
+
+  //! command mailbox written by the host
+  SettingsCommand command_;
+};
+
+}  // namespace tkrandom
+#endif  // SETTINGS_MANAGER_HPP_
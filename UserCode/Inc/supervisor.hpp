@@ -0,0 +1,174 @@
+//! \brief     Class declaration for the fault recovery supervisor.
+//! \details   Reinitializes failed peripherals, restores the outputs and feeds
+//!            the independent watchdog while the main loop is alive.
+//! \file      supervisor.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef SUPERVISOR_HPP_
+#define SUPERVISOR_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "cycle_counter.hpp"
+#include "generator.hpp"
+#include "interrupt_tiers.hpp"
+#include "pcb_status_led.hpp"
+#include "ram_code.hpp"
+#include "trace_log.hpp"
+#include "transmitter.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the faults reported to the Supervisor
+enum class Fault : uint8_t {
+  kTransfer,  //!< SPI or DMA transfer failed, SPI and DAC are reinitialized
+  kRng,       //!< RNG seed or clock error, the RNG is reinitialized
+  kGeneral,   //!< Error_Handler() or unknown source, all of the above
+  kFatal      //!< Error_Handler() before Init(), a peripheral did not start,
+              //!< never recovered, the IWDG resets the MCU
+};
+
+//! enum type for Supervisor member function return values
+enum class SupervisorStatus {
+  kSuccess,  //!< pending faults have been recovered
+  kIdle,     //!< no fault pending
+  kError     //!< recovery failed, the fault stays pending
+};
+
+//! counters of the fault recovery
+struct RecoveryStatistics {
+  uint32_t faults;       //!< reported faults
+  uint32_t recoveries;   //!< successful recoveries
+  uint32_t failures;     //!< failed recovery attempts
+  uint32_t last_cycles;  //!< CPU cycles from the report to the last recovery
+  uint32_t max_cycles;   //!< longest time to recovery in CPU cycles
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! Supervisor class declaration
+//! \details Faults are reported from any context and recovered by Process()
+//!          in the main loop with the gate work masked: SPI1 is reset by the
+//!          HAL driver with the configuration of MX_SPI1_Init(), the DAC by
+//!          Transmitter::Init(), then the last values of all DAC channels are
+//!          sent again. The time to recovery is logged as TraceEvent::kRecovery.
+//!          The IWDG is fed by the 1 kHz timer as long as the main loop has
+//!          called Process() within kLoopTimeout_ ms, so a stalled main loop,
+//!          a stalled timer, kMaxAttempts_ failed recoveries in a row or a
+//!          Fault::kFatal reset the MCU. The IWDG is driven by register access
+//!          since the HAL IWDG module is not part of the project.
+class Supervisor {
+ public:
+  //! constructor
+  //! \param[in] transmitter Transmitter reference to recover SPI and DAC
+  //! \param[in] generator Generator reference to recover the RNG
+  //! \param[in] pcb_status_led reference to signal a failed recovery
+  constexpr Supervisor(Transmitter& transmitter,
+                       Generator& generator,
+                       PcbStatusLed& pcb_status_led)
+      : transmitter_(transmitter),
+        generator_(generator),
+        pcb_status_led_(pcb_status_led),
+        pending_faults_(0U),
+        fault_timestamp_(0U),
+        loop_silence_(0U),
+        attempts_(0U),
+        is_started_(false),
+        statistics_{0U, 0U, 0U, 0U, 0U} {}
+
+  //! destructor
+  ~Supervisor(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  Supervisor(const Supervisor&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  Supervisor& operator=(Supervisor const&) = delete;
+
+  //! starts the IWDG, called once right before the main loop
+  //! \details faults reported earlier, e.g. by the MX_*_Init() functions,
+  //!          count their time to recovery from here
+  void Init(void);
+
+  //! reports a fault, can be called from any context and before Init()
+  //! \param[in] fault fault that has occurred
+  void ReportFault(const Fault fault);
+
+  //! getter for the IWDG state
+  //! \return true once Init() has started the IWDG
+  bool IsStarted(void) const;
+
+  //! reiteratively called in main() to recover the reported faults
+  //! \return kIdle if no fault was pending, kError while kFatal is pending
+  SupervisorStatus Process(void);
+
+  //! feeds the IWDG while the main loop is alive, called by the 1 kHz timer
+  void ProcessTick(void);
+
+  //! getter for the recovery counters
+  //! \return copy of the counters
+  RecoveryStatistics GetStatistics(void) const;
+
+ private:
+  //! reinitializes the peripherals of the pending faults
+  //! \param[in] faults bit mask of the pending faults
+  //! \return kError if a peripheral did not recover
+  SupervisorStatus Recover(const uint32_t faults);
+
+  //! ms without a Process() call until the IWDG is no longer fed
+  static const uint32_t kLoopTimeout_ = 100U;
+
+  //! consecutive failed recoveries until the IWDG is no longer fed
+  static const uint32_t kMaxAttempts_ = 3U;
+
+  //! IWDG prescaler register value, LSI 32 kHz / 32 = 1 kHz counter clock
+  static const uint32_t kWatchdogPrescaler_ = IWDG_PR_PR_1 | IWDG_PR_PR_0;
+
+  //! IWDG reload value, 500 ms at 1 kHz counter clock
+  static const uint32_t kWatchdogReload_ = 500U;
+
+  //! IWDG key register values
+  static const uint32_t kKeyStart_ = 0xCCCCU;
+  static const uint32_t kKeyAccess_ = 0x5555U;
+  static const uint32_t kKeyReload_ = 0xAAAAU;
+
+  //! Transmitter reference to recover SPI and DAC
+  Transmitter& transmitter_;
+
+  //! Generator reference to recover the RNG
+  Generator& generator_;
+
+  //! reference to signal a failed recovery by the PCB status LED
+  PcbStatusLed& pcb_status_led_;
+
+  //! bit mask of the reported faults, one bit per Fault
+  volatile uint32_t pending_faults_;
+
+  //! DWT cycle counter value of the first pending fault
+  volatile uint32_t fault_timestamp_;
+
+  //! 1 kHz ticks since the last Process() call
+  volatile uint32_t loop_silence_;
+
+  //! consecutive failed recovery attempts
+  uint32_t attempts_;
+
+  //! set to true by Init()
+  bool is_started_;
+
+  //! bit of Fault::kFatal in pending_faults_
+  static const uint32_t kFatalMask_ = 1U
+                                      << static_cast<uint32_t>(Fault::kFatal);
+
+  //! recovery counters
+  RecoveryStatistics statistics_;
+};
+
+}  // namespace tkrandom
+
+#endif  // SUPERVISOR_HPP_
@@ -0,0 +1,72 @@
+//! \brief     Class declaration for debouncing the distribution switches.
+//! \details   Samples the whole switch bank at 1 kHz with one port read and
+//!            runs an integrating debouncer per switch.
+//! \file      switch_debouncer.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef SWITCH_DEBOUNCER_HPP_
+#define SWITCH_DEBOUNCER_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "board.hpp"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! SwitchDebouncer class declaration
+//! \details every sample moves the integrator of each switch one step towards
+//!          its pin level, the stable state only follows when the integrator
+//!          reaches a bound, i.e. after kIntegratorLimit_ consistent samples
+//!          (5 ms at 1 kHz), bounces in between cancel out
+class SwitchDebouncer {
+ public:
+  //! constructor
+  //! \details the switch pins are taken from board.hpp
+  constexpr SwitchDebouncer(void)
+      : integrators_{},
+        stable_state_(0U),
+        kIntegratorLimit_(5U) {}
+
+  //! destructor
+  ~SwitchDebouncer(void) = default;
+
+  //! no copy constructor allowed since there is only one instance
+  SwitchDebouncer(const SwitchDebouncer&) = delete;
+
+  //! no assignment operator allowed since there is only one instance
+  SwitchDebouncer& operator=(SwitchDebouncer const&) = delete;
+
+  //! takes the current switch positions as stable state
+  void Init(void);
+
+  //! samples all switches once, called by the 1 kHz timer interrupt
+  //! \return true if the stable state of at least one switch has changed
+  bool ProcessSample(void);
+
+  //! getter for the debounced switch positions
+  //! \return one bit per switch, bit 0 is the switch of output 1
+  uint32_t GetState(void) const;
+
+ private:
+  //! number of switches in the bank
+  static const uint32_t kSwitchCount_ = 4U;
+
+  //! integrator per switch, 0 .. kIntegratorLimit_
+  uint8_t integrators_[kSwitchCount_];
+
+  //! debounced switch positions, one bit per switch
+  volatile uint32_t stable_state_;
+
+  //! number of consistent samples until a switch is regarded as stable
+  const uint8_t kIntegratorLimit_;
+};
+
+}  // namespace tkrandom
+#endif  // SWITCH_DEBOUNCER_HPP_
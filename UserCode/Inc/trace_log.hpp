@@ -0,0 +1,125 @@
+//! \brief     Class declaration for the post-mortem trace ring in RAM2.
+//! \details   Binary event ring and fault record that survive a system reset.
+//! \file      trace_log.hpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+#ifndef TRACE_LOG_HPP_
+#define TRACE_LOG_HPP_
+
+// INCLUDES --------------------------------------------------------------------
+#include "stm32l4xx_hal.h"
+#include "ram_code.hpp"
+
+namespace tkrandom {
+
+// TYPE DECLARATIONS -----------------------------------------------------------
+//! enum type for the traced events, data meaning in brackets
+enum class TraceEvent : uint8_t {
+  kNone,           //!< empty entry
+  kReset,          //!< startup (RCC_CSR reset flags >> 16)
+  kFault,          //!< HardFault or NMI (fault type), see TraceFault
+  kGate1Open,      //!< opening edge of IN_1
+  kGate1Close,     //!< closing edge of IN_1
+  kGate2Open,      //!< opening edge of IN_2
+  kGate2Close,     //!< closing edge of IN_2
+  kHandlerState,   //!< EventHandler state change (new state)
+  kLedMode,        //!< PcbStatusLed mode change (new mode)
+  kSpiError,       //!< SPI frame failed (HAL error code or 0xFFFF)
+  kRngError,       //!< RNG seed or clock error (RNG_SR)
+  kFlashError,     //!< settings journal programming failed (HAL error code)
+  kRecovery,       //!< Supervisor recovered the faults (time to recovery in us)
+  kRecoveryFailed  //!< Supervisor recovery attempt failed (fault bit mask)
+};
+
+//! one entry of the trace ring, 8 bytes
+struct TraceEntry {
+  uint32_t timestamp;  //!< HAL tick in ms
+  TraceEvent event;    //!< traced event
+  uint8_t sequence;    //!< low byte of the running entry number
+  uint16_t data;       //!< event specific data
+};
+
+//! CPU state captured by the fault handlers
+struct TraceFault {
+  uint32_t type;       //!< 1 HardFault, 2 NMI, 0 no fault recorded
+  uint32_t timestamp;  //!< HAL tick in ms
+  uint32_t r0;         //!< stacked registers of the exception frame
+  uint32_t r1;
+  uint32_t r2;
+  uint32_t r3;
+  uint32_t r12;
+  uint32_t lr;
+  uint32_t pc;
+  uint32_t xpsr;
+  uint32_t cfsr;       //!< configurable fault status register
+  uint32_t hfsr;       //!< HardFault status register
+  uint32_t mmfar;      //!< MemManage fault address
+  uint32_t bfar;       //!< BusFault fault address
+};
+
+// CLASS DECLARATION -----------------------------------------------------------
+//! TraceLog class declaration
+//! \details static only, the ring lives in the uninitialized section
+//!          .ram2_noinit that neither the startup code nor a system reset
+//!          clears (SRAM2_RST option bit set as delivered). A debugger reads
+//!          TraceLog::buffer_ after an error blink or a fault reset.
+class TraceLog {
+ public:
+  //! no instances, all members are static
+  TraceLog(void) = delete;
+
+  //! validates the retained ring, clears it after power-up, logs the reset
+  static void Init(void);
+
+  //! appends one entry, safe in thread mode and every interrupt
+  //! \param[in] event traced event
+  //! \param[in] data event specific data
+  static TKRANDOM_INLINE void Log(const TraceEvent event, const uint32_t data) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t sequence = buffer_.sequence++;
+    __set_PRIMASK(primask);
+    TraceEntry& entry = buffer_.entries[sequence & (kEntryCount_ - 1U)];
+    entry.timestamp = uwTick;
+    entry.event = event;
+    entry.sequence = static_cast<uint8_t>(sequence);
+    entry.data = static_cast<uint16_t>(data);
+  }
+
+  //! stores the CPU state and resets the MCU
+  //! \details called by the fault handlers with the stacked exception frame
+  //! \param[in] frame exception frame r0, r1, r2, r3, r12, lr, pc, xpsr
+  //! \param[in] type 1 HardFault, 2 NMI
+  static void CaptureFault(const uint32_t* const frame, const uint32_t type);
+
+  //! getter for the retained fault record
+  //! \return fault record, type 0 if no fault has been captured
+  static const TraceFault& GetFault(void);
+
+ private:
+  //! number of ring entries, power of two
+  static const uint32_t kEntryCount_ = 64U;
+
+  //! marks a valid ring after power-up
+  static const uint32_t kMagic_ = 0x54524143U;
+
+  //! ring with header, fault record and entries
+  struct Buffer {
+    uint32_t magic;                     //!< kMagic_ if the content is valid
+    uint32_t sequence;                  //!< number of logged entries
+    uint32_t reset_count;               //!< resets since power-up
+    TraceFault fault;                   //!< last captured fault
+    TraceEntry entries[kEntryCount_];   //!< ring, oldest entry is overwritten
+  };
+
+  //! retained trace buffer in .ram2_noinit
+  static Buffer buffer_;
+};
+
+}  // namespace tkrandom
+#endif  // TRACE_LOG_HPP_
@@ -13,6 +13,13 @@
 
 // INCLUDES --------------------------------------------------------------------
 #include "stm32l4xx_hal.h"
+#include "board.hpp"
+#include "cycle_counter.hpp"
+#include "interrupt_tiers.hpp"
+#include "latency_probes.hpp"
+#include "register_access.hpp"
+#include "trace_log.hpp"
+#include "ram_code.hpp"
 
 namespace tkrandom {
 
@@ -46,17 +53,26 @@ enum class TransmitterStatus {
 class Transmitter {
  public:
   //! constructor
+  //! \details NSS and DAC reset pins are taken from board.hpp
   //! \param[in] spi_handle pointer to SPI instance of HAL SPI driver
-  //! \param[in] gpio_port_nss pionter to GPIO port for SPI NSS
-  //! \param[in] pin_nss pin number of SPI NSS
-  Transmitter(SPI_HandleTypeDef* const spi_handle,
-              GPIO_TypeDef* const gpio_port_nss,
-              const uint16_t pin_nss,
-              GPIO_TypeDef* const gpio_port_dac,
-              const uint16_t pin_dac);
+  constexpr explicit Transmitter(SPI_HandleTypeDef* const spi_handle)
+      : spi_handle_(spi_handle),
+        kTimeout_(1000U),
+        kWriteCommand_(0x30U),
+        kLedOffValue_(27500U),
+        queue_{},
+        dma_frame_{},
+        shadow_{},
+        queue_head_(0U),
+        queue_tail_(0U),
+        is_dma_busy_(false),
+        is_bus_locked_(false),
+        streamed_outputs_(0U),
+        dropped_frames_(0U),
+        frame_cycles_(0U) {}
 
   //! destructor
-  ~Transmitter() {}
+  ~Transmitter(void) = default;
 
   //! no copy constructor allowed since there is only one instance
   Transmitter(const Transmitter&) = delete;
@@ -68,25 +84,141 @@ class Transmitter {
   void Init(void);
 
   //! sets the value of a front panel voltage output
+  //! \details skipped if the output is currently streamed (see StreamVoltage())
   //! \param[in] output output the value is set for
   //! \param[in] value value that is set (0 .. 2^16-1)
   //! \return returns kSuccess if no error occurs
-  TransmitterStatus SetVoltage(const Output output, const uint16_t value) const;
+  TransmitterStatus SetVoltage(const Output output, const uint16_t value);
 
   //! sets the value of a front panel LED
   //! \param[in] output output whose LED brightness is set
   //! \param[in] value value that is set (0 .. 2^16-1)
   //! \return returns kSuccess if no error occurs
-  TransmitterStatus SetLedBrightness(const Led output,
-                                     const uint16_t value) const;
+  TransmitterStatus SetLedBrightness(const Led output, const uint16_t value);
+
+  //! queues the value of a front panel voltage output for a DMA transfer
+  //! \details non-blocking, can be called from interrupt context, skipped if
+  //!          the output is currently streamed (see StreamVoltage())
+  //! \param[in] output output the value is set for
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  //! \return returns kError if the frame queue is full
+  TransmitterStatus QueueVoltage(const Output output, const uint16_t value);
+
+  //! queues the value of a front panel LED for a DMA transfer
+  //! \details non-blocking, can be called from interrupt context
+  //! \param[in] led LED whose brightness is set
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  //! \return returns kError if the frame queue is full
+  TransmitterStatus QueueLedBrightness(const Led led, const uint16_t value);
+
+  //! queues the value of a streamed front panel voltage output
+  //! \details non-blocking, can be called from interrupt context
+  //! \param[in] output output the value is set for
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  //! \return returns kError if the frame queue is full
+  TransmitterStatus StreamVoltage(const Output output, const uint16_t value);
+
+  //! marks an output as streamed via StreamVoltage()
+  //! \details SetVoltage() and QueueVoltage() leave streamed outputs untouched
+  //! \param[in] output output whose streaming state is set
+  //! \param[in] is_streamed true if the output is streamed
+  void SetStreamedOutput(const Output output, const bool is_streamed);
+
+  //! called by HAL_SPI_TxCpltCallback() after a DMA frame has been sent
+  void ProcessTransferComplete(void);
+
+  //! called by HAL_SPI_ErrorCallback() if a DMA frame failed
+  void ProcessTransferError(void);
+
+  //! changes the SPI clock divider, e.g. after a system clock change
+  //! \details waits for a running DMA frame, queued frames are sent afterwards
+  //! \param[in] prescaler SPI_BAUDRATEPRESCALER_x value of the HAL SPI driver
+  void SetBaudRatePrescaler(const uint32_t prescaler);
+
+  //! resets SPI and DAC and sends the last value of every DAC channel again
+  //! \details the SPI handle keeps the configuration of MX_SPI1_Init(), a
+  //!          running DMA frame is aborted, queued frames are sent afterwards
+  //! \return returns kError if the SPI did not initialize or a frame failed
+  TransmitterStatus Recover(void);
+
+  //! getter for the CPU cycles of the last blocking frame transfer
+  //! \details measured from frame assembly to NSS release, define
+  //!          TKRANDOM_SPI_HAL to measure the former HAL_SPI_Transmit() path
+  //! \return CPU cycles of the last SetVoltage() or SetLedBrightness() frame
+  uint32_t GetFrameCycles(void) const;
 
  private:
+  //! measures the private hot paths, see micro_bench.hpp
+  friend class MicroBench;
+
+  //! scales an LED brightness to the DAC range that makes the LED illuminate
+  //! \param[in] value brightness (0 .. 2^16-1)
+  //! \return DAC value for the LED output
+  uint16_t ScaleLedValue(const uint16_t value) const;
+
+  //! getter for the streaming state of an output
+  //! \param[in] output output whose streaming state is requested
+  //! \return true if the output is streamed via StreamVoltage()
+  bool IsStreamedOutput(const Output output) const;
+
   //! transmits the value for a voltage output or LED to the DAC via SPI
+  //! \details waits for a running DMA frame, queued frames are sent afterwards
   //! \param[in] address output port of DAC
   //! \param[in] value value that is set (0 .. 2^16-1)
   //! \return returns kSuccess if no error occurs
-  TransmitterStatus TransmitValue(const uint8_t address,
-                                  const uint16_t value) const;
+  TransmitterStatus TransmitValue(const uint8_t address, const uint16_t value);
+
+  //! takes the SPI bus from the DMA queue for blocking access
+  //! \details waits for a running DMA frame, queued frames are held back
+  void LockBus(void);
+
+  //! returns the SPI bus to the DMA queue and resumes queued frames
+  void ReleaseBus(void);
+
+  //! sends one DAC frame with the bus taken by LockBus()
+  //! \details by WriteFrame() and RecoverFrame() on failure, define
+  //!          TKRANDOM_SPI_HAL for HAL_SPI_Transmit()
+  //! \param[in] frame 3-byte DAC frame
+  //! \return returns kSuccess if no error occurs
+  TransmitterStatus SendFrame(uint8_t* const frame);
+
+  //! sends one DAC frame by direct SPI1 register access
+  //! \details 8-bit data size with data packing: one 16-bit and one 8-bit
+  //!          write put the whole frame into the TX FIFO
+  //! \param[in] frame 3-byte DAC frame
+  //! \return returns kError if the frame did not leave the FIFO in time
+  TransmitterStatus WriteFrame(const uint8_t* const frame);
+
+  //! resets the SPI by the HAL driver and sends the frame again by HAL
+  //! \param[in] frame 3-byte DAC frame
+  //! \return returns kSuccess if the recovery transfer succeeded
+  TransmitterStatus RecoverFrame(const uint8_t* const frame);
+
+  //! queues the value for a voltage output or LED for a DMA transfer
+  //! \param[in] address output port of DAC
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  //! \return returns kError if the frame queue is full
+  TransmitterStatus QueueValue(const uint8_t address, const uint16_t value);
+
+  //! starts the DMA transfer of the oldest queued frame
+  //! \details must be called with interrupts disabled or from the DMA callback
+  void StartNextFrame(void);
+
+  //! writes the 3-byte DAC frame for an output address and value
+  //! \param[in] address output port of DAC
+  //! \param[in] value value that is set (0 .. 2^16-1)
+  //! \param[out] frame 3-byte buffer the frame is written to
+  void BuildFrame(const uint8_t address, const uint16_t value,
+                  uint8_t* const frame) const;
+
+  //! size of the DMA frame queue (power of two)
+  static const uint32_t kQueueSize_ = 16U;
+
+  //! number of DAC channels, 4 outputs and 4 LEDs
+  static const uint8_t kChannelCount_ = 8U;
+
+  //! number of bytes of one DAC frame
+  static const uint16_t kFrameSize_ = 3U;
 
   //! pointer to SPI instance of HAL SPI driver
   SPI_HandleTypeDef* spi_handle_;
@@ -94,26 +226,46 @@ class Transmitter {
   //! timeout value for SPI HAL driver
   const uint32_t kTimeout_;
 
+  //! number of status register polls until a frame transfer is an error
+  //! \details a frame takes 24 SPI clock cycles, i.e. 48 CPU cycles
+  static const uint32_t kPollLimit_ = 1000U;
+
   //! DAC write command for SPI transfer
   const uint8_t kWriteCommand_;
 
-  //! pionter to GPIO port for SPI NSS
-  GPIO_TypeDef* const gpio_port_nss_;
+  //! DAC output value that must be exceeded to make an LED illuminate
+  // \details this value is set to an DAC LED output if the random value is Zero
+  const uint16_t kLedOffValue_;
 
-  //! pionter to GPIO port for DAC reset line
-  GPIO_TypeDef* const gpio_port_dac_;
+  //! queued DAC frames waiting for their DMA transfer
+  uint8_t queue_[kQueueSize_][kFrameSize_];
 
-  //! pin number of SPI NSS
-  const uint16_t kPinNss_;
+  //! DAC frame currently transferred by DMA
+  uint8_t dma_frame_[kFrameSize_];
 
-  //! pin number of DAC reset line
-  const uint16_t kPinDac_;
+  //! last value per DAC channel, queued or sent, for Recover()
+  uint16_t shadow_[kChannelCount_];
 
-  //! DAC output value that must be exceeded to make an LED illuminate
-  // \details this value is set to an DAC LED output if the random value is Zero
-  const uint16_t kLedOffValue_;
+  //! free-running write index of queue_[]
+  volatile uint32_t queue_head_;
+
+  //! free-running read index of queue_[]
+  volatile uint32_t queue_tail_;
+
+  //! set to true while a DMA frame is transferred
+  volatile bool is_dma_busy_;
+
+  //! set to true while a blocking transfer owns the SPI bus
+  volatile bool is_bus_locked_;
+
+  //! bit mask of the outputs that are streamed via StreamVoltage()
+  volatile uint8_t streamed_outputs_;
 
+  //! number of frames rejected because the queue was full
+  volatile uint32_t dropped_frames_;
 
+  //! CPU cycles of the last blocking frame transfer
+  uint32_t frame_cycles_;
 };
 
 }  // namespace tkrandom
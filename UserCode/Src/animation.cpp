@@ -1,5 +1,6 @@
 //! \brief     Class definition for frontpanel LED animation.
-//! \details   Definition of function members for LED switching patterns.
+//! \details   Definition of function members for table-driven LED keyframe
+//!            animations.
 //! \file      animation.cpp
 //! \author    André Niederlein
 //! \date      2020-07-29
@@ -16,73 +17,55 @@
 namespace tkrandom {
 
 // MEMBER FUNCTIONS ------------------------------------------------------------
-Animation::Animation(Transmitter& transmitter)
-    : state_(AnimationState::kStateNone),
-      transmitter_(transmitter) {
-
+void Animation::Start(const std::span<const Keyframe> keyframes) {
+  keyframes_ = keyframes;
+  index_ = 0U;
+  elapsed_ = 0U;
+  is_running_ = !keyframes.empty();
 }
 //------------------------------------------------------------------------------
-AnimationStatus Animation::ClockAnimation() {
-  AnimationStatus return_value = AnimationStatus::kOngoing;
-  TransmitterStatus transmitter_status = TransmitterStatus::kSuccess;
-
-  // switches LEDs if counter threshold has been reached
-  switch (state_) {
-    case AnimationState::kStateNone:
-      transmitter_status = transmitter_.SetLedBrightness(Led::kLed1, 0xffffU);
-      state_ = AnimationState::kState1;
-      break;
-    case AnimationState::kState1:
-      transmitter_status = SwitchLeds(Led::kLed2, Led::kLed1);
-      state_ = AnimationState::kState2;
-      break;
-    case AnimationState::kState2:
-      transmitter_status = SwitchLeds(Led::kLed3, Led::kLed2);
-      state_ = AnimationState::kState3;
-      break;
-    case AnimationState::kState3:
-      transmitter_status = SwitchLeds(Led::kLed4, Led::kLed3);
-      state_ = AnimationState::kState4;
-      break;
-    case AnimationState::kState4:
-      transmitter_status = SwitchLeds(Led::kLed3, Led::kLed4);
-      state_ = AnimationState::kState5;
-      break;
-    case AnimationState::kState5:
-      transmitter_status = SwitchLeds(Led::kLed2, Led::kLed3);
-      state_ = AnimationState::kState6;
-      break;
-    case AnimationState::kState6:
-      transmitter_status = SwitchLeds(Led::kLed1, Led::kLed2);
-      state_ = AnimationState::kState7;
-      break;
-    case AnimationState::kState7:
-      transmitter_status = transmitter_.SetLedBrightness(Led::kLed1, 0x0000U);
-      state_ = AnimationState::kStateComplete;
-      break;
-    case AnimationState::kStateComplete:
-      return_value = AnimationStatus::kCompleted;
-      break;
-    default:
-      break;
-  }
+AnimationStatus Animation::ProcessTick(const uint32_t elapsed) {
+  AnimationStatus return_value = AnimationStatus::kCompleted;
 
-  if (transmitter_status != TransmitterStatus::kSuccess) {
-    return_value = AnimationStatus::kError;
+  if (is_running_) {
+    // skips the keyframes that have passed since the last call
+    elapsed_ += elapsed;
+    while (is_running_ && (elapsed_ >= keyframes_[index_].duration)) {
+      elapsed_ -= keyframes_[index_].duration;
+      index_++;
+      is_running_ = index_ < keyframes_.size();
+    }
+    if (is_running_) {
+      for (uint32_t led = 0U; led < kLedCount_; ++led) {
+        led_refresher_.SetOverlay(
+            static_cast<Led>(static_cast<uint32_t>(Led::kLed1) + led),
+            Interpolate(led));
+      }
+      return_value = AnimationStatus::kOngoing;
+    }
+    else {
+      led_refresher_.ReleaseOverlay();
+    }
   }
 
   return return_value;
 }
 //------------------------------------------------------------------------------
-TransmitterStatus Animation::SwitchLeds(const Led led_on,
-                                        const Led led_off) const {
-  TransmitterStatus return_code =
-      transmitter_.SetLedBrightness(led_on, 0xffffU);
-  if (return_code == TransmitterStatus::kSuccess) {
-    return_code = transmitter_.SetLedBrightness(led_off, 0x0000U);
+uint16_t Animation::Interpolate(const uint32_t led) const {
+  const Keyframe& keyframe = keyframes_[index_];
+  uint16_t return_value = keyframe.brightness[led];
+
+  if ((keyframe.interpolation == Interpolation::kLinear) &&
+      ((index_ + 1U) < keyframes_.size())) {
+    const int32_t from = keyframe.brightness[led];
+    const int32_t to = keyframes_[index_ + 1U].brightness[led];
+    // elapsed_ < duration, so the product stays within 32 bits
+    return_value = static_cast<uint16_t>(
+        from + (((to - from) * static_cast<int32_t>(elapsed_)) /
+                static_cast<int32_t>(keyframe.duration)));
   }
 
-  return return_code;
+  return return_value;
 }
 
 }  // namespace tkrandom
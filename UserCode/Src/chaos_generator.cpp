@@ -0,0 +1,151 @@
+//! \brief     Class definition for deterministic chaotic number generation.
+//! \details   Logistic map, Lorenz attractor and Henon map in fixed point.
+//! \file      chaos_generator.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "chaos_generator.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void ChaosGenerator::SetMap(const ChaosMap map) {
+  map_ = map;
+  // initial states inside the basin of attraction of each system
+  logistic_x_ = kLogisticSeed_;
+  lorenz_x_ = 1 << 16;
+  lorenz_y_ = 1 << 16;
+  lorenz_z_ = 1 << 16;
+  henon_x_ = 1 << 25;  // ~0.125
+  henon_y_ = 1 << 25;
+}
+//------------------------------------------------------------------------------
+ChaosMap ChaosGenerator::GetMap() const {
+  return map_;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void ChaosGenerator::Step(const int32_t perturbation) {
+  switch (map_) {
+    case ChaosMap::kLogistic:
+      StepLogistic(perturbation);
+      break;
+    case ChaosMap::kLorenz:
+      StepLorenz(perturbation);
+      break;
+    case ChaosMap::kHenon:
+      StepHenon(perturbation);
+      break;
+    default:
+      break;
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+uint16_t ChaosGenerator::GetValue() const {
+  int64_t value = 0;
+
+  switch (map_) {
+    case ChaosMap::kLogistic:
+      value = static_cast<int64_t>(logistic_x_ >> 16U);
+      break;
+    case ChaosMap::kLorenz:
+      // x stays within +-20, [-24, 24] is mapped to [0, 65535]
+      value = ((static_cast<int64_t>(lorenz_x_) + (24 << 16)) * 1365) >> 16;
+      break;
+    case ChaosMap::kHenon:
+      // x stays within +-1.3, [-1.5, 1.5] is mapped to [0, 65535]
+      value = ((static_cast<int64_t>(henon_x_) + (3 << 27)) * 21845) >> 28;
+      break;
+    default:
+      break;
+  }
+  if (value < 0) {
+    value = 0;
+  }
+  if (value > 0xffff) {
+    value = 0xffff;
+  }
+
+  return static_cast<uint16_t>(value);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void ChaosGenerator::StepLogistic(const int32_t perturbation) {
+  // x (1 - x) in Q0.32 is at most 0.25, multiplied by r < 4 stays below 1
+  const uint64_t x = logistic_x_;
+  const uint64_t product = (x * ((1ULL << 32U) - x)) >> 32U;
+  uint64_t next = (product * kLogisticR_) >> 30U;
+  next += static_cast<uint64_t>(static_cast<int64_t>(perturbation) * 65536);
+  // finite precision lets the orbit collapse to 0 eventually
+  if ((static_cast<uint32_t>(next) == 0U) || (next > 0xffffffffULL)) {
+    next = kLogisticSeed_ + static_cast<uint32_t>(perturbation);
+  }
+  logistic_x_ = static_cast<uint32_t>(next);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void ChaosGenerator::StepLorenz(const int32_t perturbation) {
+  lorenz_x_ += perturbation;
+  for (uint32_t i = 0U; i < kLorenzSubsteps_; ++i) {
+    int32_t dx = 0;
+    int32_t dy = 0;
+    int32_t dz = 0;
+    // midpoint method: derivatives at half a step decide the full step
+    LorenzDerivatives(lorenz_x_, lorenz_y_, lorenz_z_, &dx, &dy, &dz);
+    const int32_t x_mid = lorenz_x_ + (dx >> (kLorenzDtShift_ + 1U));
+    const int32_t y_mid = lorenz_y_ + (dy >> (kLorenzDtShift_ + 1U));
+    const int32_t z_mid = lorenz_z_ + (dz >> (kLorenzDtShift_ + 1U));
+    LorenzDerivatives(x_mid, y_mid, z_mid, &dx, &dy, &dz);
+    lorenz_x_ += dx >> kLorenzDtShift_;
+    lorenz_y_ += dy >> kLorenzDtShift_;
+    lorenz_z_ += dz >> kLorenzDtShift_;
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void ChaosGenerator::StepHenon(const int32_t perturbation) {
+  // |x| <= kHenonLimit_ keeps x^2 within Q3.28, a x^2 and the sum may not
+  // fit and are calculated with 64 bits
+  const int32_t x_square = MultiplyQ28(henon_x_, henon_x_);
+  const int64_t next_x =
+      (static_cast<int64_t>(1) << 28) -
+      ((static_cast<int64_t>(kHenonA_) * x_square) >> 28) + henon_y_ +
+      (static_cast<int64_t>(perturbation) * (1 << 12));
+  // perturbations may push the orbit out of the basin of attraction
+  if ((next_x > kHenonLimit_) || (next_x < -kHenonLimit_)) {
+    SetMap(ChaosMap::kHenon);
+  }
+  else {
+    henon_y_ = MultiplyQ28(kHenonB_, henon_x_);
+    henon_x_ = static_cast<int32_t>(next_x);
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void ChaosGenerator::LorenzDerivatives(const int32_t x, const int32_t y,
+                                       const int32_t z, int32_t* const dx,
+                                       int32_t* const dy, int32_t* const dz) {
+  *dx = kLorenzSigma_ * (y - x);
+  *dy = MultiplyQ16(x, kLorenzRho_ - z) - y;
+  *dz = MultiplyQ16(x, y) - MultiplyQ16(kLorenzBeta_, z);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+int32_t ChaosGenerator::MultiplyQ16(const int32_t a, const int32_t b) {
+  return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 16);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+int32_t ChaosGenerator::MultiplyQ28(const int32_t a, const int32_t b) {
+  return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 28);
+}
+
+}  // namespace tkrandom
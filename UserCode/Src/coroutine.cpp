@@ -0,0 +1,179 @@
+//! \brief     Class definitions for the stackless coroutine runtime.
+//! \details   C++20 coroutines with statically allocated frames and awaitables
+//!            for timer ticks, gate edges, DMA completion and RNG words.
+//! \file      coroutine.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "coroutine.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+namespace {
+
+//! static frame pool, no coroutine frame is allocated on the heap
+alignas(8) uint8_t frames[Coroutine::kFrameCount][Coroutine::kFrameSize];
+
+//! bit mask of the frames in use
+uint32_t used_frames = 0U;
+
+}  // namespace
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void* Coroutine::promise_type::operator new(const std::size_t size) noexcept {
+  void* return_value = nullptr;
+
+  // coroutine functions are called in thread mode only
+  if (size <= kFrameSize) {
+    for (uint32_t i = 0U; i < kFrameCount; ++i) {
+      if ((used_frames & (1U << i)) == 0U) {
+        used_frames |= 1U << i;
+        return_value = frames[i];
+        break;
+      }
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void Coroutine::promise_type::operator delete(void* const frame) noexcept {
+  for (uint32_t i = 0U; i < kFrameCount; ++i) {
+    if (frame == frames[i]) {
+      used_frames &= ~(1U << i);
+    }
+  }
+}
+//------------------------------------------------------------------------------
+CoroutineExecutor::~CoroutineExecutor() {
+  for (uint32_t slot = 0U; slot < kSlotCount_; ++slot) {
+    if ((used_ & (1U << slot)) != 0U) {
+      handles_[slot].destroy();
+    }
+  }
+}
+//------------------------------------------------------------------------------
+CoroutineStatus CoroutineExecutor::Spawn(Coroutine&& coroutine) {
+  CoroutineStatus return_value = CoroutineStatus::kError;
+  const Coroutine::Handle handle = coroutine.Release();
+
+  if (handle) {
+    for (uint32_t slot = 0U; slot < kSlotCount_; ++slot) {
+      if ((used_ & (1U << slot)) == 0U) {
+        used_ |= 1U << slot;
+        handles_[slot] = handle;
+        handle.promise().slot = static_cast<uint8_t>(slot);
+        // runs up to its first co_await with the next RunReady()
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        ready_ = ready_ | (1U << slot);
+        __set_PRIMASK(primask);
+        return_value = CoroutineStatus::kSuccess;
+        break;
+      }
+    }
+    if (return_value != CoroutineStatus::kSuccess) {
+      handle.destroy();
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+CoroutineStatus CoroutineExecutor::RunReady() {
+  CoroutineStatus return_value = CoroutineStatus::kIdle;
+
+  // the only event source without an interrupt
+  if ((waiting_[static_cast<uint32_t>(CoroutineEvent::kRandomWord)] != 0U) &&
+      generator_.IsWordReady()) {
+    Signal(CoroutineEvent::kRandomWord);
+  }
+
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  const uint32_t ready = ready_;
+  ready_ = 0U;
+  __set_PRIMASK(primask);
+
+  for (uint32_t slot = 0U; slot < kSlotCount_; ++slot) {
+    if ((ready & (1U << slot)) != 0U) {
+      const Coroutine::Handle handle = handles_[slot];
+      handle.resume();
+      if (handle.done()) {
+        handle.destroy();
+        handles_[slot] = nullptr;
+        used_ &= ~(1U << slot);
+      }
+      return_value = CoroutineStatus::kSuccess;
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void CoroutineExecutor::ProcessTick() {
+  const uint32_t tick = tick_ + 1U;
+  tick_ = tick;
+
+  uint32_t sleeping = sleeping_;
+  uint32_t due = 0U;
+  while (sleeping != 0U) {
+    const uint32_t slot = static_cast<uint32_t>(__builtin_ctz(sleeping));
+    sleeping &= sleeping - 1U;
+    // wraps around after 2^32 ticks like the DWT cycle counter
+    if (static_cast<int32_t>(tick - deadlines_[slot]) >= 0) {
+      due |= 1U << slot;
+    }
+  }
+  if (due != 0U) {
+    // gate and DMA interrupts preempt the timer and fire events as well
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    sleeping_ = sleeping_ & ~due;
+    ready_ = ready_ | due;
+    __set_PRIMASK(primask);
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void CoroutineExecutor::Signal(const CoroutineEvent event) {
+  const uint32_t index = static_cast<uint32_t>(event);
+
+  if (index < kEventCount_) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ready_ = ready_ | waiting_[index];
+    waiting_[index] = 0U;
+    __set_PRIMASK(primask);
+  }
+}
+//------------------------------------------------------------------------------
+void CoroutineExecutor::RegisterSleep(const uint8_t slot,
+                                      const uint32_t ticks) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  deadlines_[slot] = tick_ + ticks;
+  sleeping_ = sleeping_ | (1U << slot);
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+void CoroutineExecutor::RegisterWait(const uint8_t slot,
+                                     const CoroutineEvent event) {
+  const uint32_t index = static_cast<uint32_t>(event);
+
+  if (index < kEventCount_) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    waiting_[index] = waiting_[index] | (1U << slot);
+    __set_PRIMASK(primask);
+  }
+}
+
+}  // namespace tkrandom
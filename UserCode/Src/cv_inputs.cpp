@@ -0,0 +1,123 @@
+//! \brief     Class definition for the CV inputs of the random parameters.
+//! \details   Continuous ADC scan of the CV inputs by circular DMA with
+//!            hardware oversampling and fixed-point smoothing.
+//! \file      cv_inputs.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "cv_inputs.hpp"
+
+#include <cstdint>
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+namespace {
+
+//! ADC1 channels of PA0 .. PA3 in scan order
+const uint32_t kChannels[] = {5U, 6U, 7U, 8U};
+
+//! sampling time of 247.5 ADC clock cycles for the CV input dividers
+const uint32_t kSampleTime = 0x6U;
+
+//! 16x oversampling without shift, the sum of 16 12-bit conversions
+const uint32_t kOversampling = ADC_CFGR2_ROVSE | (0x3UL << ADC_CFGR2_OVSR_Pos);
+
+//! waits until a condition holds or the timeout has passed
+//! \param[in] is_done condition to wait for
+//! \param[in] timeout ms until the wait fails
+//! \return true if the condition holds
+template <typename Condition>
+bool WaitFor(const Condition is_done, const uint32_t timeout) {
+  const uint32_t tick_start = HAL_GetTick();
+  bool return_value = is_done();
+  while ((!return_value) && ((HAL_GetTick() - tick_start) < timeout)) {
+    return_value = is_done();
+  }
+  return return_value;
+}
+
+}  // namespace
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+CvInputsStatus CvInputs::Start() {
+  CvInputsStatus return_value = CvInputsStatus::kError;
+
+  // the GPIO reset state of PA0 .. PA3 is analog mode already
+  __HAL_RCC_ADC_CLK_ENABLE();
+  ADC12_COMMON->CCR = ADC_CCR_CKMODE_1;  // HCLK / 2, any AHB prescaler
+  ADC1->CR = ADC1->CR & ~ADC_CR_DEEPPWD;
+  ADC1->CR = ADC1->CR | ADC_CR_ADVREGEN;
+  const uint32_t tick_start = HAL_GetTick();
+  while ((HAL_GetTick() - tick_start) < 2U) {
+    // regulator start-up takes 20 us, 2 ticks are at least 1 ms
+  }
+
+  ADC1->CR = ADC1->CR | ADC_CR_ADCAL;
+  const bool is_calibrated =
+      WaitFor([] { return (ADC1->CR & ADC_CR_ADCAL) == 0U; }, kTimeout_);
+
+  // continuous scan, circular DMA, an overrun overwrites the data register
+  ADC1->CFGR = ADC1->CFGR | ADC_CFGR_CONT | ADC_CFGR_OVRMOD |
+               ADC_CFGR_DMACFG | ADC_CFGR_DMAEN;
+  ADC1->CFGR2 = kOversampling;
+  uint32_t sequence = (kInputCount_ - 1U) << ADC_SQR1_L_Pos;
+  uint32_t sample_times = 0U;
+  for (uint32_t i = 0U; i < kInputCount_; ++i) {
+    sequence |= kChannels[i] << (ADC_SQR1_SQ1_Pos + (6U * i));
+    sample_times |= kSampleTime << (3U * kChannels[i]);
+  }
+  ADC1->SQR1 = sequence;
+  ADC1->SMPR1 = sample_times;
+
+  // DMA1 channel 1 with request 0 is ADC1, 16-bit transfers
+  DMA1_Channel1->CCR = 0U;
+  DMA1_CSELR->CSELR = DMA1_CSELR->CSELR & ~DMA_CSELR_C1S;
+  DMA1_Channel1->CPAR =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&ADC1->DR));
+  DMA1_Channel1->CMAR =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(dma_buffer_));
+  DMA1_Channel1->CNDTR = kInputCount_;
+  DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PSIZE_0 |
+                       DMA_CCR_MSIZE_0 | DMA_CCR_EN;
+
+  ADC1->ISR = ADC_ISR_ADRDY;  // cleared by writing 1
+  ADC1->CR = ADC1->CR | ADC_CR_ADEN;
+  const bool is_ready =
+      WaitFor([] { return (ADC1->ISR & ADC_ISR_ADRDY) != 0U; }, kTimeout_);
+  if (is_calibrated && is_ready) {
+    ADC1->CR = ADC1->CR | ADC_CR_ADSTART;
+    is_running_ = true;
+    return_value = CvInputsStatus::kSuccess;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void CvInputs::ProcessTick() {
+  if (is_running_) {
+    for (uint32_t i = 0U; i < kInputCount_; ++i) {
+      // one halfword per input, DMA never leaves a torn value
+      const int32_t target = static_cast<int32_t>(dma_buffer_[i])
+                             << kFractionBits_;
+      const int32_t state = static_cast<int32_t>(states_[i]);
+      states_[i] = static_cast<uint32_t>(
+          state + ((target - state) >> kSmoothingShift_));
+      uint32_t parameter = states_[i] >> kFractionBits_;
+      // spread and probability fall with a rising CV, 0 V is neutral
+      if ((i == static_cast<uint32_t>(CvParameter::kSpread)) ||
+          (i == static_cast<uint32_t>(CvParameter::kProbability))) {
+        parameter = 0xFFFFU - parameter;
+      }
+      parameters_[i] = static_cast<uint16_t>(parameter);
+    }
+  }
+}
+
+}  // namespace tkrandom
@@ -0,0 +1,26 @@
+//! \brief     Class definition for measuring CPU cycles.
+//! \details   Uses the DWT cycle counter of the Cortex-M4 core.
+//! \file      cycle_counter.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "cycle_counter.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void CycleCounter::Enable() {
+  if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+}
+
+}  // namespace tkrandom
@@ -16,134 +16,243 @@
 namespace tkrandom {
 
 // MEMBER FUNCTIONS ------------------------------------------------------------
-EventHandler::EventHandler(PcbStatusLed& pcb_status_led,
-                           RngHandler& rng_handler,
-                           Animation& animation,
-                           DistributionPins& distribution_pins)
-    : state_(EventHandlerState::kAnimation),
-      pcbStatusLed_(pcb_status_led),
-      rng_handler_(rng_handler),
-      animation_(animation),
-      distribution_pins_(distribution_pins),
-      has_timer_elapsed_(false),
-      has_error_occurred_(false),
-      has_distribution_changed_(false),
-      is_gate_1_(false),
-      is_gate_2_(false),
-      debounce_counter_(0U),
-      kDebounceDelay_(1U) {
-
-}
-//------------------------------------------------------------------------------
 void EventHandler::Run() {
-  // processes gate inputs
-  if (state_ == EventHandlerState::kWorking) {
-    if (is_gate_1_ || is_gate_2_) {
-      const RngHandlerStatus rng_handler_status =
-          rng_handler_.SetOutputsLeds(is_gate_1_, is_gate_2_);
-      if (rng_handler_status != RngHandlerStatus::kSuccess) {
-        HandleError();
-      }
-      is_gate_1_ = false;
-      is_gate_2_ = false;
+  // gate inputs are processed by ProcessGates() in PendSV
+  // applies switch changes reported by the debouncer
+  if (has_distribution_changed_) {
+    has_distribution_changed_ = false;
+    ProcessDistribution();
+  }
+  // renders noise samples ahead of the sample timer interrupt
+  if (noise_handler_.IsStreaming()) {
+    if (noise_handler_.FillSamples() != NoiseHandlerStatus::kSuccess) {
+      HandleError(Fault::kRng);
     }
   }
-  // timer based event processing
-  if (has_timer_elapsed_) {
-    pcbStatusLed_.ProcessTick();
-    rng_handler_.ProcessTick();
-    if (has_distribution_changed_) {
-      ProcessDistribution();  // timer based processing for switch debouncing
+  // periodic work, preempted by the gate work at any point
+  scheduler_.RunNext();
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void EventHandler::ProcessGates() {
+  // takes over the captured edges, new edges pend PendSV again
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  const bool is_gate_1 = is_gate_1_;
+  const bool is_gate_2 = is_gate_2_;
+  is_gate_1_ = false;
+  is_gate_2_ = false;
+  __set_PRIMASK(primask);
+
+  if (is_gate_1 || is_gate_2) {
+    TKRANDOM_PROBE(kDispatch);
+    const RngHandlerStatus rng_handler_status =
+        rng_handler_.SetOutputsLeds(is_gate_1, is_gate_2);
+    gate_path_cycles_ = CycleCounter::Since(gate_timestamp_);
+    TKRANDOM_PROBE_STOP();
+    if (rng_handler_status == RngHandlerStatus::kErrorTransfer) {
+      HandleError(Fault::kTransfer);
     }
-    if (state_ == EventHandlerState::kAnimation) {
-      const AnimationStatus animation_status = animation_.ClockAnimation();
-      if (animation_status == AnimationStatus::kCompleted) {
-        state_ = EventHandlerState::kWorking;
-      }
-      if (animation_status == AnimationStatus::kError) {
-        HandleError();
-      }
+    if (rng_handler_status == RngHandlerStatus::kErrorRng) {
+      HandleError(Fault::kRng);
     }
-    has_timer_elapsed_ = false;
-  }
-  // error handling
-  if (has_error_occurred_) {
-    HandleError();
-    has_error_occurred_ = false;
   }
+  ProcessTracking();
 }
 //------------------------------------------------------------------------------
 void EventHandler::Init() {
   rng_handler_.Init();
+  switch_debouncer_.Init();
   has_distribution_changed_ = true;  // triggers ProcessDistribution()
+
+  // gates are processed from now on, the animation only owns the LEDs
+  animation_.Start(kStartAnimation);
+
+  // the RNG reset rate is tuned to 16 Hz, the animation runs at
+  // the LED refresh rate and ahead of the refresh by its priority
+  const bool is_registered =
+      (scheduler_.AddTask(&EventHandler::AnimationTask, this,
+                          LedRefresher::kRefreshRate, 0U,
+                          kAnimationBudget_) == SchedulerStatus::kSuccess) &&
+      (scheduler_.AddTask(&EventHandler::RngTickTask, this, 16U, 1U,
+                          kRngTickBudget_) == SchedulerStatus::kSuccess) &&
+      (scheduler_.AddTask(&EventHandler::LedRefreshTask, this,
+                          LedRefresher::kRefreshRate, 3U,
+                          kLedRefreshBudget_) == SchedulerStatus::kSuccess);
+  if (!is_registered) {
+    HandleError(Fault::kGeneral);
+  }
+}
+//------------------------------------------------------------------------------
+void EventHandler::SetHoldModes(const HoldMode gate_1_mode,
+                                const HoldMode gate_2_mode) {
+  hold_mode_1_ = gate_1_mode;
+  hold_mode_2_ = gate_2_mode;
+}
+//------------------------------------------------------------------------------
+uint32_t EventHandler::GetGatePathCycles() const {
+  return gate_path_cycles_;
+}
+//------------------------------------------------------------------------------
+GateStatistics EventHandler::GetGateStatistics() const {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  const GateStatistics statistics = gate_statistics_;
+  __set_PRIMASK(primask);
+  return statistics;
+}
+//------------------------------------------------------------------------------
+void EventHandler::ResetGateStatistics() {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  gate_statistics_ = {0U, 0U};
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+void EventHandler::SetTrackRate(const uint32_t rate) {
+  uint32_t limited_rate = rate;
+  if (limited_rate < kMinTrackRate_) {
+    limited_rate = kMinTrackRate_;
+  }
+  if (limited_rate > kMaxTrackRate_) {
+    limited_rate = kMaxTrackRate_;
+  }
+  // preloaded auto-reload register, takes effect with the next update event
+  __HAL_TIM_SET_AUTORELOAD(track_timer_handle_,
+                           (kTrackTimerClock_ / limited_rate) - 1U);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void EventHandler::ProcessTracking() {
+  const bool is_tracking_1 =
+      is_gate_1_open_ && (hold_mode_1_ == HoldMode::kTrackAndHold);
+  const bool is_tracking_2 =
+      is_gate_2_open_ && (hold_mode_2_ == HoldMode::kTrackAndHold);
+  const bool is_tracking = is_tracking_1 || is_tracking_2;
+
+  // the timer only runs while needed, closing edges freeze the outputs
+  if (is_tracking && !is_track_timer_running_) {
+    has_track_tick_ = false;
+    __HAL_TIM_SET_COUNTER(track_timer_handle_, 0U);
+    if (HAL_TIM_Base_Start_IT(track_timer_handle_) == HAL_OK) {
+      is_track_timer_running_ = true;
+    }
+    else {
+      HandleError(Fault::kGeneral);
+    }
+  }
+  if (!is_tracking && is_track_timer_running_) {
+    HAL_TIM_Base_Stop_IT(track_timer_handle_);
+    is_track_timer_running_ = false;
+  }
+  if (has_track_tick_) {
+    has_track_tick_ = false;
+    if (is_tracking) {
+      const RngHandlerStatus rng_handler_status =
+          rng_handler_.TrackOutputsLeds(is_tracking_1, is_tracking_2);
+      if (rng_handler_status == RngHandlerStatus::kErrorTransfer) {
+        HandleError(Fault::kTransfer);
+      }
+      if (rng_handler_status == RngHandlerStatus::kErrorRng) {
+        HandleError(Fault::kRng);
+      }
+    }
+  }
 }
 //------------------------------------------------------------------------------
 void EventHandler::ProcessDistribution() {
-  // debounces distribution switches
-  if (debounce_counter_ > kDebounceDelay_) {
-    has_distribution_changed_ = false;
-    debounce_counter_ = 0U;
-    Distribution distribution_1 = Distribution::kUniform;
-    Distribution distribution_2 = Distribution::kUniform;
-    Distribution distribution_3 = Distribution::kUniform;
-    Distribution distribution_4 = Distribution::kUniform;
-    const GPIO_PinState pin_distr_1 =
-        HAL_GPIO_ReadPin(distribution_pins_.gpio_port_distribution_1,
-                         distribution_pins_.pin_distribution_1);
-    const GPIO_PinState pin_distr_2 =
-        HAL_GPIO_ReadPin(distribution_pins_.gpio_port_distribution_2,
-                         distribution_pins_.pin_distribution_2);
-    const GPIO_PinState pin_distr_3 =
-        HAL_GPIO_ReadPin(distribution_pins_.gpio_port_distribution_3,
-                         distribution_pins_.pin_distribution_3);
-    const GPIO_PinState pin_distr_4 =
-        HAL_GPIO_ReadPin(distribution_pins_.gpio_port_distribution_4,
-                         distribution_pins_.pin_distribution_4);
-    if (pin_distr_1 == GPIO_PIN_SET) {
-      distribution_1 = Distribution::kNormal;
+  // bit 0 is the switch of output 1
+  const uint32_t switches = switch_debouncer_.GetState();
+  uint8_t output = static_cast<uint8_t>(Output::kOutput1);
+  while (output <= static_cast<uint8_t>(Output::kOutput4)) {
+    Distribution distribution = Distribution::kUniform;
+    if ((switches & (1U << output)) != 0U) {
+      distribution = Distribution::kNormal;
     }
-    if (pin_distr_2 == GPIO_PIN_SET) {
-          distribution_2 = Distribution::kNormal;
-        }
-    if (pin_distr_3 == GPIO_PIN_SET) {
-          distribution_3 = Distribution::kNormal;
-        }
-    if (pin_distr_4 == GPIO_PIN_SET) {
-          distribution_4 = Distribution::kNormal;
-        }
-    rng_handler_.SetDistribution(Output::kOutput1, distribution_1);
-    rng_handler_.SetDistribution(Output::kOutput2, distribution_2);
-    rng_handler_.SetDistribution(Output::kOutput3, distribution_3);
-    rng_handler_.SetDistribution(Output::kOutput4, distribution_4);
+    rng_handler_.SetDistribution(static_cast<Output>(output), distribution);
+    output++;
   }
-  debounce_counter_++;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 void EventHandler::SignalEvent(const Event event) {
   switch (event) {
-    case Event::kDistributionChanged:
-      has_distribution_changed_ = true;
-      break;
-    case Event::kErrorOccurred:
-      has_error_occurred_ = true;
-      break;
     case Event::kGate1Triggered:
-      is_gate_1_ = true;
+      TKRANDOM_PROBE_START();
+      TraceLog::Log(TraceEvent::kGate1Open, 0U);
+      gate_timestamp_ = CycleCounter::Now();
+      gate_statistics_.captured++;
+      if (is_gate_1_) {
+        gate_statistics_.merged++;  // previous edge not processed yet
+      }
+      is_gate_1_ = true;  // the opening edge samples in both hold modes
+      is_gate_1_open_ = true;
+      InterruptTiers::PendGateWork();
       break;
     case Event::kGate2Triggered:
+      TKRANDOM_PROBE_START();
+      TraceLog::Log(TraceEvent::kGate2Open, 0U);
+      gate_timestamp_ = CycleCounter::Now();
+      gate_statistics_.captured++;
+      if (is_gate_2_) {
+        gate_statistics_.merged++;  // previous edge not processed yet
+      }
       is_gate_2_ = true;
+      is_gate_2_open_ = true;
+      InterruptTiers::PendGateWork();
+      break;
+    case Event::kGate1Released:
+      if (!is_gate_1_open_) {
+        // a pulse shorter than the interrupt entry has closed again when the
+        // handler reads the level, the opening edge is sampled here
+        SignalEvent(Event::kGate1Triggered);
+      }
+      TraceLog::Log(TraceEvent::kGate1Close, 0U);
+      is_gate_1_open_ = false;
+      InterruptTiers::PendGateWork();
+      break;
+    case Event::kGate2Released:
+      if (!is_gate_2_open_) {
+        SignalEvent(Event::kGate2Triggered);
+      }
+      TraceLog::Log(TraceEvent::kGate2Close, 0U);
+      is_gate_2_open_ = false;
+      InterruptTiers::PendGateWork();
+      break;
+    case Event::kTrackTick:
+      has_track_tick_ = true;
+      InterruptTiers::PendGateWork();
       break;
     case Event::kTimerElapsed:
-      has_timer_elapsed_ = true;
+      if (switch_debouncer_.ProcessSample()) {
+        has_distribution_changed_ = true;
+      }
+      scheduler_.ProcessTick();
       break;
     default:
       break;
   }
 }
 //------------------------------------------------------------------------------
-void EventHandler::HandleError() {
-  pcbStatusLed_.SetLedMode(PcbStatusLedMode::kErrorMode);
-  // TODO: any proper error handling
+void EventHandler::AnimationTask(void* const context) {
+  static_cast<EventHandler*>(context)->animation_.ProcessTick(
+      1000U / LedRefresher::kRefreshRate);
+}
+//------------------------------------------------------------------------------
+void EventHandler::RngTickTask(void* const context) {
+  // the RNG reset must not interleave with the gate work
+  const uint32_t basepri = InterruptTiers::MaskGateWork();
+  static_cast<EventHandler*>(context)->rng_handler_.ProcessTick();
+  InterruptTiers::UnmaskGateWork(basepri);
+}
+//------------------------------------------------------------------------------
+void EventHandler::LedRefreshTask(void* const context) {
+  static_cast<EventHandler*>(context)->rng_handler_.RefreshLeds();
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void EventHandler::HandleError(const Fault fault) {
+  supervisor_.ReportFault(fault);
 }
 
 }  // namespace tkrandom
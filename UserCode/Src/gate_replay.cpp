@@ -0,0 +1,122 @@
+//! \brief     Class definition for replaying gate scenarios on the target.
+//! \details   Signals the edges of the reference GateScenario traces to the
+//!            EventHandler and collects gate counters and DWT latencies.
+//! \file      gate_replay.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "gate_replay.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void GateReplay::Start(const uint32_t rate, const uint32_t gate_count,
+                       const uint32_t core_clock) {
+  rate_ = rate;
+  gate_count_ = gate_count;
+  core_clock_ = core_clock;
+  for (GateReplayResult& result : results_) {
+    result = {};
+  }
+  CycleCounter::Enable();
+  last_cycles_ = CycleCounter::Now();
+  now_ = 0U;
+  scenario_index_ = 0U;
+  StartScenario();
+  // gates are processed during the LED start animation, only the switches
+  // need some ms to settle
+  origin_ += core_clock_ / 10U;
+}
+//------------------------------------------------------------------------------
+void GateReplay::Process() {
+  if (scenario_index_ < kGateScenarioCount) {
+    UpdateTime();
+    while (has_edge_ && (now_ >= origin_) &&
+           ((now_ - origin_) >= edge_.cycle)) {
+      Signal(edge_);
+      has_edge_ = scenario_.Next(&edge_);
+    }
+    if ((!has_edge_) && ((now_ - origin_) >= end_)) {
+      GateReplayResult& result = results_[scenario_index_];
+      result.gates = event_handler_.GetGateStatistics();
+      LatencyProbes::GetStatistics(LatencyStage::kGatePath,
+                                   &result.gate_path);
+      scenario_index_++;
+      if (scenario_index_ < kGateScenarioCount) {
+        StartScenario();
+      }
+    }
+  }
+}
+//------------------------------------------------------------------------------
+bool GateReplay::IsRunning() const {
+  return scenario_index_ < kGateScenarioCount;
+}
+//------------------------------------------------------------------------------
+const GateReplayResult& GateReplay::GetResult(const uint32_t scenario) const {
+  uint32_t index = scenario;
+  if (index >= kGateScenarioCount) {
+    index = kGateScenarioCount - 1U;
+  }
+  return results_[index];
+}
+//------------------------------------------------------------------------------
+void GateReplay::StartScenario() {
+  GateScenarioConfig config = kGateScenarios[scenario_index_];
+  config.rate = rate_;
+  config.gate_count = gate_count_;
+  scenario_.Init(config, core_clock_);
+
+  // the last gate is evaluated 1 ms after its period
+  GateEdge edge = {0U, 0U, false};
+  end_ = 0U;
+  while (scenario_.Next(&edge)) {
+    end_ = edge.cycle;
+  }
+  end_ += (core_clock_ / rate_) + (core_clock_ / 1000U);
+  scenario_.Init(config, core_clock_);
+  has_edge_ = scenario_.Next(&edge_);
+
+  event_handler_.ResetGateStatistics();
+  LatencyProbes::Reset();
+  UpdateTime();
+  origin_ = now_;
+}
+//------------------------------------------------------------------------------
+void GateReplay::UpdateTime() {
+  const uint32_t cycles = CycleCounter::Now();
+  now_ += cycles - last_cycles_;
+  last_cycles_ = cycles;
+}
+//------------------------------------------------------------------------------
+void GateReplay::Signal(const GateEdge& edge) {
+  Event event = Event::kGate1Released;
+  if (edge.input == 1U) {
+    event = edge.is_open ? Event::kGate1Triggered : Event::kGate1Released;
+  }
+  else {
+    event = edge.is_open ? Event::kGate2Triggered : Event::kGate2Released;
+  }
+  if (edge.is_open) {
+    results_[scenario_index_].injected++;
+  }
+  // the EXTI handler of a short pulse reads the closed level only
+  const bool is_seen =
+      (!edge.is_open) ||
+      (kGateScenarios[scenario_index_].pattern != GatePattern::kShort);
+  if (is_seen) {
+    // interrupt context of the EXTI callback, the gate work follows in PendSV
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    event_handler_.SignalEvent(event);
+    __set_PRIMASK(primask);
+  }
+}
+
+}  // namespace tkrandom
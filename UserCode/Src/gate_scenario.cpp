@@ -0,0 +1,114 @@
+//! \brief     Class definition for synthetic gate traces.
+//! \details   Deterministic edge sequences of steady, burst, jittered and
+//!            dual-input clocks, shared by the host benchmark and GateReplay.
+//! \file      gate_scenario.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "gate_scenario.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void GateScenario::Init(const GateScenarioConfig& config,
+                        const uint32_t core_clock) {
+  config_ = config;
+  if (config_.duty < 1U) {
+    config_.duty = 1U;
+  }
+  if (config_.duty > 99U) {
+    config_.duty = 99U;
+  }
+  if (config_.jitter > (100U - config_.duty)) {
+    config_.jitter = static_cast<uint8_t>(100U - config_.duty);
+  }
+  if (config_.phase > (100U - config_.duty)) {
+    config_.phase = static_cast<uint8_t>(100U - config_.duty);
+  }
+  if (config_.burst_length == 0U) {
+    config_.burst_length = 1U;
+  }
+  period_ = 0U;
+  if (config_.rate > 0U) {
+    period_ = core_clock / config_.rate;
+  }
+  gate_ = 0U;
+  pending_count_ = 0U;
+  pending_index_ = 0U;
+  random_state_ = kSeed_;
+}
+//------------------------------------------------------------------------------
+bool GateScenario::Next(GateEdge* const edge) {
+  bool return_value = false;
+
+  if ((pending_index_ >= pending_count_) && (gate_ < config_.gate_count) &&
+      (period_ > 0U)) {
+    GenerateSlot();
+  }
+  if (pending_index_ < pending_count_) {
+    *edge = pending_[pending_index_];
+    pending_index_++;
+    return_value = true;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t GateScenario::GetGateCount() const {
+  uint32_t return_value = config_.gate_count;
+  if (config_.pattern == GatePattern::kDual) {
+    return_value = 2U * config_.gate_count;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void GateScenario::GenerateSlot() {
+  uint64_t slot = gate_;
+  if (config_.pattern == GatePattern::kBurst) {
+    slot += static_cast<uint64_t>(gate_ / config_.burst_length) *
+            config_.burst_pause;
+  }
+  const uint64_t start = slot * period_;
+  uint64_t length = (period_ * config_.duty) / 100U;
+  if (config_.pattern == GatePattern::kShort) {
+    length = kShortPulseCycles;
+  }
+  uint64_t delay = 0U;
+  if (config_.pattern == GatePattern::kJitter) {
+    random_state_ ^= random_state_ << 13U;
+    random_state_ ^= random_state_ >> 17U;
+    random_state_ ^= random_state_ << 5U;
+    const uint64_t range = (period_ * config_.jitter) / 100U;
+    delay = (range > 0U) ? (random_state_ % (range + 1U)) : 0U;
+  }
+
+  pending_[0U] = {start + delay, 1U, true};
+  pending_[1U] = {start + delay + length, 1U, false};
+  pending_count_ = 2U;
+  if (config_.pattern == GatePattern::kDual) {
+    const uint64_t phase = (period_ * config_.phase) / 100U;
+    pending_[2U] = {start + phase, 2U, true};
+    pending_[3U] = {start + phase + length, 2U, false};
+    pending_count_ = 4U;
+    // insertion sort, IN_1 first at equal times
+    for (uint32_t i = 1U; i < pending_count_; ++i) {
+      const GateEdge edge = pending_[i];
+      uint32_t j = i;
+      while ((j > 0U) && (pending_[j - 1U].cycle > edge.cycle)) {
+        pending_[j] = pending_[j - 1U];
+        j--;
+      }
+      pending_[j] = edge;
+    }
+  }
+  pending_index_ = 0U;
+  gate_++;
+}
+
+}  // namespace tkrandom
@@ -14,27 +14,39 @@
 // MICS ------------------------------------------------------------------------
 namespace tkrandom {
 
-// MEMBER FUNCTIONS ------------------------------------------------------------
-Generator::Generator(RNG_HandleTypeDef* const random_handle)
-    : random_handle_(random_handle) {
+namespace {
 
+//! halving add of the two 16-bit lanes of a and b: ((a + b) >> 1) per lane
+//! \details no carry between the lanes, so the 17-bit lane sums never overflow
+TKRANDOM_INLINE uint32_t HalvingAdd16(const uint32_t a, const uint32_t b) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+  return __UHADD16(a, b);
+#else
+  const uint32_t low = ((a & 0xffffU) + (b & 0xffffU)) >> 1U;
+  const uint32_t high = ((a >> 16U) + (b >> 16U)) >> 1U;
+  return (high << 16U) | low;
+#endif
 }
-//------------------------------------------------------------------------------
+
+//! SplitMix64 output function
+TKRANDOM_INLINE uint64_t Mix(uint64_t z) {
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9U;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBU;
+  return z ^ (z >> 31U);
+}
+
+}  // namespace
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+TKRANDOM_RAM_CODE
 GeneratorStatus Generator::GetUniformRandomNumber(uint16_t* number) const {
-  GeneratorStatus return_value = GeneratorStatus::kSuccess;
   uint32_t rng_number = 0U;
-  const HAL_StatusTypeDef hal_status =
-      HAL_RNG_GenerateRandomNumber(random_handle_, &rng_number);
-  if (hal_status == HAL_OK) {
-    *number = static_cast<uint16_t>(rng_number);
-  }
-  else {
-    *number = 0U;
-    return_value = GeneratorStatus::kError;
-  }
+  const GeneratorStatus return_value = GenerateWord(&rng_number);
+  *number = static_cast<uint16_t>(rng_number);
   return return_value;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 GeneratorStatus Generator::GetNormalRandomNumber(uint16_t* number) const {
   GeneratorStatus return_value = GeneratorStatus::kSuccess;
   uint32_t rng_number = 0U;
@@ -44,9 +56,7 @@ GeneratorStatus Generator::GetNormalRandomNumber(uint16_t* number) const {
   // with musically reasonable result (high standard deviation):
   // divides the sum of 4 uniform random numbers by 4
   for (uint8_t i = 0U; i < 2U; ++i) {
-    const HAL_StatusTypeDef hal_status =
-        HAL_RNG_GenerateRandomNumber(random_handle_, &rng_number);
-    if (hal_status == HAL_OK) {
+    if (GenerateWord(&rng_number) == GeneratorStatus::kSuccess) {
       sum += static_cast<uint16_t>(rng_number);
       sum += static_cast<uint16_t>(rng_number >> 16U);
     }
@@ -61,9 +71,146 @@ GeneratorStatus Generator::GetNormalRandomNumber(uint16_t* number) const {
   return return_value;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+GeneratorStatus Generator::GetRandomWord(uint32_t* word) const {
+  return ReadWord(word);  // called at audio rate, so without HAL overhead
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+GeneratorStatus Generator::Fill(uint16_t* const samples, const size_t count,
+                                const Distribution distribution) const {
+  GeneratorStatus return_value = GeneratorStatus::kSuccess;
+  size_t index = 0U;
+  uint32_t words[4] = {0U, 0U, 0U, 0U};
+
+  if (distribution == Distribution::kNormal) {
+    // two samples per iteration: each 16-bit lane averages the same lane of
+    // four random words, i.e. the sum of 4 uniform numbers divided by 4 as
+    // in GetNormalRandomNumber(), computed for both lanes at once
+    while ((index + 1U < count) && (return_value == GeneratorStatus::kSuccess)) {
+      for (uint32_t i = 0U; i < 4U; ++i) {
+        if (ReadWord(&words[i]) != GeneratorStatus::kSuccess) {
+          return_value = GeneratorStatus::kError;
+        }
+      }
+      if (return_value == GeneratorStatus::kSuccess) {
+        const uint32_t pair = HalvingAdd16(HalvingAdd16(words[0], words[1]),
+                                           HalvingAdd16(words[2], words[3]));
+        samples[index] = static_cast<uint16_t>(pair);
+        samples[index + 1U] = static_cast<uint16_t>(pair >> 16U);
+        index += 2U;
+      }
+    }
+    // odd block size: last sample from both lanes of two words
+    if ((index < count) && (return_value == GeneratorStatus::kSuccess)) {
+      uint16_t number = 0U;
+      return_value = GetNormalRandomNumber(&number);
+      samples[index] = number;
+      index++;
+    }
+  }
+  else {
+    // two samples per random word
+    while ((index < count) && (return_value == GeneratorStatus::kSuccess)) {
+      if (ReadWord(&words[0]) == GeneratorStatus::kSuccess) {
+        samples[index] = static_cast<uint16_t>(words[0]);
+        index++;
+        if (index < count) {
+          samples[index] = static_cast<uint16_t>(words[0] >> 16U);
+          index++;
+        }
+      }
+      else {
+        return_value = GeneratorStatus::kError;
+      }
+    }
+  }
+  // samples that could not be generated are set to 0U like the single getters
+  while (index < count) {
+    samples[index] = 0U;
+    index++;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+GeneratorStatus Generator::ReadWord(uint32_t* word) const {
+  GeneratorStatus return_value = GeneratorStatus::kError;
+  RNG_TypeDef* const rng = random_handle_->Instance;
+  uint32_t polls = 0U;
+
+  if (seed_ != 0U) {
+    *word = NextSeededWord();
+    return_value = GeneratorStatus::kSuccess;
+  }
+  else {
+    *word = 0U;
+    // the gate work must not take the word between DRDY and DR
+    const uint32_t basepri = InterruptTiers::MaskGateWork();
+    while (polls < kReadyTimeout_) {
+      const uint32_t status = rng->SR;
+      if ((status & (RNG_SR_SECS | RNG_SR_CECS)) != 0U) {
+        TraceLog::Log(TraceEvent::kRngError, status);
+        break;  // seed or clock error, recovered by ResetRng()
+      }
+      if ((status & RNG_SR_DRDY) != 0U) {
+        *word = rng->DR;
+        return_value = GeneratorStatus::kSuccess;
+        break;
+      }
+      polls++;
+    }
+    InterruptTiers::UnmaskGateWork(basepri);
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
 void Generator::ResetRng() {
   HAL_RNG_DeInit(random_handle_);
   HAL_RNG_Init(random_handle_);
 }
+//------------------------------------------------------------------------------
+bool Generator::IsWordReady() const {
+  return (seed_ != 0U) ||
+         ((random_handle_->Instance->SR & RNG_SR_DRDY) != 0U);
+}
+//------------------------------------------------------------------------------
+void Generator::SetSeed(const uint16_t seed) {
+  seed_ = seed;
+  key_ = Mix(static_cast<uint64_t>(seed) * kGoldenGamma_);
+  counter_ = 0U;
+}
+//------------------------------------------------------------------------------
+uint16_t Generator::GetSeed() const {
+  return seed_;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+GeneratorStatus Generator::GenerateWord(uint32_t* word) const {
+  GeneratorStatus return_value = GeneratorStatus::kSuccess;
+
+  if (seed_ != 0U) {
+    *word = NextSeededWord();
+  }
+  else if (HAL_RNG_GenerateRandomNumber(random_handle_, word) != HAL_OK) {
+    *word = 0U;
+    return_value = GeneratorStatus::kError;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+uint32_t Generator::NextSeededWord() const {
+  // one counter value per word, also if the audio interrupt preempts
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  const uint64_t counter = counter_;
+  counter_ = counter + 1U;
+  __set_PRIMASK(primask);
+  return static_cast<uint32_t>(Mix(key_ + ((counter + 1U) * kGoldenGamma_)) >>
+                               32U);
+}
 
 }  // namespace tkrandom
@@ -0,0 +1,45 @@
+//! \brief     Class definition for the gate-to-output latency probes.
+//! \details   Optional DWT cycle counter probes with min/max/mean and log2
+//!            histograms per stage of the gate path.
+//! \file      latency_probes.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "latency_probes.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+volatile uint32_t LatencyProbes::start_ = 0U;
+volatile bool LatencyProbes::is_armed_ = false;
+LatencyStatistics LatencyProbes::statistics_[kStageCount_] = {
+    {0xFFFFFFFFU, 0U, 0U, 0U, {}},
+    {0xFFFFFFFFU, 0U, 0U, 0U, {}},
+    {0xFFFFFFFFU, 0U, 0U, 0U, {}},
+    {0xFFFFFFFFU, 0U, 0U, 0U, {}}};
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void LatencyProbes::Reset() {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  for (uint32_t stage = 0U; stage < kStageCount_; ++stage) {
+    statistics_[stage] = {0xFFFFFFFFU, 0U, 0U, 0U, {}};
+  }
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+void LatencyProbes::GetStatistics(const LatencyStage stage,
+                                  LatencyStatistics* const statistics) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *statistics = statistics_[static_cast<uint32_t>(stage)];
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
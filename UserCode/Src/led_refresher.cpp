@@ -0,0 +1,85 @@
+//! \brief     Class definition for the rate-limited front panel LED refresh.
+//! \details   Keeps the LED brightness as shadow state that the gate work
+//!            writes and a periodic task sends to the DAC.
+//! \file      led_refresher.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "led_refresher.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void LedRefresher::SetBrightness(const Led led, const uint16_t value) {
+  const uint32_t index =
+      static_cast<uint32_t>(led) - static_cast<uint32_t>(Led::kLed1);
+  if (index < kLedCount_) {
+    shadow_[index] = value;
+    updated_leds_ = updated_leds_ | static_cast<uint8_t>(1U << index);
+  }
+}
+//------------------------------------------------------------------------------
+void LedRefresher::ProcessTick() {
+  uint16_t shadow[kLedCount_];
+
+  // takes over the values of the gate work in one piece
+  const uint32_t basepri = InterruptTiers::MaskGateWork();
+  const uint8_t updated_leds = updated_leds_;
+  updated_leds_ = 0U;
+  for (uint32_t i = 0U; i < kLedCount_; ++i) {
+    shadow[i] = shadow_[i];
+  }
+  InterruptTiers::UnmaskGateWork(basepri);
+
+  for (uint32_t i = 0U; i < kLedCount_; ++i) {
+    if (is_overlay_active_) {
+      displayed_[i] = overlay_[i];
+    }
+    else if ((updated_leds & (1U << i)) != 0U) {
+      displayed_[i] = shadow[i];
+    }
+    else if (decay_shift_ > 0U) {
+      const uint16_t step = displayed_[i] >> decay_shift_;
+      displayed_[i] = (step > 0U) ? (displayed_[i] - step) : 0U;
+    }
+    if (displayed_[i] != sent_[i]) {
+      const Led led = static_cast<Led>(static_cast<uint32_t>(Led::kLed1) + i);
+      if (transmitter_.QueueLedBrightness(led, displayed_[i]) ==
+          TransmitterStatus::kSuccess) {
+        sent_[i] = displayed_[i];
+      }
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void LedRefresher::SetOverlay(const Led led, const uint16_t value) {
+  const uint32_t index =
+      static_cast<uint32_t>(led) - static_cast<uint32_t>(Led::kLed1);
+  if (index < kLedCount_) {
+    overlay_[index] = value;
+    is_overlay_active_ = true;
+  }
+}
+//------------------------------------------------------------------------------
+void LedRefresher::ReleaseOverlay() {
+  if (is_overlay_active_) {
+    is_overlay_active_ = false;
+    // the next refresh shows the values the gate work set meanwhile
+    const uint32_t basepri = InterruptTiers::MaskGateWork();
+    updated_leds_ = static_cast<uint8_t>((1U << kLedCount_) - 1U);
+    InterruptTiers::UnmaskGateWork(basepri);
+  }
+}
+//------------------------------------------------------------------------------
+void LedRefresher::SetDecay(const uint8_t shift) {
+  decay_shift_ = (shift > kMaxDecayShift_) ? kMaxDecayShift_ : shift;
+}
+
+}  // namespace tkrandom
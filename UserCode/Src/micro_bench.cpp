@@ -0,0 +1,192 @@
+//! \brief     Class definition for the microbenchmarks of the hot functions.
+//! \details   Calls each hot function of the gate path N times with the
+//!            interrupts masked and reports the clock ticks per call as JSON.
+//! \file      micro_bench.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "micro_bench.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+namespace {
+
+//! qualified names of the functions
+const char* const kFunctionNames[] = {
+    "Transmitter::SetLedBrightness", "Transmitter::TransmitValue",
+    "Generator::GetNormalRandomNumber", "RngHandler::FillBuffers",
+    "LedRefresher::ProcessTick"};
+
+//! appends a string, counts characters beyond the buffer for the length
+void Append(char* const text, const uint32_t size, uint32_t* const length,
+            const char* string) {
+  while (*string != '\0') {
+    if ((*length + 1U) < size) {
+      text[*length] = *string;
+    }
+    (*length)++;
+    string++;
+  }
+}
+
+//! appends an unsigned decimal number
+void Append(char* const text, const uint32_t size, uint32_t* const length,
+            uint64_t number) {
+  char digits[21];
+  uint32_t index = sizeof(digits) - 1U;
+  digits[index] = '\0';
+  do {
+    index--;
+    digits[index] = static_cast<char>('0' + (number % 10U));
+    number /= 10U;
+  } while (number > 0U);
+  Append(text, size, length, &digits[index]);
+}
+
+}  // namespace
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void MicroBench::Run(const uint32_t iterations) {
+  // overhead of the clock itself, the fastest of a few back-to-back reads
+  overhead_ = 0xFFFFFFFFU;
+  for (uint32_t i = 0U; i < 16U; ++i) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t start = clock_();
+    const uint32_t stop = clock_();
+    __set_PRIMASK(primask);
+    overhead_ = ((stop - start) < overhead_) ? (stop - start) : overhead_;
+  }
+
+  for (uint32_t function = 0U; function < kFunctionCount_; ++function) {
+    BenchResult& result = results_[function];
+    result = {0U, 0xFFFFFFFFU, 0U, 0U};
+    for (uint32_t i = 0U; i < iterations; ++i) {
+      // masked per call, so that the HAL tick keeps running in between
+      const uint32_t primask = __get_PRIMASK();
+      __disable_irq();
+      const uint32_t measured =
+          Measure(static_cast<BenchFunction>(function), i);
+      __set_PRIMASK(primask);
+      const uint32_t ticks =
+          (measured > overhead_) ? (measured - overhead_) : 0U;
+      result.calls++;
+      result.min = (ticks < result.min) ? ticks : result.min;
+      result.max = (ticks > result.max) ? ticks : result.max;
+      result.sum += ticks;
+    }
+  }
+
+  // fresh random buffers for the gate path
+  rng_handler_.index_uniform_ = 0U;
+  rng_handler_.index_normal_ = 0U;
+  rng_handler_.FillBuffers();
+}
+//------------------------------------------------------------------------------
+const BenchResult& MicroBench::GetResult(const BenchFunction function) const {
+  uint32_t index = static_cast<uint32_t>(function);
+  if (index >= kFunctionCount_) {
+    index = kFunctionCount_ - 1U;
+  }
+  return results_[index];
+}
+//------------------------------------------------------------------------------
+const char* MicroBench::GetName(const BenchFunction function) {
+  const char* return_value = "";
+  if (function < BenchFunction::kCount) {
+    return_value = kFunctionNames[static_cast<uint32_t>(function)];
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t MicroBench::WriteJson(char* const text, const uint32_t size) const {
+  uint32_t length = 0U;
+
+  Append(text, size, &length, "{\"clock_hz\":");
+  Append(text, size, &length, static_cast<uint64_t>(clock_rate_));
+  Append(text, size, &length, ",\"overhead\":");
+  Append(text, size, &length, static_cast<uint64_t>(overhead_));
+  Append(text, size, &length, ",\"results\":[");
+  for (uint32_t function = 0U; function < kFunctionCount_; ++function) {
+    const BenchResult& result = results_[function];
+    const uint64_t mean = (result.calls > 0U) ? (result.sum / result.calls)
+                                              : 0U;
+    Append(text, size, &length, (function > 0U) ? ",{" : "{");
+    Append(text, size, &length, "\"function\":\"");
+    Append(text, size, &length, kFunctionNames[function]);
+    Append(text, size, &length, "\",\"calls\":");
+    Append(text, size, &length, static_cast<uint64_t>(result.calls));
+    Append(text, size, &length, ",\"min\":");
+    Append(text, size, &length,
+           static_cast<uint64_t>((result.calls > 0U) ? result.min : 0U));
+    Append(text, size, &length, ",\"mean\":");
+    Append(text, size, &length, mean);
+    Append(text, size, &length, ",\"max\":");
+    Append(text, size, &length, static_cast<uint64_t>(result.max));
+    Append(text, size, &length, "}");
+  }
+  Append(text, size, &length, "]}");
+  if (size > 0U) {
+    text[(length < size) ? length : (size - 1U)] = '\0';
+  }
+
+  return length;
+}
+//------------------------------------------------------------------------------
+uint32_t MicroBench::Measure(const BenchFunction function,
+                             const uint32_t iteration) {
+  const uint16_t value = static_cast<uint16_t>(iteration * 40503U);
+  uint16_t number = 0U;
+  uint32_t start = 0U;
+  uint32_t stop = 0U;
+
+  switch (function) {
+    case BenchFunction::kSetLedBrightness:
+      start = clock_();
+      transmitter_.SetLedBrightness(Led::kLed1, value);
+      stop = clock_();
+      break;
+    case BenchFunction::kTransmitValue:
+      start = clock_();
+      transmitter_.TransmitValue(static_cast<uint8_t>(Output::kOutput1),
+                                 value);
+      stop = clock_();
+      break;
+    case BenchFunction::kGetNormalRandomNumber:
+      start = clock_();
+      generator_.GetNormalRandomNumber(&number);
+      stop = clock_();
+      break;
+    case BenchFunction::kFillBuffers:
+      // worst case: all numbers of both buffers consumed
+      rng_handler_.index_uniform_ = 0U;
+      rng_handler_.index_normal_ = 0U;
+      start = clock_();
+      rng_handler_.FillBuffers();
+      stop = clock_();
+      break;
+    case BenchFunction::kRefreshLeds:
+      // worst case: all LEDs set by the gate work since the last refresh
+      for (uint32_t i = 0U; i < 4U; ++i) {
+        rng_handler_.led_refresher_.SetBrightness(
+            static_cast<Led>(static_cast<uint32_t>(Led::kLed1) + i),
+            static_cast<uint16_t>(value + i));
+      }
+      start = clock_();
+      rng_handler_.led_refresher_.ProcessTick();
+      stop = clock_();
+      break;
+    default:
+      break;
+  }
+
+  return stop - start;
+}
+
+}  // namespace tkrandom
@@ -0,0 +1,149 @@
+//! \brief     Class definition for audio-rate noise streaming.
+//! \details   Streams white, pink or brown noise to one front panel output.
+//! \file      noise_handler.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "noise_handler.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void NoiseHandler::Start(const Output output, const NoiseColor color) {
+  Stop();
+  output_ = output;
+  color_ = color;
+  ResetFilters();
+  read_index_ = 0U;
+  write_index_ = 0U;
+  FillSamples();  // avoids underruns directly after the start
+  transmitter_.SetStreamedOutput(output_, true);
+  is_streaming_ = true;
+  HAL_TIM_Base_Start_IT(timer_handle_);
+}
+//------------------------------------------------------------------------------
+void NoiseHandler::Stop() {
+  HAL_TIM_Base_Stop_IT(timer_handle_);
+  is_streaming_ = false;
+  transmitter_.SetStreamedOutput(output_, false);
+}
+//------------------------------------------------------------------------------
+bool NoiseHandler::IsStreaming() const {
+  return is_streaming_;
+}
+//------------------------------------------------------------------------------
+NoiseHandlerStatus NoiseHandler::FillSamples() {
+  NoiseHandlerStatus return_value = NoiseHandlerStatus::kSuccess;
+
+  // each random word yields two white noise samples
+  while ((kRingSize_ - (write_index_ - read_index_)) >= 2U) {
+    uint32_t word = 0U;
+    if (generator_.GetRandomWord(&word) != GeneratorStatus::kSuccess) {
+      return_value = NoiseHandlerStatus::kErrorRng;
+      break;
+    }
+    const int32_t white_1 = static_cast<int16_t>(word);
+    const int32_t white_2 = static_cast<int16_t>(word >> 16U);
+    const uint32_t index = write_index_;
+    ring_[index & (kRingSize_ - 1U)] =
+        static_cast<uint16_t>(RenderSample(white_1) + 0x8000);
+    ring_[(index + 1U) & (kRingSize_ - 1U)] =
+        static_cast<uint16_t>(RenderSample(white_2) + 0x8000);
+    __COMPILER_BARRIER();  // samples are written before they are published
+    write_index_ = index + 2U;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void NoiseHandler::ProcessSampleTick() {
+  if (is_streaming_) {
+    const uint32_t index = read_index_;
+    if (index != write_index_) {
+      last_sample_ = ring_[index & (kRingSize_ - 1U)];
+      read_index_ = index + 1U;
+    }
+    else {
+      underrun_count_ = underrun_count_ + 1U;  // holds the last sample
+    }
+    transmitter_.StreamVoltage(output_, last_sample_);
+  }
+}
+//------------------------------------------------------------------------------
+int32_t NoiseHandler::RenderSample(const int32_t white) {
+  int32_t return_value = white;
+
+  switch (color_) {
+    case NoiseColor::kPink:
+      return_value = RenderPink(white);
+      break;
+    case NoiseColor::kBrown:
+      return_value = RenderBrown(white);
+      break;
+    case NoiseColor::kWhite:
+    default:
+      break;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+int32_t NoiseHandler::RenderPink(const int32_t white) {
+  // the number of trailing zeros of the counter selects the row, so row n is
+  // renewed every 2^(n+1) samples. The sentinel bit above the last row keeps
+  // the argument nonzero when the counter wraps after 2^32 samples.
+  pink_counter_++;
+  const uint32_t row = static_cast<uint32_t>(
+      __builtin_ctz(pink_counter_ | (1U << kPinkRows_)));
+  if (row < kPinkRows_) {
+    const int32_t new_value = white >> kPinkRowShift_;
+    pink_sum_ += new_value - pink_rows_[row];
+    pink_rows_[row] = new_value;
+  }
+  // the white sample itself adds the octave directly below the sample rate
+  int32_t sum = pink_sum_ + (white >> kPinkRowShift_);
+  if (sum > 32767) {
+    sum = 32767;
+  }
+  if (sum < -32768) {
+    sum = -32768;
+  }
+
+  return sum;
+}
+//------------------------------------------------------------------------------
+int32_t NoiseHandler::RenderBrown(const int32_t white) {
+  // y[n] = y[n-1] - y[n-1]/64 + x[n]/16, corner frequency ~120 Hz at 48 kHz
+  const int32_t kOne = 1 << kBrownFractionBits_;
+  brown_state_ = brown_state_ - (brown_state_ >> kBrownLeakShift_) +
+                 ((white * kOne) >> kBrownInputShift_);
+  int32_t sample = brown_state_ >> kBrownFractionBits_;
+  if (sample > 32767) {
+    sample = 32767;
+    brown_state_ = sample * kOne;
+  }
+  if (sample < -32768) {
+    sample = -32768;
+    brown_state_ = sample * kOne;
+  }
+
+  return sample;
+}
+//------------------------------------------------------------------------------
+void NoiseHandler::ResetFilters() {
+  for (uint32_t i = 0U; i < kPinkRows_; ++i) {
+    pink_rows_[i] = 0;
+  }
+  pink_sum_ = 0;
+  pink_counter_ = 0U;
+  brown_state_ = 0;
+}
+
+}  // namespace tkrandom
@@ -15,47 +15,37 @@
 namespace tkrandom {
 
 // MEMBER FUNCTIONS ------------------------------------------------------------
-PcbStatusLed::PcbStatusLed(GPIO_TypeDef* const gpio_port_led,
-                           const uint16_t pin_led)
-    : mode_(PcbStatusLedMode::kNormalMode),
-      tick_counter_(0U),
-      kErrorCount_(5U),
-      kNormalCountOn_(48U),
-      kNormalCountOff_(50U),
-      gpio_port_led_(gpio_port_led),
-      kPinLed_(pin_led) {
-}
-//------------------------------------------------------------------------------
 void PcbStatusLed::SetLedMode(const PcbStatusLedMode mode) {
+  if (mode != mode_) {
+    TraceLog::Log(TraceEvent::kLedMode, static_cast<uint32_t>(mode));
+  }
   mode_ = mode;
   if (mode_ == PcbStatusLedMode::kSwitchedOff) {
-    HAL_GPIO_WritePin(gpio_port_led_, kPinLed_, GPIO_PIN_RESET);
+    board::StatusLed::Reset();
   }
 }
 //------------------------------------------------------------------------------
-void PcbStatusLed::ProcessTick() {
-  switch (mode_) {
-    case PcbStatusLedMode::kNormalMode:
-      tick_counter_++;
-      if (tick_counter_ > kNormalCountOn_) {
-        HAL_GPIO_WritePin(gpio_port_led_, kPinLed_, GPIO_PIN_SET);
-      }
-      if (tick_counter_ > kNormalCountOff_) {
-        HAL_GPIO_WritePin(gpio_port_led_, kPinLed_, GPIO_PIN_RESET);
-        tick_counter_ = 0U;
-      }
-      break;
-    case PcbStatusLedMode::kErrorMode:
-      tick_counter_++;
-      if (tick_counter_ > kErrorCount_) {
-        HAL_GPIO_TogglePin(gpio_port_led_, kPinLed_);
-        tick_counter_ = 0U;
-      }
-      break;
-    case PcbStatusLedMode::kSwitchedOff:
-      break;
-    default:
-      break;
+Coroutine PcbStatusLed::Run(CoroutineExecutor& executor) {
+  // a mode change takes effect after the current phase
+  while (true) {
+    switch (mode_) {
+      case PcbStatusLedMode::kNormalMode:
+        board::StatusLed::Reset();
+        co_await executor.Sleep(kNormalTimeOff_);
+        if (mode_ == PcbStatusLedMode::kNormalMode) {
+          board::StatusLed::Set();
+          co_await executor.Sleep(kNormalTimeOn_);
+        }
+        break;
+      case PcbStatusLedMode::kErrorMode:
+        board::StatusLed::Toggle();
+        co_await executor.Sleep(kErrorTime_);
+        break;
+      case PcbStatusLedMode::kSwitchedOff:
+      default:
+        co_await executor.Sleep(kErrorTime_);
+        break;
+    }
   }
 }
 
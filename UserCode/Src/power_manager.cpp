@@ -0,0 +1,173 @@
+//! \brief     Class definition for switching the system clock at runtime.
+//! \details   Selects between the 80 MHz PLL turbo profile, the 48 MHz MSI
+//!            standard profile and a 4 MHz low-clock profile.
+//! \file      power_manager.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "power_manager.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+PowerManagerStatus PowerManager::SetProfile(const PerformanceProfile profile) {
+  PowerManagerStatus return_value = PowerManagerStatus::kSuccess;
+
+  if (profile != profile_) {
+    // the slower SPI divider of both profiles is applied during the switch
+    const uint32_t current_clock = HAL_RCC_GetHCLKFreq();
+    const uint32_t target_clock = GetProfileClock(profile);
+    const uint32_t switch_clock =
+        (target_clock > current_clock) ? target_clock : current_clock;
+    transmitter_.SetBaudRatePrescaler(GetSpiPrescaler(switch_clock));
+
+    return_value = ConfigureClocks(profile);
+    if (return_value == PowerManagerStatus::kSuccess) {
+      profile_ = profile;
+    }
+
+    // HAL_RCC_ClockConfig() has updated SystemCoreClock and the HAL tick
+    const uint32_t hclk = HAL_RCC_GetHCLKFreq();
+    transmitter_.SetBaudRatePrescaler(GetSpiPrescaler(HAL_RCC_GetPCLK2Freq()));
+    RetuneTimers(hclk);
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+PerformanceProfile PowerManager::GetProfile() const {
+  return profile_;
+}
+//------------------------------------------------------------------------------
+PowerManagerStatus PowerManager::ConfigureClocks(
+    const PerformanceProfile profile) {
+  PowerManagerStatus return_value = PowerManagerStatus::kSuccess;
+  RCC_OscInitTypeDef osc_init = {};
+  RCC_ClkInitTypeDef clk_init = {};
+
+  osc_init.OscillatorType = RCC_OSCILLATORTYPE_MSI;
+  osc_init.MSIState = RCC_MSI_ON;
+  osc_init.MSICalibrationValue = 0U;
+  osc_init.MSIClockRange = RCC_MSIRANGE_11;
+  osc_init.PLL.PLLState = RCC_PLL_NONE;
+
+  clk_init.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK |
+                       RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  clk_init.SYSCLKSource = RCC_SYSCLKSOURCE_MSI;
+  clk_init.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  clk_init.APB1CLKDivider = RCC_HCLK_DIV1;
+  clk_init.APB2CLKDivider = RCC_HCLK_DIV1;
+
+  // every profile passes through 48 MHz MSI at voltage scale 1 first, the
+  // RNG kernel clock is MSI and stays valid in all steps
+  if (HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1) != HAL_OK) {
+    return_value = PowerManagerStatus::kError;
+  }
+  else if (HAL_RCC_OscConfig(&osc_init) != HAL_OK) {
+    return_value = PowerManagerStatus::kError;
+  }
+  else if (HAL_RCC_ClockConfig(&clk_init, FLASH_LATENCY_2) != HAL_OK) {
+    return_value = PowerManagerStatus::kError;
+  }
+  else {
+    osc_init.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    osc_init.PLL.PLLState = RCC_PLL_OFF;
+    if (HAL_RCC_OscConfig(&osc_init) != HAL_OK) {
+      return_value = PowerManagerStatus::kError;
+    }
+  }
+
+  if (return_value == PowerManagerStatus::kSuccess) {
+    switch (profile) {
+      case PerformanceProfile::kTurbo:
+        // 48 MHz / 6 * 20 / 2 = 80 MHz
+        osc_init.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+        osc_init.PLL.PLLState = RCC_PLL_ON;
+        osc_init.PLL.PLLSource = RCC_PLLSOURCE_MSI;
+        osc_init.PLL.PLLM = 6U;
+        osc_init.PLL.PLLN = 20U;
+#if defined(RCC_PLLP_SUPPORT)
+        // PLLP feeds the SAI only, parts without SAI have no PLLP divider
+        osc_init.PLL.PLLP = RCC_PLLP_DIV7;
+#endif
+        osc_init.PLL.PLLQ = RCC_PLLQ_DIV2;
+        osc_init.PLL.PLLR = RCC_PLLR_DIV2;
+        clk_init.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+        if (HAL_RCC_OscConfig(&osc_init) != HAL_OK) {
+          return_value = PowerManagerStatus::kError;
+        }
+        else if (HAL_RCC_ClockConfig(&clk_init, FLASH_LATENCY_4) != HAL_OK) {
+          return_value = PowerManagerStatus::kError;
+        }
+        break;
+      case PerformanceProfile::kLowClock:
+        // HAL lowers the flash latency with the MSI range, range 2 of the
+        // regulator allows up to 26 MHz
+        osc_init.OscillatorType = RCC_OSCILLATORTYPE_MSI;
+        osc_init.MSIClockRange = RCC_MSIRANGE_6;
+        if (HAL_RCC_OscConfig(&osc_init) != HAL_OK) {
+          return_value = PowerManagerStatus::kError;
+        }
+        else if (HAL_PWREx_ControlVoltageScaling(
+                     PWR_REGULATOR_VOLTAGE_SCALE2) != HAL_OK) {
+          return_value = PowerManagerStatus::kError;
+        }
+        break;
+      case PerformanceProfile::kStandard:
+      default:
+        break;
+    }
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void PowerManager::RetuneTimers(const uint32_t hclk) {
+  // the new values are preloaded and take effect with the next update event,
+  // no update is forced in order to avoid a spurious tick
+  tick_timer_handle_->Init.Prescaler = (hclk / (kTickRate_ * kTickPeriod_)) - 1U;
+  tick_timer_handle_->Init.Period = kTickPeriod_ - 1U;
+  __HAL_TIM_SET_PRESCALER(tick_timer_handle_,
+                          tick_timer_handle_->Init.Prescaler);
+  __HAL_TIM_SET_AUTORELOAD(tick_timer_handle_, tick_timer_handle_->Init.Period);
+
+  sample_timer_handle_->Init.Prescaler = 0U;
+  sample_timer_handle_->Init.Period = (hclk / kSampleRate_) - 1U;
+  __HAL_TIM_SET_PRESCALER(sample_timer_handle_,
+                          sample_timer_handle_->Init.Prescaler);
+  __HAL_TIM_SET_AUTORELOAD(sample_timer_handle_,
+                           sample_timer_handle_->Init.Period);
+
+  track_timer_handle_->Init.Prescaler = (hclk / kTrackTimerClock_) - 1U;
+  __HAL_TIM_SET_PRESCALER(track_timer_handle_,
+                          track_timer_handle_->Init.Prescaler);
+}
+//------------------------------------------------------------------------------
+uint32_t PowerManager::GetProfileClock(const PerformanceProfile profile) const {
+  uint32_t return_value = 48000000U;
+
+  if (profile == PerformanceProfile::kTurbo) {
+    return_value = 80000000U;
+  }
+  else if (profile == PerformanceProfile::kLowClock) {
+    return_value = 4000000U;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t PowerManager::GetSpiPrescaler(const uint32_t pclk) const {
+  // BR = 0 divides by 2, every further step doubles the divider
+  uint32_t baud_rate = 0U;
+
+  while (((pclk >> (baud_rate + 1U)) > kMaxSpiClock_) && (baud_rate < 7U)) {
+    ++baud_rate;
+  }
+  return baud_rate << SPI_CR1_BR_Pos;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
@@ -15,29 +15,17 @@
 namespace tkrandom {
 
 // MEMBER FUNCTIONS ------------------------------------------------------------
-RngHandler::RngHandler(Generator& generator,
-                       Transmitter& transmitter)
-    : generator_(generator),
-      transmitter_(transmitter),
-      distribution_1_(Distribution::kUniform),
-      distribution_2_(Distribution::kUniform),
-      distribution_3_(Distribution::kUniform),
-      distribution_4_(Distribution::kUniform),
-      index_uniform_(0U),
-      index_normal_(0U) {
-
-}
-//------------------------------------------------------------------------------
 void RngHandler::Init() {
   transmitter_.Init();
   FillBuffers();
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 RngHandlerStatus RngHandler::SetOutputsLeds(const bool is_gate_1,
                                             const bool is_gate_2) {
   RngHandlerStatus return_value = RngHandlerStatus::kSuccess;
 
-  // sets all voltage outputs ahead of LEDs to reduce output latency
+  // voltage outputs only, the LEDs follow with the next refresh
   if (is_gate_1) {
     if (SetOutputs123() != TransmitterStatus::kSuccess) {
       return_value = RngHandlerStatus::kErrorTransfer;
@@ -48,23 +36,36 @@ RngHandlerStatus RngHandler::SetOutputsLeds(const bool is_gate_1,
       return_value = RngHandlerStatus::kErrorTransfer;
     }
   }
-  // rollback of random buffer indexes for LED values
-  RollbackBufferIndexes(is_gate_1, is_gate_2);
-  // sets brightness of LEDs
+  // fills random buffers with new random numbers
+  if (FillBuffers() != RngHandlerStatus::kSuccess) {
+    return_value = RngHandlerStatus::kErrorRng;
+  }
+  TKRANDOM_PROBE(kRefill);
+  // prepares the next values of chaotic sources like the buffers above
+  if (chaos_clock_ == ChaosClock::kGate) {
+    StepChaos(is_gate_1, is_gate_2);
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+RngHandlerStatus RngHandler::TrackOutputsLeds(const bool is_gate_1,
+                                              const bool is_gate_2) {
+  RngHandlerStatus return_value = RngHandlerStatus::kSuccess;
+
   if (is_gate_1) {
-    if (SetLeds123() != TransmitterStatus::kSuccess) {
-      return_value = RngHandlerStatus::kErrorTransfer;
-    }
+    QueueOutputsLeds(Output::kOutput1, Output::kOutput3);
   }
   if (is_gate_2) {
-    if (SetLed4() != TransmitterStatus::kSuccess) {
-      return_value = RngHandlerStatus::kErrorTransfer;
-    }
+    QueueOutputsLeds(Output::kOutput4, Output::kOutput4);
   }
-  // fills random buffers with new random numbers
   if (FillBuffers() != RngHandlerStatus::kSuccess) {
     return_value = RngHandlerStatus::kErrorRng;
   }
+  if (chaos_clock_ == ChaosClock::kGate) {
+    StepChaos(is_gate_1, is_gate_2);
+  }
 
   return return_value;
 }
@@ -90,48 +91,102 @@ void RngHandler::SetDistribution(const Output output,
 
 }
 //------------------------------------------------------------------------------
+void RngHandler::SetSource(const Output output, const Source source) {
+  const uint32_t index = static_cast<uint32_t>(output);
+  if (sources_[index] != source) {
+    switch (source) {
+      case Source::kLogistic:
+        chaos_[index].SetMap(ChaosMap::kLogistic);
+        break;
+      case Source::kLorenz:
+        chaos_[index].SetMap(ChaosMap::kLorenz);
+        break;
+      case Source::kHenon:
+        chaos_[index].SetMap(ChaosMap::kHenon);
+        break;
+      case Source::kRng:
+      default:
+        break;
+    }
+    sources_[index] = source;
+    if (source != Source::kRng) {
+      StepChaos(output);  // first value must not be the initial state
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void RngHandler::SetChaosClock(const ChaosClock clock) {
+  chaos_clock_ = clock;
+}
+//------------------------------------------------------------------------------
+void RngHandler::SetChaosPerturbation(const bool is_enabled) {
+  is_chaos_perturbed_ = is_enabled;
+}
+//------------------------------------------------------------------------------
+void RngHandler::RefreshLeds() {
+  led_refresher_.ProcessTick();
+}
+//------------------------------------------------------------------------------
+void RngHandler::SetLedDecay(const uint8_t shift) {
+  led_refresher_.SetDecay(shift);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 RngHandlerStatus RngHandler::FillBuffers() {
   RngHandlerStatus return_value = RngHandlerStatus::kSuccess;
-  uint16_t rng_number = 0U;
-
-  // fills random buffer with uniform distribution
-  while (index_uniform_ < kBufferSize_) {
-    const GeneratorStatus generator_status =
-        generator_.GetUniformRandomNumber(&rng_number);
-    if (generator_status == GeneratorStatus::kSuccess) {
-      buffer_uniform_[index_uniform_] = rng_number;
-    }
-    else {
+
+  // refills the consumed part of each buffer with one bulk call, indexes are
+  // set to full also in error case to prevent deadlock
+  if (index_uniform_ < kBufferSize_) {
+    if (generator_.Fill(&buffer_uniform_[index_uniform_],
+                        kBufferSize_ - index_uniform_,
+                        Distribution::kUniform) !=
+        GeneratorStatus::kSuccess) {
       return_value = RngHandlerStatus::kErrorRng;
     }
-    index_uniform_++;  // incremented also in error case to prevent deadlock
-  }
-  // fills random buffer with normal distribution
-  while (index_normal_ < kBufferSize_) {
-    const GeneratorStatus generator_status =
-        generator_.GetNormalRandomNumber(&rng_number);
-    if (generator_status == GeneratorStatus::kSuccess) {
-      buffer_normal_[index_normal_] = rng_number;
+    index_uniform_ = kBufferSize_;
+  }
+  if (index_normal_ < kBufferSize_) {
+    if (generator_.Fill(&buffer_normal_[index_normal_],
+                        kBufferSize_ - index_normal_,
+                        Distribution::kNormal) !=
+        GeneratorStatus::kSuccess) {
+      return_value = RngHandlerStatus::kErrorRng;
     }
-    else {
+    index_normal_ = kBufferSize_;
+  }
+  // draws are prefetched only while the probability is below full scale, so
+  // the outputs follow the same sequence as without a probability CV
+  if ((index_draw_ < kBufferSize_) &&
+      (cv_inputs_.GetParameter(CvParameter::kProbability) < kAlwaysDrawn_)) {
+    if (generator_.Fill(&buffer_draw_[index_draw_],
+                        kBufferSize_ - index_draw_,
+                        Distribution::kUniform) !=
+        GeneratorStatus::kSuccess) {
       return_value = RngHandlerStatus::kErrorRng;
     }
-      index_normal_++;  // incremented also in error case to prevent deadlock
+    index_draw_ = kBufferSize_;
   }
 
   return return_value;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 TransmitterStatus RngHandler::SetOutputs123(void) {
   TransmitterStatus return_value = TransmitterStatus::kSuccess;
   uint8_t output = static_cast<uint8_t>(Output::kOutput1);
 
   while (output <= static_cast<uint8_t>(Output::kOutput3)) {
-    const uint16_t random_number = GetRandomNumber(static_cast<Output>(output));
-    const TransmitterStatus transmitter_status =
-        transmitter_.SetVoltage(static_cast<Output>(output), random_number);
-    if (transmitter_status != TransmitterStatus::kSuccess) {
-      return_value = TransmitterStatus::kError;
+    if (IsValueDrawn()) {
+      const uint16_t random_number =
+          GetRandomNumber(static_cast<Output>(output));
+      const TransmitterStatus transmitter_status =
+          transmitter_.SetVoltage(static_cast<Output>(output), random_number);
+      if (transmitter_status != TransmitterStatus::kSuccess) {
+        return_value = TransmitterStatus::kError;
+      }
+      led_refresher_.SetBrightness(GetLed(static_cast<Output>(output)),
+                                   random_number);
     }
     output++;
   }
@@ -139,61 +194,42 @@ TransmitterStatus RngHandler::SetOutputs123(void) {
   return return_value;
 }
 //------------------------------------------------------------------------------
-TransmitterStatus RngHandler::SetLeds123(void) {
+TKRANDOM_RAM_CODE
+TransmitterStatus RngHandler::SetOutput4(void) {
   TransmitterStatus return_value = TransmitterStatus::kSuccess;
-  uint8_t output = static_cast<uint8_t>(Output::kOutput1);
-  uint8_t led = static_cast<uint8_t>(Led::kLed1);
 
-  while (output <= static_cast<uint8_t>(Output::kOutput3)) {
-    const uint16_t random_number = GetRandomNumber(static_cast<Output>(output));
-    const TransmitterStatus transmitter_status =
-        transmitter_.SetLedBrightness(static_cast<Led>(led), random_number);
-    if (transmitter_status != TransmitterStatus::kSuccess) {
-      return_value = TransmitterStatus::kError;
-    }
-    led++;
-    output++;
+  if (IsValueDrawn()) {
+    const uint16_t random_number = GetRandomNumber(Output::kOutput4);
+    return_value = transmitter_.SetVoltage(Output::kOutput4, random_number);
+    led_refresher_.SetBrightness(Led::kLed4, random_number);
   }
 
   return return_value;
 }
 //------------------------------------------------------------------------------
-TransmitterStatus RngHandler::SetOutput4(void) {
-  return transmitter_.SetVoltage(Output::kOutput4,
-                                 GetRandomNumber(Output::kOutput4));
-}
-//------------------------------------------------------------------------------
-TransmitterStatus RngHandler::SetLed4(void) {
-  return transmitter_.SetLedBrightness(Led::kLed4,
-                                       GetRandomNumber(Output::kOutput4));
-}
-//------------------------------------------------------------------------------
-void RngHandler::RollbackBufferIndexes(const bool is_gate_1,
-                                       const bool is_gate_2) {
-  if (is_gate_1) {
-    uint8_t output = static_cast<uint8_t>(Output::kOutput1);
-    while (output <= static_cast<uint8_t>(Output::kOutput3)) {
-      const Distribution distribution =
-          GetDistribution(static_cast<Output>(output));
-      if (distribution == Distribution::kNormal) {
-        index_normal_++;
-      }
-      else {
-        index_uniform_++;
-      }
-      output++;
-    }
-  }
-  if (is_gate_2) {
-    if (distribution_4_ == Distribution::kNormal) {
-      index_normal_++;
-    }
-    else {
-      index_uniform_++;
+TKRANDOM_RAM_CODE
+void RngHandler::QueueOutputsLeds(const Output first, const Output last) {
+  uint8_t output = static_cast<uint8_t>(first);
+
+  while (output <= static_cast<uint8_t>(last)) {
+    if (IsValueDrawn()) {
+      const uint16_t random_number =
+          GetRandomNumber(static_cast<Output>(output));
+      transmitter_.QueueVoltage(static_cast<Output>(output), random_number);
+      led_refresher_.SetBrightness(GetLed(static_cast<Output>(output)),
+                                   random_number);
     }
+    output++;
   }
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+Led RngHandler::GetLed(const Output output) {
+  return static_cast<Led>(static_cast<uint8_t>(Led::kLed1) +
+                          static_cast<uint8_t>(output));
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 Distribution RngHandler::GetDistribution(const Output output) const {
   Distribution return_value = Distribution::kUniform;
 
@@ -217,10 +253,49 @@ Distribution RngHandler::GetDistribution(const Output output) const {
   return return_value;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 uint16_t RngHandler::GetRandomNumber(const Output output) {
+  int32_t number = 0;
+  const uint32_t index = static_cast<uint32_t>(output);
+
+  if (sources_[index] != Source::kRng) {
+    number = chaos_[index].GetValue();
+  }
+  else {
+    const Distribution distribution = GetDistribution(output);
+    number = TakeNumber(distribution);
+    // the other buffer is only drawn from while morph is turned up, so one
+    // number of each buffer per output at most
+    const uint32_t morph = cv_inputs_.GetParameter(CvParameter::kMorph);
+    if (morph != CvInputs::kNeutralMorph) {
+      const int32_t other = TakeNumber((distribution == Distribution::kNormal)
+                                           ? Distribution::kUniform
+                                           : Distribution::kNormal);
+      number += ((other - number) * static_cast<int32_t>(morph >> 1U)) >> 15U;
+    }
+  }
+  // spread scales around the center of the range, mean moves the center,
+  // both neutral values leave the number unchanged
+  const int32_t spread =
+      static_cast<int32_t>(cv_inputs_.GetParameter(CvParameter::kSpread)) + 1;
+  const int32_t mean =
+      static_cast<int32_t>(cv_inputs_.GetParameter(CvParameter::kMean));
+  number = mean + (((number - 0x8000) * spread) >> 16U);
+  if (number < 0) {
+    number = 0;
+  }
+  if (number > 0xFFFF) {
+    number = 0xFFFF;
+  }
+
+  return static_cast<uint16_t>(number);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+uint16_t RngHandler::TakeNumber(const Distribution distribution) {
   uint16_t return_value = 0U;
 
-  if (GetDistribution(output) == Distribution::kNormal) {
+  if (distribution == Distribution::kNormal) {
     return_value = buffer_normal_[(index_normal_ - 1U)];
     index_normal_--;
   }
@@ -232,7 +307,52 @@ uint16_t RngHandler::GetRandomNumber(const Output output) {
   return return_value;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+bool RngHandler::IsValueDrawn() {
+  bool return_value = true;
+  const uint16_t probability =
+      cv_inputs_.GetParameter(CvParameter::kProbability);
+
+  // no RNG word is spent while every gate sets a new value
+  if ((probability < kAlwaysDrawn_) && (index_draw_ > 0U)) {
+    return_value = buffer_draw_[(index_draw_ - 1U)] < probability;
+    index_draw_--;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void RngHandler::StepChaos(const bool is_gate_1, const bool is_gate_2) {
+  if (is_gate_1) {
+    StepChaos(Output::kOutput1);
+    StepChaos(Output::kOutput2);
+    StepChaos(Output::kOutput3);
+  }
+  if (is_gate_2) {
+    StepChaos(Output::kOutput4);
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void RngHandler::StepChaos(const Output output) {
+  const uint32_t index = static_cast<uint32_t>(output);
+  if (sources_[index] != Source::kRng) {
+    int32_t perturbation = 0;
+    uint16_t rng_number = 0U;
+    if (is_chaos_perturbed_ &&
+        (generator_.GetUniformRandomNumber(&rng_number) ==
+         GeneratorStatus::kSuccess)) {
+      perturbation = static_cast<int16_t>(rng_number) >> kPerturbationShift_;
+    }
+    chaos_[index].Step(perturbation);
+  }
+}
+//------------------------------------------------------------------------------
 void RngHandler::ProcessTick() {
+  if (chaos_clock_ == ChaosClock::kInternal) {
+    StepChaos(true, true);
+  }
   generator_.ResetRng();
 }
 
@@ -0,0 +1,112 @@
+//! \brief     Class definition for the cooperative periodic task scheduler.
+//! \details   Runs registered tasks at their own rate and priority and keeps
+//!            cycle and deadline statistics per task.
+//! \file      scheduler.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "scheduler.hpp"
+#include "ram_code.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+SchedulerStatus Scheduler::AddTask(const TaskFunction function,
+                                   void* const context, const uint32_t rate,
+                                   const uint8_t priority,
+                                   const uint32_t budget,
+                                   uint32_t* const task_id) {
+  SchedulerStatus return_value = SchedulerStatus::kError;
+
+  if ((task_count_ < kMaxTasks_) && (function != nullptr) && (rate > 0U) &&
+      (rate <= kTickRate_)) {
+    Task& task = tasks_[task_count_];
+    task.function = function;
+    task.context = context;
+    task.rate = rate;
+    task.phase = 0U;
+    task.budget = budget;
+    task.priority = priority;
+    task.is_pending = false;
+    task.statistics = {};
+    if (task_id != nullptr) {
+      *task_id = task_count_;
+    }
+    __COMPILER_BARRIER();  // the task is complete before it is released
+    task_count_++;
+    CycleCounter::Enable();
+    return_value = SchedulerStatus::kSuccess;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Scheduler::ProcessTick() {
+  for (uint32_t index = 0U; index < task_count_; ++index) {
+    Task& task = tasks_[index];
+    task.phase += task.rate;
+    if (task.phase >= kTickRate_) {
+      task.phase -= kTickRate_;
+      if (task.is_pending) {
+        // the previous release has not run before this one
+        task.statistics.deadline_misses++;
+      }
+      task.is_pending = true;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+SchedulerStatus Scheduler::RunNext() {
+  SchedulerStatus return_value = SchedulerStatus::kIdle;
+  Task* next_task = nullptr;
+
+  for (uint32_t index = 0U; index < task_count_; ++index) {
+    Task& task = tasks_[index];
+    if (task.is_pending &&
+        ((next_task == nullptr) || (task.priority < next_task->priority))) {
+      next_task = &task;
+    }
+  }
+  if (next_task != nullptr) {
+    next_task->is_pending = false;
+    const uint32_t cycles_start = CycleCounter::Now();
+    next_task->function(next_task->context);
+    const uint32_t cycles = CycleCounter::Since(cycles_start);
+
+    TaskStatistics& statistics = next_task->statistics;
+    statistics.last_cycles = cycles;
+    if (cycles > statistics.max_cycles) {
+      statistics.max_cycles = cycles;
+    }
+    if (cycles > next_task->budget) {
+      statistics.budget_overruns++;
+    }
+    statistics.executions++;
+    return_value = SchedulerStatus::kSuccess;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+SchedulerStatus Scheduler::GetStatistics(
+    const uint32_t task_id, TaskStatistics* const statistics) const {
+  SchedulerStatus return_value = SchedulerStatus::kError;
+
+  if (task_id < task_count_) {
+    // deadline misses are counted by the timer interrupt
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *statistics = tasks_[task_id].statistics;
+    __set_PRIMASK(primask);
+    return_value = SchedulerStatus::kSuccess;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
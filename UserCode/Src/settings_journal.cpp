@@ -0,0 +1,298 @@
+//! \brief     Class definition for the wear-leveled flash settings journal.
+//! \details   Append-only key/value records in the last two flash pages.
+//! \file      settings_journal.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "settings_journal.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+volatile bool SettingsJournal::is_ecc_error_ = false;
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void SettingsJournal::Init() {
+  // the page with the highest valid generation is the active one
+  for (uint32_t page = 0U; page < kPageCount_; ++page) {
+    uint64_t header = kErased_;
+    if (ReadDoubleWord(GetPageAddress(page), &header)) {
+      const uint32_t magic = static_cast<uint32_t>(header);
+      const uint32_t generation = static_cast<uint32_t>(header >> 32U);
+      if ((magic == kPageMagic_) && (generation != 0xFFFFFFFFU) &&
+          ((active_page_ == kNoPage_) || (generation > generation_))) {
+        active_page_ = page;
+        generation_ = generation;
+      }
+    }
+  }
+  if (active_page_ != kNoPage_) {
+    ScanPage(active_page_);
+  }
+}
+//------------------------------------------------------------------------------
+SettingsJournalStatus SettingsJournal::Read(const SettingKey key,
+                                            uint16_t* const value) const {
+  SettingsJournalStatus return_value = SettingsJournalStatus::kNotFound;
+  const uint32_t index = static_cast<uint32_t>(key);
+
+  if (index >= kKeyCount_) {
+    return_value = SettingsJournalStatus::kError;
+  }
+  else if (is_valid_[index]) {
+    *value = values_[index];
+    return_value = SettingsJournalStatus::kSuccess;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+SettingsJournalStatus SettingsJournal::Write(const SettingKey key,
+                                             const uint16_t value) {
+  SettingsJournalStatus return_value = SettingsJournalStatus::kSuccess;
+  const uint32_t index = static_cast<uint32_t>(key);
+
+  if (index >= kKeyCount_) {
+    return_value = SettingsJournalStatus::kError;
+  }
+  else {
+    if ((!is_valid_[index]) || (values_[index] != value)) {
+      values_[index] = value;
+      is_valid_[index] = true;
+      is_dirty_[index] = true;
+    }
+    // a new setting starts another attempt after the retries ran out
+    error_count_ = 0U;
+    has_error_ = false;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+SettingsJournalStatus SettingsJournal::Process() {
+  SettingsJournalStatus return_value = SettingsJournalStatus::kSuccess;
+
+  if (has_error_) {
+    return_value = SettingsJournalStatus::kError;
+  }
+  else if (is_busy_) {
+    // the running operation is finished by the flash interrupt
+  }
+  else if (compaction_page_ != kNoPage_) {
+    ContinueCompaction();
+  }
+  else {
+    for (uint32_t key = 0U; key < kKeyCount_; ++key) {
+      if (!is_dirty_[key]) {
+        continue;
+      }
+      if ((active_page_ == kNoPage_) ||
+          ((write_offset_ + kRecordSize_) > FLASH_PAGE_SIZE)) {
+        // a full or missing page is replaced by a compacted one
+        compaction_page_ = (active_page_ == 0U) ? 1U : 0U;
+        compaction_offset_ = 0U;
+        compaction_key_ = 0U;
+        ContinueCompaction();
+      }
+      else {
+        program_key_ = key;
+        program_value_ = values_[key];
+        StartProgram(GetPageAddress(active_page_) + write_offset_,
+                     BuildRecord(key, program_value_), Operation::kAppend);
+      }
+      break;
+    }
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void SettingsJournal::ProcessOperationComplete() {
+  switch (operation_) {
+    case Operation::kAppend:
+      write_offset_ += kRecordSize_;
+      ClearDirty();
+      break;
+    case Operation::kErase:
+      compaction_offset_ = kRecordSize_;
+      break;
+    case Operation::kCopy:
+      compaction_offset_ += kRecordSize_;
+      ClearDirty();
+      break;
+    case Operation::kHeader:
+      active_page_ = compaction_page_;
+      write_offset_ = compaction_offset_;
+      ++generation_;
+      compaction_page_ = kNoPage_;
+      break;
+    case Operation::kNone:
+    default:
+      break;
+  }
+  HAL_FLASH_Lock();
+  error_count_ = 0U;
+  operation_ = Operation::kNone;
+  is_busy_ = false;
+}
+//------------------------------------------------------------------------------
+void SettingsJournal::ProcessOperationError() {
+  switch (operation_) {
+    case Operation::kAppend:
+      // the torn double word is skipped, the key stays dirty
+      write_offset_ += kRecordSize_;
+      break;
+    case Operation::kErase:
+    case Operation::kCopy:
+    case Operation::kHeader:
+      // the compaction restarts with the erase, the old page stays active
+      compaction_offset_ = 0U;
+      compaction_key_ = 0U;
+      break;
+    case Operation::kNone:
+    default:
+      break;
+  }
+  HAL_FLASH_Lock();
+  ++error_count_;
+  has_error_ = (error_count_ >= kMaxRetries_);
+  operation_ = Operation::kNone;
+  is_busy_ = false;
+}
+//------------------------------------------------------------------------------
+void SettingsJournal::ScanPage(const uint32_t page) {
+  const uint32_t page_address = GetPageAddress(page);
+
+  write_offset_ = FLASH_PAGE_SIZE;
+  for (uint32_t offset = kRecordSize_; offset < FLASH_PAGE_SIZE;
+       offset += kRecordSize_) {
+    uint64_t record = 0U;
+    const bool is_readable = ReadDoubleWord(page_address + offset, &record);
+    if (is_readable && (record == kErased_)) {
+      write_offset_ = offset;
+      break;
+    }
+    // torn records are skipped, their double word cannot be reprogrammed
+    const uint32_t word = static_cast<uint32_t>(record);
+    const uint32_t crc = static_cast<uint32_t>(record >> 32U);
+    const uint32_t key = (word >> 16U) & 0xFFU;
+    if (is_readable && ((word >> 24U) == kRecordTag_) &&
+        (crc == ComputeCrc(word)) && (key < kKeyCount_)) {
+      values_[key] = static_cast<uint16_t>(word);
+      is_valid_[key] = true;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void SettingsJournal::ContinueCompaction() {
+  // erase, records, header last: the old page stays active until the end
+  while ((compaction_key_ < kKeyCount_) && (!is_valid_[compaction_key_])) {
+    ++compaction_key_;
+  }
+  if (compaction_offset_ == 0U) {
+    FLASH_EraseInitTypeDef erase_init = {};
+    erase_init.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase_init.Banks = FLASH_BANK_1;
+    erase_init.Page = kFirstPage_ + compaction_page_;
+    erase_init.NbPages = 1U;
+    operation_ = Operation::kErase;
+    is_busy_ = true;
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    if (HAL_FLASHEx_Erase_IT(&erase_init) != HAL_OK) {
+      ProcessOperationError();
+    }
+  }
+  else if (compaction_key_ < kKeyCount_) {
+    program_key_ = compaction_key_;
+    program_value_ = values_[program_key_];
+    ++compaction_key_;
+    StartProgram(GetPageAddress(compaction_page_) + compaction_offset_,
+                 BuildRecord(program_key_, program_value_), Operation::kCopy);
+  }
+  else {
+    const uint64_t header =
+        (static_cast<uint64_t>(generation_ + 1U) << 32U) | kPageMagic_;
+    StartProgram(GetPageAddress(compaction_page_), header, Operation::kHeader);
+  }
+}
+//------------------------------------------------------------------------------
+void SettingsJournal::ClearDirty() {
+  // a value written during programming stays dirty
+  if (values_[program_key_] == program_value_) {
+    is_dirty_[program_key_] = false;
+  }
+}
+//------------------------------------------------------------------------------
+void SettingsJournal::StartProgram(const uint32_t address, const uint64_t data,
+                                   const Operation operation) {
+  operation_ = operation;
+  is_busy_ = true;
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+  if (HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD, address, data) !=
+      HAL_OK) {
+    ProcessOperationError();
+  }
+}
+//------------------------------------------------------------------------------
+bool SettingsJournal::ReadDoubleWord(const uint32_t address,
+                                     uint64_t* const data) const {
+  // a double ECC error raises an NMI that returns to this read, see
+  // HandleEccError(), the latched error is evaluated and cleared here
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ECCD);
+  is_ecc_error_ = false;
+  const volatile uint32_t* const words =
+      reinterpret_cast<const volatile uint32_t*>(address);
+  *data = (static_cast<uint64_t>(words[1]) << 32U) | words[0];
+  const bool return_value = (!is_ecc_error_) &&
+                            (__HAL_FLASH_GET_FLAG(FLASH_FLAG_ECCD) == 0U);
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ECCD);
+  is_ecc_error_ = false;
+  return return_value;
+}
+//------------------------------------------------------------------------------
+bool SettingsJournal::HandleEccError() {
+  // ADDR_ECC is the offset of the failing double word in the flash
+  const uint32_t address = FLASH_BASE + (FLASH->ECCR & FLASH_ECCR_ADDR_ECC);
+  const uint32_t first_address = FLASH_BASE + (kFirstPage_ * FLASH_PAGE_SIZE);
+  const bool return_value =
+      (__HAL_FLASH_GET_FLAG(FLASH_FLAG_ECCD) != 0U) &&
+      (address >= first_address) &&
+      (address < (first_address + (kPageCount_ * FLASH_PAGE_SIZE)));
+
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ECCD);
+  if (return_value) {
+    is_ecc_error_ = true;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t SettingsJournal::GetPageAddress(const uint32_t page) const {
+  return FLASH_BASE + ((kFirstPage_ + page) * FLASH_PAGE_SIZE);
+}
+//------------------------------------------------------------------------------
+uint64_t SettingsJournal::BuildRecord(const uint32_t key,
+                                      const uint16_t value) const {
+  const uint32_t word = (kRecordTag_ << 24U) | (key << 16U) | value;
+  return (static_cast<uint64_t>(ComputeCrc(word)) << 32U) | word;
+}
+//------------------------------------------------------------------------------
+uint16_t SettingsJournal::ComputeCrc(const uint32_t word) const {
+  uint16_t crc = 0xFFFFU;
+
+  for (uint32_t shift = 24U; shift < 32U; shift -= 8U) {
+    crc ^= static_cast<uint16_t>(((word >> shift) & 0xFFU) << 8U);
+    for (uint32_t bit = 0U; bit < 8U; ++bit) {
+      crc = ((crc & 0x8000U) != 0U)
+                ? static_cast<uint16_t>((crc << 1U) ^ 0x1021U)
+                : static_cast<uint16_t>(crc << 1U);
+    }
+  }
+  return crc;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
@@ -0,0 +1,229 @@
+//! \brief     Class definition for applying and changing the persistent
+//!            settings.
+//! \details   Applies the settings journal at startup and handles setting
+//!            commands of the host at runtime.
+//! \file      settings_manager.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "settings_manager.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void SettingsManager::ApplySeed() {
+  uint16_t value = 0U;
+
+  if (settings_journal_.Read(SettingKey::kRandomSeed, &value) ==
+      SettingsJournalStatus::kSuccess) {
+    generator_.SetSeed(value);
+  }
+}
+//------------------------------------------------------------------------------
+void SettingsManager::ApplySettings() {
+  // the seed has been applied before the generator was used
+  for (uint32_t key = 0U; key < static_cast<uint32_t>(SettingKey::kCount);
+       ++key) {
+    if (key != static_cast<uint32_t>(SettingKey::kRandomSeed)) {
+      ApplyStored(static_cast<SettingKey>(key));
+    }
+  }
+}
+//------------------------------------------------------------------------------
+SettingsManagerStatus SettingsManager::Apply(const SettingKey key,
+                                             const uint16_t value) {
+  SettingsManagerStatus return_value = SettingsManagerStatus::kSuccess;
+  const uint32_t index = static_cast<uint32_t>(key);
+
+  if ((index >= static_cast<uint32_t>(SettingKey::kCount)) ||
+      (!IsValid(index, value))) {
+    return_value = SettingsManagerStatus::kRejected;
+  }
+  else if (settings_journal_.Write(key, value) !=
+           SettingsJournalStatus::kSuccess) {
+    return_value = SettingsManagerStatus::kError;
+  }
+  else if (key != SettingKey::kRandomSeed) {
+    return_value = ApplyStored(key);
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void SettingsManager::PostCommand(const SettingKey key, const uint16_t value) {
+  command_.key = static_cast<uint16_t>(key);
+  command_.value = value;
+  command_.is_pending = true;
+}
+//------------------------------------------------------------------------------
+SettingsManagerStatus SettingsManager::Process() {
+  SettingsManagerStatus return_value = SettingsManagerStatus::kSuccess;
+
+  if (command_.is_pending) {
+    command_.status =
+        Apply(static_cast<SettingKey>(command_.key), command_.value);
+    command_.is_pending = false;
+  }
+  if (settings_journal_.Process() != SettingsJournalStatus::kSuccess) {
+    // the setting is applied but not stored, the host reads it from the
+    // mailbox
+    command_.status = SettingsManagerStatus::kError;
+    return_value = SettingsManagerStatus::kError;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+const SettingsCommand& SettingsManager::GetCommand() const {
+  return command_;
+}
+//------------------------------------------------------------------------------
+bool SettingsManager::IsValid(const uint32_t key, const uint16_t value) const {
+  bool return_value = true;
+  uint16_t profile = 0U;
+  uint16_t output = 0U;
+
+  // at 4 MHz TIM15 leaves about 83 cycles per noise sample, too few for the
+  // rendering, so the low-clock profile and the noise output exclude each other
+  settings_journal_.Read(SettingKey::kPerformanceProfile, &profile);
+  settings_journal_.Read(SettingKey::kNoiseOutput, &output);
+
+  switch (static_cast<SettingKey>(key)) {
+    case SettingKey::kHoldMode1:
+    case SettingKey::kHoldMode2:
+      return_value =
+          value <= static_cast<uint16_t>(HoldMode::kTrackAndHold);
+      break;
+    case SettingKey::kPerformanceProfile:
+      return_value =
+          (value < static_cast<uint16_t>(PerformanceProfile::kLowClock)) ||
+          ((value == static_cast<uint16_t>(PerformanceProfile::kLowClock)) &&
+           (output == 0U));
+      break;
+    case SettingKey::kLedDecay:
+      return_value = value <= 0xFFU;
+      break;
+    case SettingKey::kNoiseOutput:
+      return_value =
+          (value == 0U) ||
+          ((value <= (static_cast<uint16_t>(Output::kOutput4) + 1U)) &&
+           (profile != static_cast<uint16_t>(PerformanceProfile::kLowClock)));
+      break;
+    case SettingKey::kNoiseColor:
+      return_value = value <= static_cast<uint16_t>(NoiseColor::kBrown);
+      break;
+    case SettingKey::kChaosSources:  // every Source fits into its 2 bits
+      return_value = value <= 0xFFU;
+      break;
+    case SettingKey::kChaosClock:
+      return_value = value <= static_cast<uint16_t>(ChaosClock::kInternal);
+      break;
+    case SettingKey::kChaosPerturbation:
+      return_value = value <= 1U;
+      break;
+    case SettingKey::kTrackRate:   // limited by EventHandler::SetTrackRate()
+    case SettingKey::kRandomSeed:  // every value is a seed, 0 is the RNG
+    default:
+      break;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+SettingsManagerStatus SettingsManager::ApplyStored(const SettingKey key) {
+  SettingsManagerStatus return_value = SettingsManagerStatus::kSuccess;
+  uint16_t value = 0U;
+  const bool is_stored = (settings_journal_.Read(key, &value) ==
+                          SettingsJournalStatus::kSuccess) &&
+                         IsValid(static_cast<uint32_t>(key), value);
+
+  switch (key) {
+    case SettingKey::kHoldMode1:
+    case SettingKey::kHoldMode2: {
+      // both modes are set together, a missing one is sample-and-hold
+      uint16_t mode_1 = 0U;
+      uint16_t mode_2 = 0U;
+      settings_journal_.Read(SettingKey::kHoldMode1, &mode_1);
+      settings_journal_.Read(SettingKey::kHoldMode2, &mode_2);
+      event_handler_.SetHoldModes(
+          IsValid(static_cast<uint32_t>(SettingKey::kHoldMode1), mode_1)
+              ? static_cast<HoldMode>(mode_1)
+              : HoldMode::kSampleAndHold,
+          IsValid(static_cast<uint32_t>(SettingKey::kHoldMode2), mode_2)
+              ? static_cast<HoldMode>(mode_2)
+              : HoldMode::kSampleAndHold);
+      break;
+    }
+    case SettingKey::kTrackRate:
+      if (is_stored) {
+        event_handler_.SetTrackRate(value);
+      }
+      break;
+    case SettingKey::kPerformanceProfile:
+      if (is_stored &&
+          (power_manager_.SetProfile(static_cast<PerformanceProfile>(value)) !=
+           PowerManagerStatus::kSuccess)) {
+        return_value = SettingsManagerStatus::kError;
+      }
+      break;
+    case SettingKey::kLedDecay:
+      if (is_stored) {
+        rng_handler_.SetLedDecay(static_cast<uint8_t>(value));
+      }
+      break;
+    case SettingKey::kNoiseOutput:
+    case SettingKey::kNoiseColor: {
+      // both are applied together, a missing color is white noise
+      uint16_t output = 0U;
+      uint16_t color = 0U;
+      settings_journal_.Read(SettingKey::kNoiseOutput, &output);
+      settings_journal_.Read(SettingKey::kNoiseColor, &color);
+      if (!IsValid(static_cast<uint32_t>(SettingKey::kNoiseColor), color)) {
+        color = static_cast<uint16_t>(NoiseColor::kWhite);
+      }
+      if ((output != 0U) &&
+          IsValid(static_cast<uint32_t>(SettingKey::kNoiseOutput), output)) {
+        noise_handler_.Start(static_cast<Output>(output - 1U),
+                             static_cast<NoiseColor>(color));
+      }
+      else if (noise_handler_.IsStreaming()) {
+        noise_handler_.Stop();
+      }
+      break;
+    }
+    case SettingKey::kChaosSources:
+      if (is_stored) {
+        // the gate work iterates and reads the sources
+        const uint32_t basepri = InterruptTiers::MaskGateWork();
+        for (uint32_t output = 0U;
+             output <= static_cast<uint32_t>(Output::kOutput4); ++output) {
+          const uint32_t source =
+              (value >> (output * kSourceBits_)) & ((1U << kSourceBits_) - 1U);
+          rng_handler_.SetSource(static_cast<Output>(output),
+                                 static_cast<Source>(source));
+        }
+        InterruptTiers::UnmaskGateWork(basepri);
+      }
+      break;
+    case SettingKey::kChaosClock:
+      if (is_stored) {
+        rng_handler_.SetChaosClock(static_cast<ChaosClock>(value));
+      }
+      break;
+    case SettingKey::kChaosPerturbation:
+      if (is_stored) {
+        rng_handler_.SetChaosPerturbation(value != 0U);
+      }
+      break;
+    case SettingKey::kRandomSeed:
+    default:
+      break;
+  }
+  return return_value;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
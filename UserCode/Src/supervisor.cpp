@@ -0,0 +1,158 @@
+//! \brief     Class definition for the fault recovery supervisor.
+//! \details   Reinitializes failed peripherals, restores the outputs and feeds
+//!            the independent watchdog while the main loop is alive.
+//! \file      supervisor.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "supervisor.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void Supervisor::Init() {
+  // the IWDG halts with the core in the debugger
+  __HAL_DBGMCU_FREEZE_IWDG();
+  IWDG->KR = kKeyStart_;  // starts the LSI as well
+  IWDG->KR = kKeyAccess_;
+  IWDG->PR = kWatchdogPrescaler_;
+  IWDG->RLR = kWatchdogReload_;
+  const uint32_t tick_start = HAL_GetTick();
+  while ((IWDG->SR != 0U) && ((HAL_GetTick() - tick_start) < kLoopTimeout_)) {
+    // waits until the LSI domain has taken over prescaler and reload value
+  }
+  IWDG->KR = kKeyReload_;
+
+  // faults of the peripheral initialization count from now on
+  CycleCounter::Enable();
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (pending_faults_ != 0U) {
+    fault_timestamp_ = CycleCounter::Now();
+  }
+  is_started_ = true;
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Supervisor::ReportFault(const Fault fault) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (pending_faults_ == 0U) {
+    fault_timestamp_ = CycleCounter::Now();
+  }
+  pending_faults_ = pending_faults_ | (1U << static_cast<uint32_t>(fault));
+  statistics_.faults++;
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+bool Supervisor::IsStarted() const {
+  return is_started_;
+}
+//------------------------------------------------------------------------------
+SupervisorStatus Supervisor::Process() {
+  SupervisorStatus return_value = SupervisorStatus::kIdle;
+
+  loop_silence_ = 0U;
+
+  // after kMaxAttempts_ failures or a fatal fault the IWDG takes over
+  if ((pending_faults_ & kFatalMask_) != 0U) {
+    pcb_status_led_.SetLedMode(PcbStatusLedMode::kErrorMode);
+    return_value = SupervisorStatus::kError;
+  }
+  else if ((pending_faults_ != 0U) && (attempts_ < kMaxAttempts_)) {
+    // faults reported during the recovery stay pending for the next pass
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t faults = pending_faults_;
+    const uint32_t fault_timestamp = fault_timestamp_;
+    pending_faults_ = 0U;
+    __set_PRIMASK(primask);
+
+    return_value = Recover(faults);
+    if (return_value == SupervisorStatus::kSuccess) {
+      const uint32_t cycles = CycleCounter::Since(fault_timestamp);
+      attempts_ = 0U;
+      statistics_.recoveries++;
+      statistics_.last_cycles = cycles;
+      if (cycles > statistics_.max_cycles) {
+        statistics_.max_cycles = cycles;
+      }
+      const uint32_t microseconds = cycles / (HAL_RCC_GetHCLKFreq() / 1000000U);
+      TraceLog::Log(TraceEvent::kRecovery,
+                    (microseconds > 0xFFFFU) ? 0xFFFFU : microseconds);
+    }
+    else {
+      attempts_++;
+      statistics_.failures++;
+      TraceLog::Log(TraceEvent::kRecoveryFailed, faults);
+      __disable_irq();
+      if (pending_faults_ == 0U) {
+        fault_timestamp_ = fault_timestamp;
+      }
+      pending_faults_ = pending_faults_ | faults;
+      __set_PRIMASK(primask);
+      if (attempts_ >= kMaxAttempts_) {
+        pcb_status_led_.SetLedMode(PcbStatusLedMode::kErrorMode);
+      }
+    }
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Supervisor::ProcessTick() {
+  const uint32_t loop_silence = loop_silence_;
+
+  if (loop_silence < kLoopTimeout_) {
+    loop_silence_ = loop_silence + 1U;
+    if ((attempts_ < kMaxAttempts_) &&
+        ((pending_faults_ & kFatalMask_) == 0U)) {
+      IWDG->KR = kKeyReload_;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+RecoveryStatistics Supervisor::GetStatistics() const {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  const RecoveryStatistics statistics = statistics_;
+  __set_PRIMASK(primask);
+  return statistics;
+}
+//------------------------------------------------------------------------------
+SupervisorStatus Supervisor::Recover(const uint32_t faults) {
+  SupervisorStatus return_value = SupervisorStatus::kSuccess;
+  const uint32_t transfer_faults =
+      (1U << static_cast<uint32_t>(Fault::kTransfer)) |
+      (1U << static_cast<uint32_t>(Fault::kGeneral));
+  const uint32_t rng_faults = (1U << static_cast<uint32_t>(Fault::kRng)) |
+                              (1U << static_cast<uint32_t>(Fault::kGeneral));
+
+  if ((faults & transfer_faults) != 0U) {
+    if (transmitter_.Recover() != TransmitterStatus::kSuccess) {
+      return_value = SupervisorStatus::kError;
+    }
+  }
+  if ((faults & rng_faults) != 0U) {
+    // the RNG reset must not interleave with the gate work
+    const uint32_t basepri = InterruptTiers::MaskGateWork();
+    generator_.ResetRng();
+    InterruptTiers::UnmaskGateWork(basepri);
+    uint32_t word = 0U;
+    if (generator_.GetRandomWord(&word) != GeneratorStatus::kSuccess) {
+      return_value = SupervisorStatus::kError;
+    }
+  }
+
+  return return_value;
+}
+
+}  // namespace tkrandom
@@ -0,0 +1,63 @@
+//! \brief     Class definition for debouncing the distribution switches.
+//! \details   Samples the whole switch bank at 1 kHz with one port read and
+//!            runs an integrating debouncer per switch.
+//! \file      switch_debouncer.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "switch_debouncer.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void SwitchDebouncer::Init() {
+  const uint32_t switches = board::DistributionSwitches::Read();
+  for (uint32_t index = 0U; index < kSwitchCount_; ++index) {
+    integrators_[index] =
+        ((switches & (1U << index)) != 0U) ? kIntegratorLimit_ : 0U;
+  }
+  stable_state_ = switches;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+bool SwitchDebouncer::ProcessSample() {
+  // one port read for all switches, bit 0 is the switch of output 1
+  const uint32_t switches = board::DistributionSwitches::Read();
+  uint32_t state = stable_state_;
+
+  for (uint32_t index = 0U; index < kSwitchCount_; ++index) {
+    const uint32_t mask = 1U << index;
+    if ((switches & mask) != 0U) {
+      if (integrators_[index] < kIntegratorLimit_) {
+        ++integrators_[index];
+      }
+      if (integrators_[index] == kIntegratorLimit_) {
+        state |= mask;
+      }
+    }
+    else {
+      if (integrators_[index] > 0U) {
+        --integrators_[index];
+      }
+      if (integrators_[index] == 0U) {
+        state &= ~mask;
+      }
+    }
+  }
+  const bool return_value = (state != stable_state_);
+  stable_state_ = state;
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t SwitchDebouncer::GetState() const {
+  return stable_state_;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
@@ -0,0 +1,103 @@
+//! \brief     Class definition for the post-mortem trace ring in RAM2.
+//! \details   Binary event ring and fault record that survive a system reset.
+//! \file      trace_log.cpp
+//! \author    André Niederlein
+//! \date      2026-10-19
+//! \copyright GNU General Public License v3, see ../LICENSE
+//
+//  compliant to the Google C++ Style Guide:
+//  https://google.github.io/styleguide/cppguide.html
+
+// INCLUDES --------------------------------------------------------------------
+#include "trace_log.hpp"
+#include "settings_journal.hpp"
+
+// MICS ------------------------------------------------------------------------
+namespace tkrandom {
+
+__attribute__((section(".ram2_noinit"))) TraceLog::Buffer TraceLog::buffer_;
+
+// MEMBER FUNCTIONS ------------------------------------------------------------
+void TraceLog::Init() {
+  if (buffer_.magic != kMagic_) {
+    // power-up: SRAM2 content is random
+    buffer_ = {};
+    buffer_.magic = kMagic_;
+  }
+  else {
+    buffer_.reset_count++;
+  }
+  Log(TraceEvent::kReset, RCC->CSR >> 16U);
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+}
+//------------------------------------------------------------------------------
+void TraceLog::CaptureFault(const uint32_t* const frame, const uint32_t type) {
+  TraceFault& fault = buffer_.fault;
+
+  fault.type = type;
+  fault.timestamp = uwTick;
+  fault.r0 = frame[0];
+  fault.r1 = frame[1];
+  fault.r2 = frame[2];
+  fault.r3 = frame[3];
+  fault.r12 = frame[4];
+  fault.lr = frame[5];
+  fault.pc = frame[6];
+  fault.xpsr = frame[7];
+  fault.cfsr = SCB->CFSR;
+  fault.hfsr = SCB->HFSR;
+  fault.mmfar = SCB->MMFAR;
+  fault.bfar = SCB->BFAR;
+  Log(TraceEvent::kFault, type);
+  __DSB();
+  NVIC_SystemReset();
+}
+//------------------------------------------------------------------------------
+const TraceFault& TraceLog::GetFault() {
+  return buffer_.fault;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace tkrandom
+
+// FAULT HANDLERS --------------------------------------------------------------
+// replace the CubeMX handlers (code generation disabled in random.ioc), naked
+// so that the exception frame is found on the stack selected by EXC_RETURN,
+// not part of the host simulation build
+#if defined(__arm__)
+extern "C" {
+
+//! called by the naked handlers below
+//! \param[in] frame stacked exception frame
+//! \param[in] type 1 HardFault, 2 NMI
+void TraceFaultHandler(const uint32_t* const frame, const uint32_t type) {
+  // a double ECC error of a torn settings journal record is evaluated by
+  // SettingsJournal::ReadDoubleWord() after returning, any other NMI and an
+  // ECC error outside the journal pages are fatal
+  if ((type != 2U) || !tkrandom::SettingsJournal::HandleEccError()) {
+    tkrandom::TraceLog::CaptureFault(frame, type);
+  }
+}
+
+__attribute__((naked)) void HardFault_Handler(void) {
+  __asm volatile(
+      "tst lr, #4          \n"
+      "ite eq              \n"
+      "mrseq r0, msp       \n"
+      "mrsne r0, psp       \n"
+      "movs r1, #1         \n"
+      "b TraceFaultHandler \n");
+}
+
+__attribute__((naked)) void NMI_Handler(void) {
+  __asm volatile(
+      "tst lr, #4          \n"
+      "ite eq              \n"
+      "mrseq r0, msp       \n"
+      "mrsne r0, psp       \n"
+      "movs r1, #2         \n"
+      "b TraceFaultHandler \n");
+}
+
+}  // extern "C"
+#endif
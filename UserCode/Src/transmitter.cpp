@@ -15,72 +15,320 @@
 namespace tkrandom {
 
 // MEMBER FUNCTIONS ------------------------------------------------------------
-Transmitter::Transmitter(SPI_HandleTypeDef* const spi_handle,
-                         GPIO_TypeDef* const gpio_port_nss,
-                         const uint16_t pin_nss,
-                         GPIO_TypeDef* const gpio_port_dac,
-                         const uint16_t pin_dac)
-    : spi_handle_(spi_handle),
-      kTimeout_(1000U),
-      kWriteCommand_(0x30U),
-      gpio_port_nss_(gpio_port_nss),
-      gpio_port_dac_(gpio_port_dac),
-      kPinNss_(pin_nss),
-      kPinDac_(pin_dac),
-      kLedOffValue_(27500U) {
-  HAL_GPIO_WritePin(gpio_port_nss_, kPinNss_, GPIO_PIN_SET);  // SPI NSS line
-}
-//------------------------------------------------------------------------------
 void Transmitter::Init() {
-  HAL_GPIO_WritePin(gpio_port_dac_,
-                    kPinDac_,
-                    GPIO_PIN_RESET);
+  board::DacNss::Set();  // SPI NSS line
+  board::DacReset::Reset();
   for (volatile uint8_t i = 0U; i < 50U; ++i) {
     // just waits a short moment
   }
   // gets DAC out of reset
-  HAL_GPIO_WritePin(gpio_port_dac_,
-                    kPinDac_,
-                    GPIO_PIN_SET);
+  board::DacReset::Set();
+  CycleCounter::Enable();  // for GetFrameCycles()
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 TransmitterStatus Transmitter::SetVoltage(const Output output,
-                                          const uint16_t value) const {
+                                          const uint16_t value) {
   const uint8_t address = static_cast<uint8_t>(output);
-  return TransmitValue(address, value);
+  TransmitterStatus return_value = TransmitterStatus::kSuccess;
+
+  // streamed outputs are exclusively written by StreamVoltage()
+  if (!IsStreamedOutput(output)) {
+    return_value = TransmitValue(address, value);
+  }
+
+  return return_value;
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 TransmitterStatus Transmitter::SetLedBrightness(const Led led,
-                                                const uint16_t value) const {
+                                                const uint16_t value) {
   const uint8_t address = static_cast<uint8_t>(led);
-  // considers that a minimum voltage is required to let an LED illuminate
-  const double value_ratio =
-      static_cast<double>(value) / static_cast<double>(0xffffU);
-  const uint16_t range = 0xffffU - kLedOffValue_;
-  const double range_part = value_ratio * static_cast<double>(range);
-  const uint16_t new_value = static_cast<uint16_t>(range_part) + kLedOffValue_;
+  return TransmitValue(address, ScaleLedValue(value));
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+TransmitterStatus Transmitter::QueueVoltage(const Output output,
+                                            const uint16_t value) {
+  TransmitterStatus return_value = TransmitterStatus::kSuccess;
+
+  if (!IsStreamedOutput(output)) {
+    return_value = QueueValue(static_cast<uint8_t>(output), value);
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+TransmitterStatus Transmitter::QueueLedBrightness(const Led led,
+                                                  const uint16_t value) {
+  return QueueValue(static_cast<uint8_t>(led), ScaleLedValue(value));
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+TransmitterStatus Transmitter::StreamVoltage(const Output output,
+                                             const uint16_t value) {
+  return QueueValue(static_cast<uint8_t>(output), value);
+}
+//------------------------------------------------------------------------------
+void Transmitter::SetStreamedOutput(const Output output,
+                                    const bool is_streamed) {
+  const uint8_t mask = static_cast<uint8_t>(1U << static_cast<uint8_t>(output));
+  if (is_streamed) {
+    streamed_outputs_ = streamed_outputs_ | mask;
+  }
+  else {
+    streamed_outputs_ = streamed_outputs_ & static_cast<uint8_t>(~mask);
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Transmitter::ProcessTransferComplete() {
+  board::DacNss::Set();
+  is_dma_busy_ = false;
+  if ((!is_bus_locked_) && (queue_head_ != queue_tail_)) {
+    StartNextFrame();
+  }
+}
+//------------------------------------------------------------------------------
+void Transmitter::ProcessTransferError() {
+  // the failed frame is lost, the queue continues with the next one
+  TraceLog::Log(TraceEvent::kSpiError, spi_handle_->ErrorCode);
+  ProcessTransferComplete();
+}
+//------------------------------------------------------------------------------
+TransmitterStatus Transmitter::Recover() {
+  TransmitterStatus return_value = TransmitterStatus::kError;
 
-  return TransmitValue(address, new_value);
+  // holds back the queue, a stuck DMA frame is aborted instead of awaited
+  const uint32_t basepri = InterruptTiers::MaskGateWork();
+  is_bus_locked_ = true;
+  HAL_SPI_Abort(spi_handle_);
+  is_dma_busy_ = false;
+  board::DacNss::Set();
+  // the MSP callbacks configure the pins and the DMA channel again
+  HAL_SPI_DeInit(spi_handle_);
+  if (HAL_SPI_Init(spi_handle_) == HAL_OK) {
+    Init();  // the DAC reset clears all channels
+    return_value = TransmitterStatus::kSuccess;
+    uint8_t frame[kFrameSize_];
+    for (uint8_t address = 0U; address < kChannelCount_; ++address) {
+      BuildFrame(address, shadow_[address], frame);
+      if (SendFrame(frame) != TransmitterStatus::kSuccess) {
+        return_value = TransmitterStatus::kError;
+      }
+    }
+  }
+  ReleaseBus();
+  InterruptTiers::UnmaskGateWork(basepri);
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+uint32_t Transmitter::GetFrameCycles() const {
+  return frame_cycles_;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+uint16_t Transmitter::ScaleLedValue(const uint16_t value) const {
+  // considers that a minimum voltage is required to let an LED illuminate,
+  // integer scaling since LEDs are also updated at track rate
+  const uint32_t range = 0xffffU - kLedOffValue_;
+  const uint32_t range_part = (static_cast<uint32_t>(value) * range) / 0xffffU;
+  return static_cast<uint16_t>(range_part + kLedOffValue_);
 }
 //------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+bool Transmitter::IsStreamedOutput(const Output output) const {
+  const uint8_t mask = static_cast<uint8_t>(1U << static_cast<uint8_t>(output));
+  return (streamed_outputs_ & mask) != 0U;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
 TransmitterStatus Transmitter::TransmitValue(const uint8_t address,
-                                             const uint16_t value) const {
+                                             const uint16_t value) {
   TransmitterStatus return_value = TransmitterStatus::kError;
 
-  const uint8_t first_byte = kWriteCommand_ + address;
-  const uint8_t second_byte = static_cast<uint8_t>(value >> 8U);
-  const uint8_t third_byte = static_cast<uint8_t>(value);
-  uint8_t data[3U] = {first_byte, second_byte, third_byte};
-  HAL_GPIO_WritePin(gpio_port_nss_, kPinNss_, GPIO_PIN_RESET);
+  // frame-atomic against the gate work, no-op if called from the gate work
+  const uint32_t basepri = InterruptTiers::MaskGateWork();
+  LockBus();
+  const uint32_t cycles_start = CycleCounter::Now();
+  uint8_t data[kFrameSize_];
+  BuildFrame(address, value, data);
+  shadow_[address] = value;
+  const TransmitterStatus frame_status = SendFrame(data);
+  frame_cycles_ = CycleCounter::Since(cycles_start);
+  ReleaseBus();
+  InterruptTiers::UnmaskGateWork(basepri);
+  TKRANDOM_PROBE(kFrame);
+
+  if (frame_status == TransmitterStatus::kSuccess) {
+    return_value = TransmitterStatus::kSuccess;
+  }
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+void Transmitter::SetBaudRatePrescaler(const uint32_t prescaler) {
+  const uint32_t basepri = InterruptTiers::MaskGateWork();
+  LockBus();
+  // the baud rate must only be changed while the SPI is disabled
+  __HAL_SPI_DISABLE(spi_handle_);
+  MODIFY_REG(spi_handle_->Instance->CR1, SPI_CR1_BR, prescaler);
+  spi_handle_->Init.BaudRatePrescaler = prescaler;
+  ReleaseBus();
+  InterruptTiers::UnmaskGateWork(basepri);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Transmitter::LockBus() {
+  // holds back queued frames and waits for the one currently sent by DMA
+  is_bus_locked_ = true;
+  const uint32_t tick_start = HAL_GetTick();
+  while (is_dma_busy_) {
+    if ((HAL_GetTick() - tick_start) > kTimeout_) {
+      break;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Transmitter::ReleaseBus() {
+  // releases the bus and resumes frames queued in the meantime
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  is_bus_locked_ = false;
+  if ((!is_dma_busy_) && (queue_head_ != queue_tail_)) {
+    StartNextFrame();
+  }
+  __set_PRIMASK(primask);
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+TransmitterStatus Transmitter::SendFrame(uint8_t* const frame) {
+#if defined(TKRANDOM_SPI_HAL)
+  // former general-purpose path, kept as reference for GetFrameCycles()
+  board::DacNss::Reset();
   const HAL_StatusTypeDef hal_status =
-      HAL_SPI_Transmit(spi_handle_, data, 3U, kTimeout_);
-  HAL_GPIO_WritePin(gpio_port_nss_, kPinNss_, GPIO_PIN_SET);
+      HAL_SPI_Transmit(spi_handle_, frame, kFrameSize_, kTimeout_);
+  board::DacNss::Set();
+  TransmitterStatus return_value = TransmitterStatus::kError;
+  if (hal_status == HAL_OK) {
+    return_value = TransmitterStatus::kSuccess;
+  }
+#else
+  TransmitterStatus return_value = WriteFrame(frame);
+  if (return_value != TransmitterStatus::kSuccess) {
+    TraceLog::Log(TraceEvent::kSpiError, 0xFFFFU);
+    return_value = RecoverFrame(frame);
+  }
+#endif
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+TransmitterStatus Transmitter::WriteFrame(const uint8_t* const frame) {
+  TransmitterStatus return_value = TransmitterStatus::kSuccess;
+  SPI_TypeDef* const spi = spi_handle_->Instance;
+  uint32_t polls = 0U;
+
+  // the HAL driver enables the SPI with its first transfer
+  if ((spi->CR1 & SPI_CR1_SPE) == 0U) {
+    spi->CR1 |= SPI_CR1_SPE;
+  }
+  // DMA frames leave their received bytes, reading DR and SR clears overrun
+  while ((spi->SR & SPI_SR_FRLVL) != 0U) {
+    static_cast<void>(ReadRegister<uint8_t>(spi->DR));
+  }
+  static_cast<void>(spi->SR);
+  board::DacNss::Reset();
+  // the 4-byte TX FIFO takes the whole frame, lower byte is sent first
+  WriteRegister<uint16_t>(spi->DR,
+                          static_cast<uint16_t>(frame[0U] | (frame[1U] << 8U)));
+  WriteRegister<uint8_t>(spi->DR, frame[2U]);
+  while (((spi->SR & (SPI_SR_FTLVL | SPI_SR_BSY)) != 0U) &&
+         (polls < kPollLimit_)) {
+    polls++;
+  }
+  board::DacNss::Set();
+  // discards the bytes received in 2-line mode to keep the RX FIFO empty
+  while ((spi->SR & SPI_SR_FRLVL) != 0U) {
+    static_cast<void>(ReadRegister<uint8_t>(spi->DR));
+  }
+  if ((polls >= kPollLimit_) || ((spi->SR & SPI_SR_OVR) != 0U)) {
+    return_value = TransmitterStatus::kError;
+  }
 
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TransmitterStatus Transmitter::RecoverFrame(const uint8_t* const frame) {
+  TransmitterStatus return_value = TransmitterStatus::kError;
+
+  // aborting flushes both FIFOs and clears the overrun flag
+  HAL_SPI_Abort(spi_handle_);
+  board::DacNss::Reset();
+  const HAL_StatusTypeDef hal_status = HAL_SPI_Transmit(
+      spi_handle_, const_cast<uint8_t*>(frame), kFrameSize_, kTimeout_);
+  board::DacNss::Set();
   if (hal_status == HAL_OK) {
     return_value = TransmitterStatus::kSuccess;
   }
 
   return return_value;
 }
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+TransmitterStatus Transmitter::QueueValue(const uint8_t address,
+                                          const uint16_t value) {
+  TransmitterStatus return_value = TransmitterStatus::kSuccess;
+
+  // callers may run in thread mode as well as in interrupt context
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  shadow_[address] = value;  // a dropped frame is restored by Recover()
+  if ((queue_head_ - queue_tail_) < kQueueSize_) {
+    BuildFrame(address, value, queue_[queue_head_ & (kQueueSize_ - 1U)]);
+    queue_head_ = queue_head_ + 1U;
+    if ((!is_dma_busy_) && (!is_bus_locked_)) {
+      StartNextFrame();
+    }
+  }
+  else {
+    dropped_frames_ = dropped_frames_ + 1U;
+    return_value = TransmitterStatus::kError;
+  }
+  __set_PRIMASK(primask);
+
+  return return_value;
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Transmitter::StartNextFrame() {
+  const uint8_t* const frame = queue_[queue_tail_ & (kQueueSize_ - 1U)];
+  for (uint16_t i = 0U; i < kFrameSize_; ++i) {
+    dma_frame_[i] = frame[i];
+  }
+  queue_tail_ = queue_tail_ + 1U;
+
+  is_dma_busy_ = true;
+  board::DacNss::Reset();
+  const HAL_StatusTypeDef hal_status =
+      HAL_SPI_Transmit_DMA(spi_handle_, dma_frame_, kFrameSize_);
+  if (hal_status != HAL_OK) {
+    board::DacNss::Set();
+    is_dma_busy_ = false;
+    dropped_frames_ = dropped_frames_ + 1U;
+  }
+}
+//------------------------------------------------------------------------------
+TKRANDOM_RAM_CODE
+void Transmitter::BuildFrame(const uint8_t address, const uint16_t value,
+                             uint8_t* const frame) const {
+  frame[0U] = kWriteCommand_ + address;
+  frame[1U] = static_cast<uint8_t>(value >> 8U);
+  frame[2U] = static_cast<uint8_t>(value);
+}
 
 }  // namespace tkrandom